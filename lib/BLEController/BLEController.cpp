@@ -19,6 +19,7 @@
 
 #include "BLEController.h"
 #include "Logger.h"
+#include "LatencyTracer.h"
 
 bool BLEController::isBleEnabled()
 {
@@ -483,218 +484,256 @@ void BLEController::BLExecutor(String action, bool pressed)
   if (!Keyboard.isConnected())
     return;
 
+  HidProgram program;
+  compileAction(action, program);
+  execute(program, pressed);
+}
+
+bool BLEController::compileAction(const String &action, HidProgram &outProgram)
+{
+  outProgram.valid = false;
+  outProgram.ops.clear();
+  outProgram.text.clear();
+
   // Process only commands that start with "S_B:"
-  if (action.startsWith("S_B:"))
+  if (!action.startsWith("S_B:"))
+  {
+    return false;
+  }
+  outProgram.valid = true;
+
+  HidProgram::Op op = {};
+
+  // Remove the prefix "S_B:"
+  String cmd = action.substring(4);
+  cmd.trim(); // Trim any whitespace
+
+  // Handle special cases for literal + and , characters
+  if (cmd.equals("++") || cmd.equals(",,"))
   {
-    // Remove the prefix "S_B:"
-    String cmd = action.substring(4);
-    cmd.trim(); // Trim any whitespace
+    op.opcode = HidProgram::OP_KEY;
+    op.code = cmd[0];
+    outProgram.ops.push_back(op);
+    return true;
+  }
+
+  // Split the command into groups separated by commas
+  std::vector<String> groups;
+  unsigned int startIndex = 0;
+  bool inEscape = false;
 
-    // Handle special cases for literal + and , characters
-    if (cmd.equals("++"))
+  for (unsigned int i = 0; i < cmd.length(); i++)
+  {
+    if (cmd[i] == ',' && !inEscape)
     {
-      if (pressed)
-        Keyboard.press('+');
-      else
-        Keyboard.release('+');
-      return;
+      if (i > startIndex)
+      {
+        groups.push_back(cmd.substring(startIndex, i));
+      }
+      startIndex = i + 1;
     }
-    else if (cmd.equals(",,"))
+    else if (cmd[i] == '+' && i + 1 < cmd.length() && cmd[i + 1] == '+')
     {
-      if (pressed)
-        Keyboard.press(',');
-      else
-        Keyboard.release(',');
-      return;
+      inEscape = !inEscape;
+      i++; // Skip the next +
     }
+  }
 
-    // Split the command into groups separated by commas
-    // Better approach: use a dedicated parsing function
-    String groups[10]; // Assuming max 10 groups
-    int groupCount = 0;
-    int startIndex = 0;
-    bool inEscape = false;
+  // Add the last group
+  if (startIndex < cmd.length())
+  {
+    groups.push_back(cmd.substring(startIndex));
+  }
+
+  // Process each group
+  for (const String &group : groups)
+  {
+    // Split tokens by +
+    std::vector<String> tokens;
+    startIndex = 0;
+    inEscape = false;
 
-    for (int i = 0; i < cmd.length(); i++)
+    for (unsigned int i = 0; i < group.length(); i++)
     {
-      if (cmd[i] == ',' && !inEscape)
+      if (group[i] == '+' && !inEscape)
       {
         if (i > startIndex)
         {
-          groups[groupCount++] = cmd.substring(startIndex, i);
+          tokens.push_back(group.substring(startIndex, i));
         }
         startIndex = i + 1;
       }
-      else if (cmd[i] == '+' && i + 1 < cmd.length() && cmd[i + 1] == '+')
+      else if (group[i] == '+' && i + 1 < group.length() && group[i + 1] == '+')
       {
         inEscape = !inEscape;
         i++; // Skip the next +
       }
     }
 
-    // Add the last group
-    if (startIndex < cmd.length())
+    // Add the last token
+    if (startIndex < group.length())
     {
-      groups[groupCount++] = cmd.substring(startIndex);
+      tokens.push_back(group.substring(startIndex));
     }
 
-    // Process each group
-    for (int g = 0; g < groupCount; g++)
+    // Compile tokens
+    for (String token : tokens)
     {
-      String group = groups[g];
+      token.trim();
 
-      // Split tokens by +
-      String tokens[10]; // Assuming max 10 tokens per group
-      int tokenCount = 0;
-      startIndex = 0;
-      inEscape = false;
+      // Replace escaped characters
+      token.replace("++", "+");
+      token.replace(",,", ",");
 
-      for (int i = 0; i < group.length(); i++)
+      op = HidProgram::Op();
+      if (isMouseMoveToken(token))
       {
-        if (group[i] == '+' && !inEscape)
-        {
-          if (i > startIndex)
-          {
-            tokens[tokenCount++] = group.substring(startIndex, i);
-          }
-          startIndex = i + 1;
-        }
-        else if (group[i] == '+' && i + 1 < group.length() && group[i + 1] == '+')
+        String command = token.substring(11); // Remove "MOUSE_MOVE_"
+        int x = 0, y = 0, wheel = 0, hWheel = 0;
+        int count = sscanf(command.c_str(), "%d_%d_%d_%d", &x, &y, &wheel, &hWheel);
+
+        if (count != 4)
         {
-          inEscape = !inEscape;
-          i++; // Skip the next +
+          Logger::getInstance().log("Invalid MOUSE_MOVE command: " + token);
+          continue;
         }
+        op.opcode = HidProgram::OP_MOUSE_MOVE;
+        op.move[0] = (signed char)x;
+        op.move[1] = (signed char)y;
+        op.move[2] = (signed char)wheel;
+        op.move[3] = (signed char)hWheel;
       }
-
-      // Add the last token
-      if (startIndex < group.length())
+      else if (isMouseKeyToken(token))
       {
-        tokens[tokenCount++] = group.substring(startIndex);
+        op.opcode = HidProgram::OP_MOUSE_BUTTON;
+        op.code = getMouseKeyToken(token);
+        if (op.code == 0)
+          continue;
       }
-
-      // Process tokens
-      for (int t = 0; t < tokenCount; t++)
+      else if (isMediaKeyToken(token))
       {
-        String token = tokens[t];
-        token.trim();
-
-        // Replace escaped characters
-        token.replace("++", "+");
-        token.replace(",,", ",");
-
-        // Process the token
-        if (isMouseMoveToken(token))
-        {
-          // Handle mouse move
-          String command = token.substring(11); // Remove "MOUSE_MOVE_"
-          int x = 0, y = 0, wheel = 0, hWheel = 0;
-          int count = sscanf(command.c_str(), "%d_%d_%d_%d", &x, &y, &wheel, &hWheel);
-
-          if (count == 4)
-          {
-            moveMouse((signed char)x, (signed char)y, (signed char)wheel, (signed char)hWheel);
-            Logger::getInstance().log("Mouse moved: " + String(x) + "," + String(y));
-          }
-          else
-          {
-            Logger::getInstance().log("Invalid MOUSE_MOVE command: " + token);
-          }
-        }
-        else if (isMouseKeyToken(token))
-
-        {
-          // Handle mouse button
-          uint8_t mouseButton = getMouseKeyToken(token);
-          if (mouseButton != 0)
-          {
-            if (pressed)
-            {
-              Mouse.press(mouseButton);
-              mouseButtonsPressed |= mouseButton;
-            }
-            else
-            {
-              Mouse.release(mouseButton);
-              mouseButtonsPressed &= ~mouseButton;
-            }
-            lastMouseButtonChangeTime = millis();
-            Logger::getInstance().log("Mouse button: " + token + (pressed ? " pressed" : " released"));
-          }
-        }
-        else if (isMediaKeyToken(token))
-        {
-          // Handle media key
-          const uint8_t *mediaKey = getMediaKeyToken(token);
-          if (mediaKey != nullptr)
-          {
-            if (pressed)
-              Keyboard.press(mediaKey);
-            // Keyboard.write(mediaKey);
-            else
-              Keyboard.release(mediaKey);
-            Logger::getInstance().log("Media key: " + token + (pressed ? " pressed" : " released"));
-          }
-        }
-        else if (isSpecialKeyToken(token))
-        {
-          // Handle special key
-          uint8_t keyCode = mapSpecialKey(token);
-          if (keyCode != 0)
-          {
-            if (pressed)
-              Keyboard.press(keyCode);
-            else
-              Keyboard.release(keyCode);
-            Logger::getInstance().log("Special key: " + token + (pressed ? " pressed" : " released"));
-          }
-        }
-        else if (token.length() == 1)
-        {
-          // Handle single character - improve mapping for non-ASCII chars
-          char c = token.charAt(0);
-          if (pressed)
-          {
-            // Map character to HID code
-            Keyboard.press(c);
-            Logger::getInstance().log("Character pressed: " + String(c));
-          }
-          else
-          {
-            Keyboard.release(c);
-            Logger::getInstance().log("Character released: " + String(c));
-          }
-        }
-        else if (token.length() > 1)
-        {
-          if (pressed)
-          {
-            // Handle text string - use a better approach
-            Logger::getInstance().log("Printing string: " + token);
-            // Use the print method which handles the mapping internally
-            Keyboard.print(String(token));
-            // No need for character-by-character with delays
-          }
-          else
-          {
-
-            // chissa che vada davverp......
-            Keyboard.releaseAll();
-          }
-          /// il problema dovrebbe essere nei press multpili ,
-          // quando ce un carattere CASE blecombo usa in contemporanea lo SHIFT ma,
-          // quando si preme due tasti con lo shift insieme succedono guai
-          // soluzione controlla e gestisci lo shift internamente assegnando ad ogni carattere un valore CAPS true o false
-          // convertendo la stringa in minuscolo per poi premere e rilasciare nel modo corretto SHIFT
-          /// altri forse
-          // TIenI CONTO DEL LAYOUT E FAI DELLE PROVE CON QUELLO ITA
-          // impostare anche una variabile per scegliere il layout?????? indagare se blecombo supporta i layout ....
-        }
+        op.opcode = HidProgram::OP_MEDIA_KEY;
+        op.mediaKey = getMediaKeyToken(token);
+        if (op.mediaKey == nullptr)
+          continue;
+      }
+      else if (isSpecialKeyToken(token))
+      {
+        op.opcode = HidProgram::OP_KEY;
+        op.code = mapSpecialKey(token);
+        if (op.code == 0)
+          continue;
+      }
+      else if (token.length() == 1)
+      {
+        op.opcode = HidProgram::OP_KEY;
+        op.code = token.charAt(0);
+      }
+      else if (token.length() > 1)
+      {
+        /// il problema dovrebbe essere nei press multpili ,
+        // quando ce un carattere CASE blecombo usa in contemporanea lo SHIFT ma,
+        // quando si preme due tasti con lo shift insieme succedono guai
+        // soluzione controlla e gestisci lo shift internamente assegnando ad ogni carattere un valore CAPS true o false
+        // convertendo la stringa in minuscolo per poi premere e rilasciare nel modo corretto SHIFT
+        /// altri forse
+        // TIenI CONTO DEL LAYOUT E FAI DELLE PROVE CON QUELLO ITA
+        // impostare anche una variabile per scegliere il layout?????? indagare se blecombo supporta i layout ....
+        op.opcode = HidProgram::OP_TEXT;
+        op.textOffset = outProgram.text.size();
+        op.textLength = token.length();
+        outProgram.text.insert(outProgram.text.end(), token.c_str(), token.c_str() + token.length() + 1);
+      }
+      else
+      {
+        continue;
       }
+      outProgram.ops.push_back(op);
     }
   }
-  else
+
+  return true;
+}
+
+std::shared_ptr<const HidProgram> BLEController::getProgram(const std::string &action)
+{
+  auto it = programCache.find(action);
+  if (it != programCache.end())
+  {
+    return it->second;
+  }
+
+  std::shared_ptr<HidProgram> program(new HidProgram());
+  compileAction(String(action.c_str()), *program);
+  programCache[action] = program;
+  return program;
+}
+
+void BLEController::clearPrograms()
+{
+  programCache.clear();
+}
+
+void BLEController::execute(const HidProgram &program, bool pressed)
+{
+  if (!Keyboard.isConnected())
+    return;
+
+  if (!program.valid)
   {
     Logger::getInstance().log("No valid command found to send BLE");
     return;
   }
+
+  if (pressed)
+    LatencyTracer::getInstance().mark(LatencyTracer::STAGE_BLE);
+
+  for (const HidProgram::Op &op : program.ops)
+  {
+    switch (op.opcode)
+    {
+    case HidProgram::OP_KEY:
+      if (pressed)
+        Keyboard.press(op.code);
+      else
+        Keyboard.release(op.code);
+      break;
+
+    case HidProgram::OP_MEDIA_KEY:
+      if (pressed)
+        Keyboard.press(op.mediaKey);
+      else
+        Keyboard.release(op.mediaKey);
+      break;
+
+    case HidProgram::OP_MOUSE_BUTTON:
+      if (pressed)
+      {
+        Mouse.press(op.code);
+        mouseButtonsPressed |= op.code;
+      }
+      else
+      {
+        Mouse.release(op.code);
+        mouseButtonsPressed &= ~op.code;
+      }
+      lastMouseButtonChangeTime = millis();
+      break;
+
+    case HidProgram::OP_MOUSE_MOVE:
+      // Come in origine il movimento avviene sia su press che su release
+      moveMouse(op.move[0], op.move[1], op.move[2], op.move[3]);
+      break;
+
+    case HidProgram::OP_TEXT:
+      if (pressed)
+        Keyboard.write(reinterpret_cast<const uint8_t *>(program.textAt(op)), op.textLength);
+      else
+        Keyboard.releaseAll();
+      break;
+    }
+  }
+
+  if (pressed)
+    LatencyTracer::getInstance().end();
 }
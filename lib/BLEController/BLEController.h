@@ -28,6 +28,10 @@
 #include <BleComboKeyboard.h>
 #include <BleComboMouse.h>
 #include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include "HidProgram.h"
 
 class BLEController
 {
@@ -45,6 +49,9 @@ private:
     uint8_t mouseButtonsPressed;
     unsigned long lastMouseButtonChangeTime;
 
+    // Programmi HID compilati per le azioni del combo set corrente
+    std::map<std::string, std::shared_ptr<const HidProgram>> programCache;
+
     // Funzione privata per stampare il MAC in formato leggibile.
     void printMacAddress(const uint8_t *mac);
 
@@ -78,6 +85,14 @@ public:
     // Modifica il nome del device in base all'incremento.
     void incrementName(int increment);
     void BLExecutor(String action, bool pressed);
+
+    // Compila un'azione "S_B:" in una lista di operazioni HID (parsing una sola volta).
+    static bool compileAction(const String &action, HidProgram &outProgram);
+    // Restituisce il programma in cache per l'azione, compilandolo se necessario.
+    std::shared_ptr<const HidProgram> getProgram(const std::string &action);
+    void clearPrograms();
+    // Esegue un programma compilato senza parsing di stringhe.
+    void execute(const HidProgram &program, bool pressed);
     void moveMouse(signed char x, signed char y, signed char wheel, signed char hWheel);
 
     // Mouse button state queries
@@ -0,0 +1,42 @@
+#ifndef HID_PROGRAM_H
+#define HID_PROGRAM_H
+
+#include <Arduino.h>
+#include <vector>
+
+/**
+ * @brief Pre-tokenized form of an "S_B:" action.
+ *
+ * BLEController::compileAction parses the action string once into a flat
+ * list of HID operations; BLEController::execute then walks the list on
+ * press and release without any string handling.
+ */
+struct HidProgram
+{
+    enum Opcode : uint8_t
+    {
+        OP_KEY,          // Keyboard key (special key or single character)
+        OP_MEDIA_KEY,    // Consumer/media key
+        OP_MOUSE_BUTTON, // Mouse button held while pressed
+        OP_MOUSE_MOVE,   // Relative move (x, y, wheel, hWheel)
+        OP_TEXT          // Typed string, releaseAll() on release
+    };
+
+    struct Op
+    {
+        Opcode opcode;
+        uint8_t code;          // OP_KEY / OP_MOUSE_BUTTON
+        int8_t move[4];        // OP_MOUSE_MOVE
+        uint16_t textOffset;   // OP_TEXT: offset into text
+        uint16_t textLength;   // OP_TEXT: length of the string
+        const uint8_t *mediaKey; // OP_MEDIA_KEY
+    };
+
+    bool valid = false; // false when the action is not an "S_B:" command
+    std::vector<Op> ops;
+    std::vector<char> text; // Null-terminated strings referenced by OP_TEXT
+
+    const char *textAt(const Op &op) const { return &text[op.textOffset]; }
+};
+
+#endif // HID_PROGRAM_H
@@ -2,16 +2,17 @@
 #include "BLEController.h"
 
 BleCommand::BleCommand(BLEController* bleController, const std::string& action)
-    : _bleController(bleController), _action(action) {}
+    : _bleController(bleController),
+      _program(bleController ? bleController->getProgram(action) : nullptr) {}
 
 void BleCommand::press() {
-    if (_bleController && _bleController->isBleEnabled()) {
-        _bleController->BLExecutor(_action.c_str(), true);
+    if (_bleController && _program && _bleController->isBleEnabled()) {
+        _bleController->execute(*_program, true);
     }
 }
 
 void BleCommand::release() {
-    if (_bleController && _bleController->isBleEnabled()) {
-        _bleController->BLExecutor(_action.c_str(), false);
+    if (_bleController && _program && _bleController->isBleEnabled()) {
+        _bleController->execute(*_program, false);
     }
 }
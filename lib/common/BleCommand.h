@@ -2,9 +2,11 @@
 #define BLE_COMMAND_H
 
 #include "Command.h"
+#include <memory>
 #include <string>
 
 class BLEController;
+struct HidProgram;
 
 class BleCommand : public Command {
 public:
@@ -14,7 +16,7 @@ public:
 
 private:
     BLEController* _bleController;
-    std::string _action;
+    std::shared_ptr<const HidProgram> _program; // Compiled once per combo set
 };
 
 #endif // BLE_COMMAND_H
@@ -1,10 +1,13 @@
 #include "CommandFactory.h"
 #include "Logger.h"
+#include <string.h>
 
 #include "ResetCommand.h"
 #include "HopBleDeviceCommand.h"
 #include "CalibrateSensorCommand.h"
 #include "MemInfoCommand.h"
+#include "LatencyInfoCommand.h"
+#include "WakeInfoCommand.h"
 #include "EnterSleepCommand.h"
 #include "IrCheckCommand.h"
 #include "GyroMouseStartCommand.h"
@@ -12,17 +15,19 @@
 #include "GyroMouseToggleCommand.h"
 #include "GyroMouseCycleSensitivityCommand.h"
 #include "GyroMouseRecenterCommand.h"
-#include "DelayCommand.h"
 #include "FlashlightCommand.h"
 #include "ApModeCommand.h"
 #include "BleCommand.h"
 #include "ExecuteGestureCommand.h"
+#include "GestureTemplateCommand.h"
+#include "GestureDatasetCommand.h"
 #include "ScanIrDevCommand.h"
 #include "SendIrCommand.h"
 #include "LedCommand.h"
 #include "LedBrightnessCommand.h"
 #include "ToggleBleWifiCommand.h"
 #include "ToggleKeyOrderCommand.h"
+#include "InputTraceCommand.h"
 #include "ToggleReactiveLightingCommand.h"
 #include "SaveInteractiveColorsCommand.h"
 #include "SwitchComboCommand.h"
@@ -36,6 +41,7 @@
 #include "WIFIManager.h"
 #include "combinationManager.h"
 #include "macroManager.h"
+#include "SimpleGestureDetector.h" // Gesture ID ranges
 
 CommandFactory::CommandFactory(
     SpecialAction* specialAction,
@@ -57,128 +63,204 @@ void CommandFactory::setMacroManager(MacroManager* macroManager) {
     _macroManager = macroManager;
 }
 
-std::unique_ptr<Command> CommandFactory::create(const std::string& actionString) {
-    if (actionString == "RESET_ALL") {
-        Logger::getInstance().log("CommandFactory: Creating ResetCommand");
-        return std::unique_ptr<ResetCommand>(new ResetCommand(_specialAction));
-    }
-    if (actionString == "HOP_BLE_DEVICE") {
-        Logger::getInstance().log("CommandFactory: Creating HopBleDeviceCommand");
-        return std::unique_ptr<HopBleDeviceCommand>(new HopBleDeviceCommand(_specialAction));
-    }
-    if (actionString == "CALIBRATE_SENSOR") {
-        Logger::getInstance().log("CommandFactory: Creating CalibrateSensorCommand");
-        return std::unique_ptr<CalibrateSensorCommand>(new CalibrateSensorCommand(_specialAction));
-    }
-    if (actionString == "MEM_INFO") {
-        Logger::getInstance().log("CommandFactory: Creating MemInfoCommand");
-        return std::unique_ptr<MemInfoCommand>(new MemInfoCommand(_specialAction));
-    }
-    if (actionString == "ENTER_SLEEP") {
-        Logger::getInstance().log("CommandFactory: Creating EnterSleepCommand");
-        return std::unique_ptr<EnterSleepCommand>(new EnterSleepCommand(_specialAction));
-    }
-    if (actionString == "IR_CHECK") {
-        Logger::getInstance().log("CommandFactory: Creating IrCheckCommand");
-        return std::unique_ptr<IrCheckCommand>(new IrCheckCommand(_specialAction));
-    }
-    if (actionString == "GYROMOUSE_START") {
-        Logger::getInstance().log("CommandFactory: Creating GyroMouseStartCommand");
-        return std::unique_ptr<GyroMouseStartCommand>(new GyroMouseStartCommand(_gyroMouse, _macroManager));
-    }
-    if (actionString == "GYROMOUSE_STOP") {
-        Logger::getInstance().log("CommandFactory: Creating GyroMouseStopCommand");
-        return std::unique_ptr<GyroMouseStopCommand>(new GyroMouseStopCommand(_gyroMouse, _macroManager));
-    }
-    if (actionString == "GYROMOUSE_TOGGLE") {
-        Logger::getInstance().log("CommandFactory: Creating GyroMouseToggleCommand");
-        return std::unique_ptr<GyroMouseToggleCommand>(new GyroMouseToggleCommand(_gyroMouse, _macroManager));
-    }
-    if (actionString == "GYROMOUSE_CYCLE_SENSITIVITY") {
-        Logger::getInstance().log("CommandFactory: Creating GyroMouseCycleSensitivityCommand");
-        return std::unique_ptr<GyroMouseCycleSensitivityCommand>(new GyroMouseCycleSensitivityCommand(_gyroMouse));
-    }
-    if (actionString == "GYROMOUSE_RECENTER") {
-        Logger::getInstance().log("CommandFactory: Creating GyroMouseRecenterCommand");
-        return std::unique_ptr<GyroMouseRecenterCommand>(new GyroMouseRecenterCommand(_gyroMouse));
-    }
-    if (actionString.rfind("DELAY_", 0) == 0) {
-        std::string delayStr = actionString.substr(6);
-        try {
-            int totalDelayMs = std::stoi(delayStr);
-            Logger::getInstance().log("CommandFactory: Creating DelayCommand with delay " + String(totalDelayMs));
-            return std::unique_ptr<DelayCommand>(new DelayCommand(_specialAction, totalDelayMs));
-        } catch (const std::exception& e) {
-            Logger::getInstance().log("CommandFactory: Error parsing DELAY_ command: " + String(e.what()));
-            return nullptr;
+CommandFactory::Builder CommandFactory::findBuilder(const std::string& actionString) {
+    // Exact-match actions, kept sorted by key for binary search
+    static const DispatchEntry exactTable[] = {
+        {"AP_MODE", [](CommandFactory& f, const std::string&) -> Command* {
+            return new ApModeCommand(f._wifiManager, f._bleController, f._macroManager->getWifiConfig());
+        }},
+        {"CALIBRATE_SENSOR", [](CommandFactory& f, const std::string&) -> Command* {
+            return new CalibrateSensorCommand(f._specialAction);
+        }},
+        {"ENTER_SLEEP", [](CommandFactory& f, const std::string&) -> Command* {
+            return new EnterSleepCommand(f._specialAction);
+        }},
+        {"EXECUTE_GESTURE", [](CommandFactory& f, const std::string&) -> Command* {
+            return new ExecuteGestureCommand(f._inputHub, f._macroManager);
+        }},
+        {"FLASHLIGHT", [](CommandFactory& f, const std::string&) -> Command* {
+            return new FlashlightCommand(f._specialAction);
+        }},
+        {"GESTURE_DATASET_CLEAR", [](CommandFactory& f, const std::string&) -> Command* {
+            return new GestureDatasetCommand(f._inputHub, f._macroManager, GestureDatasetCommand::Mode::CLEAR);
+        }},
+        {"GESTURE_TEMPLATES_CLEAR", [](CommandFactory& f, const std::string&) -> Command* {
+            return new GestureTemplateCommand(f._inputHub, f._macroManager, GestureTemplateCommand::Mode::CLEAR);
+        }},
+        {"GYROMOUSE_CYCLE_SENSITIVITY", [](CommandFactory& f, const std::string&) -> Command* {
+            return new GyroMouseCycleSensitivityCommand(f._gyroMouse);
+        }},
+        {"GYROMOUSE_RECENTER", [](CommandFactory& f, const std::string&) -> Command* {
+            return new GyroMouseRecenterCommand(f._gyroMouse);
+        }},
+        {"GYROMOUSE_START", [](CommandFactory& f, const std::string&) -> Command* {
+            return new GyroMouseStartCommand(f._gyroMouse, f._macroManager);
+        }},
+        {"GYROMOUSE_STOP", [](CommandFactory& f, const std::string&) -> Command* {
+            return new GyroMouseStopCommand(f._gyroMouse, f._macroManager);
+        }},
+        {"GYROMOUSE_TOGGLE", [](CommandFactory& f, const std::string&) -> Command* {
+            return new GyroMouseToggleCommand(f._gyroMouse, f._macroManager);
+        }},
+        {"HOP_BLE_DEVICE", [](CommandFactory& f, const std::string&) -> Command* {
+            return new HopBleDeviceCommand(f._specialAction);
+        }},
+        {"IR_CHECK", [](CommandFactory& f, const std::string&) -> Command* {
+            return new IrCheckCommand(f._specialAction);
+        }},
+        {"LATENCY_INFO", [](CommandFactory&, const std::string&) -> Command* {
+            return new LatencyInfoCommand();
+        }},
+        {"LED_INFO", [](CommandFactory& f, const std::string& action) -> Command* {
+            return new LedCommand(f._specialAction, action);
+        }},
+        {"LED_OFF", [](CommandFactory& f, const std::string& action) -> Command* {
+            return new LedCommand(f._specialAction, action);
+        }},
+        {"LED_RESTORE", [](CommandFactory& f, const std::string& action) -> Command* {
+            return new LedCommand(f._specialAction, action);
+        }},
+        {"LED_SAVE", [](CommandFactory& f, const std::string& action) -> Command* {
+            return new LedCommand(f._specialAction, action);
+        }},
+        {"MEM_INFO", [](CommandFactory& f, const std::string&) -> Command* {
+            return new MemInfoCommand(f._specialAction);
+        }},
+        {"REACTIVE_LIGHTING", [](CommandFactory& f, const std::string&) -> Command* {
+            return new ToggleReactiveLightingCommand(f._inputHub);
+        }},
+        {"RESET_ALL", [](CommandFactory& f, const std::string&) -> Command* {
+            return new ResetCommand(f._specialAction);
+        }},
+        {"SAVE_INTERACTIVE_COLORS", [](CommandFactory& f, const std::string&) -> Command* {
+            return new SaveInteractiveColorsCommand(f._inputHub);
+        }},
+        {"TOGGLE_BLE_WIFI", [](CommandFactory& f, const std::string&) -> Command* {
+            return new ToggleBleWifiCommand(f._specialAction);
+        }},
+        {"TOGGLE_KEY_ORDER", [](CommandFactory& f, const std::string&) -> Command* {
+            return new ToggleKeyOrderCommand(f._macroManager);
+        }},
+        {"TRACE_RECORD", [](CommandFactory&, const std::string&) -> Command* {
+            return new InputTraceCommand(InputTraceCommand::Mode::RECORD);
+        }},
+        {"TRACE_REPLAY", [](CommandFactory&, const std::string&) -> Command* {
+            return new InputTraceCommand(InputTraceCommand::Mode::REPLAY);
+        }},
+        {"WAKE_INFO", [](CommandFactory&, const std::string&) -> Command* {
+            return new WakeInfoCommand();
+        }},
+    };
+
+    // Prefix actions; no prefix is a prefix of another one, so order does not matter
+    static const DispatchEntry prefixTable[] = {
+        {"S_B:", [](CommandFactory& f, const std::string& action) -> Command* {
+            return new BleCommand(f._bleController, action);
+        }},
+        {"SWITCH_MY_COMBO_", [](CommandFactory& f, const std::string& action) -> Command* {
+            return new SwitchComboCommand(f._macroManager, action);
+        }},
+        {"SWITCH_COMBO_", [](CommandFactory& f, const std::string& action) -> Command* {
+            return new SwitchComboCommand(f._macroManager, action);
+        }},
+        {"LED_BRIGHTNESS_", [](CommandFactory& f, const std::string& action) -> Command* {
+            return new LedBrightnessCommand(f._specialAction, action);
+        }},
+        {"LED_RGB_", [](CommandFactory& f, const std::string& action) -> Command* {
+            return new LedCommand(f._specialAction, action);
+        }},
+        {"SEND_IR_", [](CommandFactory& f, const std::string& action) -> Command* {
+            return new SendIrCommand(f._specialAction, f._macroManager, action);
+        }},
+        {"SCAN_IR_DEV_", [](CommandFactory& f, const std::string& action) -> Command* {
+            std::string devStr = action.substr(12); // After "SCAN_IR_DEV_"
+            try {
+                int deviceId = std::stoi(devStr);
+                return new ScanIrDevCommand(f._specialAction, f._macroManager, deviceId);
+            } catch (const std::exception& e) {
+                Logger::getInstance().log("CommandFactory: Error parsing SCAN_IR_DEV_ command: " + String(e.what()));
+                return nullptr;
+            }
+        }},
+        {"GESTURE_RECORD_", [](CommandFactory& f, const std::string& action) -> Command* {
+            std::string label = action.substr(15); // After "GESTURE_RECORD_"
+            if (label.empty()) {
+                Logger::getInstance().log("CommandFactory: GESTURE_RECORD_ needs a label");
+                return nullptr;
+            }
+            return new GestureDatasetCommand(f._inputHub, f._macroManager,
+                                             GestureDatasetCommand::Mode::RECORD, String(label.c_str()));
+        }},
+        {"GESTURE_TRAIN_", [](CommandFactory& f, const std::string& action) -> Command* {
+            std::string idStr = action.substr(14); // After "GESTURE_TRAIN_"
+            try {
+                int gestureId = std::stoi(idStr);
+                if (gestureId < GESTURE_ID_TEMPLATE_MIN || gestureId > GESTURE_ID_TEMPLATE_MAX) {
+                    Logger::getInstance().log("CommandFactory: GESTURE_TRAIN_ id out of range: " + String(gestureId));
+                    return nullptr;
+                }
+                return new GestureTemplateCommand(f._inputHub, f._macroManager,
+                                                  GestureTemplateCommand::Mode::TRAIN, gestureId);
+            } catch (const std::exception& e) {
+                Logger::getInstance().log("CommandFactory: Error parsing GESTURE_TRAIN_ command: " + String(e.what()));
+                return nullptr;
+            }
+        }},
+    };
+
+    const size_t exactCount = sizeof(exactTable) / sizeof(exactTable[0]);
+
+    const char* action = actionString.c_str();
+
+    size_t low = 0;
+    size_t high = exactCount;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        int cmp = strcmp(action, exactTable[mid].key);
+        if (cmp == 0) {
+            return exactTable[mid].build;
+        }
+        if (cmp < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
         }
     }
-    if (actionString == "FLASHLIGHT") {
-        Logger::getInstance().log("CommandFactory: Creating FlashlightCommand");
-        return std::unique_ptr<FlashlightCommand>(new FlashlightCommand(_specialAction));
-    }
-    if (actionString == "AP_MODE") {
-        Logger::getInstance().log("CommandFactory: Creating ApModeCommand");
-        return std::unique_ptr<ApModeCommand>(new ApModeCommand(_wifiManager, _bleController, _macroManager->getWifiConfig()));
-    }
-    if (actionString == "TOGGLE_BLE_WIFI") {
-        Logger::getInstance().log("CommandFactory: Creating ToggleBleWifiCommand");
-        return std::unique_ptr<ToggleBleWifiCommand>(new ToggleBleWifiCommand(_specialAction));
-    }
-    if (actionString == "TOGGLE_KEY_ORDER") {
-        Logger::getInstance().log("CommandFactory: Creating ToggleKeyOrderCommand");
-        return std::unique_ptr<ToggleKeyOrderCommand>(new ToggleKeyOrderCommand(_macroManager));
-    }
-    if (actionString == "REACTIVE_LIGHTING") {
-        Logger::getInstance().log("CommandFactory: Creating ToggleReactiveLightingCommand");
-        return std::unique_ptr<ToggleReactiveLightingCommand>(new ToggleReactiveLightingCommand(_inputHub));
-    }
-    if (actionString == "SAVE_INTERACTIVE_COLORS") {
-        Logger::getInstance().log("CommandFactory: Creating SaveInteractiveColorsCommand");
-        return std::unique_ptr<SaveInteractiveColorsCommand>(new SaveInteractiveColorsCommand(_inputHub));
-    }
-    if (actionString.rfind("SWITCH_MY_COMBO_", 0) == 0 || actionString.rfind("SWITCH_COMBO_", 0) == 0) {
-        Logger::getInstance().log("CommandFactory: Creating SwitchComboCommand for " + String(actionString.c_str()));
-        return std::unique_ptr<SwitchComboCommand>(new SwitchComboCommand(_macroManager, actionString));
-    }
-    if (actionString.rfind("S_B:", 0) == 0) {
-        Logger::getInstance().log("CommandFactory: Creating BleCommand for " + String(actionString.c_str()));
-        return std::unique_ptr<BleCommand>(new BleCommand(_bleController, actionString));
-    }
-    if (actionString.rfind("LED_BRIGHTNESS_", 0) == 0) {
-        Logger::getInstance().log("CommandFactory: Creating LedBrightnessCommand for " + String(actionString.c_str()));
-        return std::unique_ptr<LedBrightnessCommand>(new LedBrightnessCommand(_specialAction, actionString));
-    }
-    if (actionString.rfind("LED_RGB_", 0) == 0 ||
-        actionString == "LED_OFF" ||
-        actionString == "LED_SAVE" ||
-        actionString == "LED_RESTORE" ||
-        actionString == "LED_INFO") {
-        Logger::getInstance().log("CommandFactory: Creating LedCommand for " + String(actionString.c_str()));
-        return std::unique_ptr<LedCommand>(new LedCommand(_specialAction, actionString));
-    }
-    if (actionString.rfind("SEND_IR_", 0) == 0) {
-        Logger::getInstance().log("CommandFactory: Creating SendIrCommand for " + String(actionString.c_str()));
-        return std::unique_ptr<SendIrCommand>(new SendIrCommand(_specialAction, _macroManager, actionString));
-    }
-    if (actionString.rfind("SCAN_IR_DEV_", 0) == 0) {
-        std::string devStr = actionString.substr(12); // After "SCAN_IR_DEV_"
-        try {
-            int deviceId = std::stoi(devStr);
-            Logger::getInstance().log("CommandFactory: Creating ScanIrDevCommand for device ID " + String(deviceId));
-            return std::unique_ptr<ScanIrDevCommand>(new ScanIrDevCommand(_specialAction, _macroManager, deviceId));
-        } catch (const std::exception& e) {
-            Logger::getInstance().log("CommandFactory: Error parsing SCAN_IR_DEV_ command: " + String(e.what()));
-            return nullptr;
+
+    for (const DispatchEntry& entry : prefixTable) {
+        if (strncmp(action, entry.key, strlen(entry.key)) == 0) {
+            return entry.build;
         }
     }
-    if (actionString == "EXECUTE_GESTURE") {
-        Logger::getInstance().log("CommandFactory: Creating ExecuteGestureCommand");
-        return std::unique_ptr<ExecuteGestureCommand>(new ExecuteGestureCommand(_inputHub, _macroManager));
+
+    return nullptr;
+}
+
+std::unique_ptr<Command> CommandFactory::create(const std::string& actionString) {
+    Builder build = findBuilder(actionString);
+    if (build) {
+        return std::unique_ptr<Command>(build(*this, actionString));
     }
-    
+
     // If no command matches, return nullptr.
     // The caller will be responsible for handling this case.
     Logger::getInstance().log("CommandFactory: No command matched for action: " + String(actionString.c_str()));
     return nullptr;
 }
+
+Command* CommandFactory::acquire(const std::string& actionString) {
+    auto it = _pool.find(actionString);
+    if (it != _pool.end()) {
+        return it->second.get();
+    }
+
+    // First use of this action: build it once and keep it (nullptr included,
+    // so unknown actions are not dispatched again on every press)
+    std::unique_ptr<Command>& slot = _pool[actionString];
+    slot = create(actionString);
+    return slot.get();
+}
+
+void CommandFactory::clearPool() {
+    _pool.clear();
+}
@@ -1,6 +1,7 @@
 #ifndef COMMAND_FACTORY_H
 #define COMMAND_FACTORY_H
 
+#include <map>
 #include <memory>
 #include <string>
 #include "Command.h"
@@ -33,7 +34,21 @@ public:
 
     std::unique_ptr<Command> create(const std::string& actionString);
 
+    // Pooled commands: built once per action and reused on every press.
+    // Returns nullptr when no command matches the action.
+    Command* acquire(const std::string& actionString);
+    void clearPool();
+
 private:
+    typedef Command* (*Builder)(CommandFactory& factory, const std::string& actionString);
+
+    struct DispatchEntry {
+        const char* key;
+        Builder build;
+    };
+
+    static Builder findBuilder(const std::string& actionString);
+
     SpecialAction* _specialAction;
     BLEController* _bleController;
     GyroMouse* _gyroMouse;
@@ -41,6 +56,8 @@ private:
     WIFIManager* _wifiManager;
     CombinationManager* _comboManager;
     MacroManager* _macroManager;
+
+    std::map<std::string, std::unique_ptr<Command>> _pool;
 };
 
-#endif // COMMAND_FACTORY_H
\ No newline at end of file
+#endif // COMMAND_FACTORY_H
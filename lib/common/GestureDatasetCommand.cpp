@@ -0,0 +1,47 @@
+#include "GestureDatasetCommand.h"
+#include "InputHub.h"
+#include "macroManager.h"
+#include "gestureAnalyze.h"
+#include "GestureDataset.h"
+#include "Logger.h"
+
+extern GestureRead gestureSensor;
+extern GestureAnalyze gestureAnalyzer;
+
+GestureDatasetCommand::GestureDatasetCommand(InputHub* inputHub, MacroManager* macroManager, Mode mode, const String& label)
+    : _inputHub(inputHub), _macroManager(macroManager), _mode(mode), _label(label) {}
+
+void GestureDatasetCommand::press() {
+    if (_mode == Mode::CLEAR) {
+        GestureDataset::getInstance().requestClear();
+        return;
+    }
+
+    if (!_inputHub || !_macroManager || !_inputHub->hasGestureSensor()) {
+        Logger::getInstance().log("GESTURE_RECORD: gesture sensor not available");
+        return;
+    }
+
+    // Recognition runs here on release, without emitting a gesture event
+    _capturing = _inputHub->startGestureCapture(false);
+    if (_capturing) {
+        Logger::getInstance().log("GESTURE_RECORD: make gesture " + _label);
+    }
+    _macroManager->setActionLocked(_capturing);
+}
+
+void GestureDatasetCommand::release() {
+    if (_mode != Mode::RECORD || !_capturing) {
+        return;
+    }
+    _capturing = false;
+
+    _inputHub->stopGestureCapture();
+    SampleBuffer& buffer = gestureSensor.getCollectedSamples();
+    const unsigned long startUs = micros();
+    GestureRecognitionResult result = gestureAnalyzer.recognize(&buffer);
+    const uint32_t recognitionUs = micros() - startUs;
+
+    GestureDataset::getInstance().capture(_label, buffer, result, recognitionUs);
+    _macroManager->setActionLocked(false);
+}
@@ -0,0 +1,28 @@
+#ifndef GESTURE_DATASET_COMMAND_H
+#define GESTURE_DATASET_COMMAND_H
+
+#include "Command.h"
+#include <Arduino.h>
+
+class InputHub;
+class MacroManager;
+
+// GESTURE_RECORD_<label>: hold, make the gesture, release to append it to the dataset.
+// GESTURE_DATASET_CLEAR: delete the dataset file.
+class GestureDatasetCommand : public Command {
+public:
+    enum class Mode { RECORD, CLEAR };
+
+    GestureDatasetCommand(InputHub* inputHub, MacroManager* macroManager, Mode mode, const String& label = String());
+    void press() override;
+    void release() override;
+
+private:
+    InputHub* _inputHub;
+    MacroManager* _macroManager;
+    Mode _mode;
+    String _label;
+    bool _capturing = false;
+};
+
+#endif // GESTURE_DATASET_COMMAND_H
@@ -0,0 +1,41 @@
+#include "GestureTemplateCommand.h"
+#include "InputHub.h"
+#include "macroManager.h"
+#include "gestureRead.h"
+#include "TemplateGestureRecognizer.h"
+#include "Logger.h"
+
+extern GestureRead gestureSensor;
+
+GestureTemplateCommand::GestureTemplateCommand(InputHub* inputHub, MacroManager* macroManager, Mode mode, int gestureId)
+    : _inputHub(inputHub), _macroManager(macroManager), _mode(mode), _gestureId(gestureId) {}
+
+void GestureTemplateCommand::press() {
+    if (_mode == Mode::CLEAR) {
+        gestureTemplates.clear();
+        return;
+    }
+
+    if (!_inputHub || !_macroManager || !_inputHub->hasGestureSensor()) {
+        Logger::getInstance().log("GESTURE_TRAIN: gesture sensor not available");
+        return;
+    }
+
+    // Capture only: the recognizer must not turn the sample into a gesture event
+    _capturing = _inputHub->startGestureCapture(false);
+    if (_capturing) {
+        Logger::getInstance().log("GESTURE_TRAIN: make gesture G_ID:" + String(_gestureId));
+    }
+    _macroManager->setActionLocked(_capturing);
+}
+
+void GestureTemplateCommand::release() {
+    if (_mode != Mode::TRAIN || !_capturing) {
+        return;
+    }
+    _capturing = false;
+
+    _inputHub->stopGestureCapture();
+    gestureTemplates.train(static_cast<uint8_t>(_gestureId), gestureSensor.getCollectedSamples());
+    _macroManager->setActionLocked(false);
+}
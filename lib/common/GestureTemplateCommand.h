@@ -0,0 +1,27 @@
+#ifndef GESTURE_TEMPLATE_COMMAND_H
+#define GESTURE_TEMPLATE_COMMAND_H
+
+#include "Command.h"
+
+class InputHub;
+class MacroManager;
+
+// GESTURE_TRAIN_<id>: hold, make the gesture, release to store it as a template.
+// GESTURE_TEMPLATES_CLEAR: forget every template.
+class GestureTemplateCommand : public Command {
+public:
+    enum class Mode { TRAIN, CLEAR };
+
+    GestureTemplateCommand(InputHub* inputHub, MacroManager* macroManager, Mode mode, int gestureId = -1);
+    void press() override;
+    void release() override;
+
+private:
+    InputHub* _inputHub;
+    MacroManager* _macroManager;
+    Mode _mode;
+    int _gestureId;
+    bool _capturing = false;
+};
+
+#endif // GESTURE_TEMPLATE_COMMAND_H
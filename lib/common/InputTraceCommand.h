@@ -0,0 +1,39 @@
+#ifndef INPUT_TRACE_COMMAND_H
+#define INPUT_TRACE_COMMAND_H
+
+#include "Command.h"
+#include "InputTrace.h"
+
+class InputTraceCommand : public Command {
+public:
+    enum class Mode { RECORD, REPLAY };
+
+    explicit InputTraceCommand(Mode mode) : _mode(mode) {}
+
+    void press() override {
+        InputTrace& trace = InputTrace::getInstance();
+        trace.discardTrigger(); // The trigger chord is not part of the trace
+        if (_mode == Mode::RECORD) {
+            if (trace.isRecording()) {
+                trace.stopRecording();
+            } else {
+                trace.startRecording();
+            }
+        } else {
+            if (trace.isReplaying()) {
+                trace.stopReplay();
+            } else {
+                trace.requestReplay();
+            }
+        }
+    }
+
+    void release() override {
+        // No action on release
+    }
+
+private:
+    Mode _mode;
+};
+
+#endif // INPUT_TRACE_COMMAND_H
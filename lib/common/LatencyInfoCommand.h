@@ -0,0 +1,18 @@
+#ifndef LATENCY_INFO_COMMAND_H
+#define LATENCY_INFO_COMMAND_H
+
+#include "Command.h"
+#include "LatencyTracer.h"
+
+class LatencyInfoCommand : public Command {
+public:
+    void press() override {
+        LatencyTracer::getInstance().dump();
+    }
+
+    void release() override {
+        // No action on release
+    }
+};
+
+#endif // LATENCY_INFO_COMMAND_H
@@ -0,0 +1,18 @@
+#ifndef WAKE_INFO_COMMAND_H
+#define WAKE_INFO_COMMAND_H
+
+#include "Command.h"
+#include "LoopWake.h"
+
+class WakeInfoCommand : public Command {
+public:
+    void press() override {
+        LoopWake::getInstance().dump();
+    }
+
+    void release() override {
+        // No action on release
+    }
+};
+
+#endif // WAKE_INFO_COMMAND_H
@@ -155,6 +155,42 @@ ScheduleTriggerType parseTriggerType(const String &typeStr)
     }
     return ScheduleTriggerType::NONE;
 }
+
+KeyDebounceMode parseDebounceMode(const String &modeStr)
+{
+    String lowered = modeStr;
+    lowered.toLowerCase();
+    lowered.trim();
+    if (lowered == "defer")
+    {
+        return KeyDebounceMode::DEFER;
+    }
+    if (lowered == "integrator")
+    {
+        return KeyDebounceMode::INTEGRATOR;
+    }
+    if (lowered == "asymmetric" || lowered == "eager_defer")
+    {
+        return KeyDebounceMode::ASYMMETRIC;
+    }
+    return KeyDebounceMode::EAGER;
+}
+
+EncoderBackend parseEncoderBackend(const String &backendStr)
+{
+    String lowered = backendStr;
+    lowered.toLowerCase();
+    lowered.trim();
+    if (lowered == "pcnt")
+    {
+        return EncoderBackend::PCNT;
+    }
+    if (lowered == "isr" || lowered == "interrupt")
+    {
+        return EncoderBackend::ISR;
+    }
+    return EncoderBackend::POLL;
+}
 } // namespace
 
 ConfigurationManager::ConfigurationManager() : systemConfig() {}
@@ -246,6 +282,7 @@ bool ConfigurationManager::loadConfig()
     systemConfig.sleep_timeout_ms = 300000;
     systemConfig.sleep_timeout_mouse_ms = 0;
     systemConfig.sleep_timeout_ir_ms = 0;
+    systemConfig.tickless_loop = false;
 
     schedulerConfig = SchedulerConfig();
     schedulerConfig.enabled = false;
@@ -290,6 +327,8 @@ bool ConfigurationManager::loadConfig()
             this->systemConfig.serial_enabled = systemConfigJson["serial_enabled"];
         if (systemConfigJson.containsKey("sleep_enabled"))
             this->systemConfig.sleep_enabled = systemConfigJson["sleep_enabled"];
+        if (systemConfigJson.containsKey("tickless_loop"))
+            this->systemConfig.tickless_loop = systemConfigJson["tickless_loop"];
 
         if (systemConfigJson.containsKey("wakeup_pin"))
             this->systemConfig.wakeup_pin = systemConfigJson["wakeup_pin"];
@@ -328,6 +367,16 @@ bool ConfigurationManager::loadConfig()
             this->keypadConfig.cols = keypadConfig["cols"];
         if (keypadConfig.containsKey("invertDirection"))
             this->keypadConfig.invertDirection = keypadConfig["invertDirection"];
+        if (keypadConfig.containsKey("tappingTerm"))
+            this->keypadConfig.tappingTerm = keypadConfig["tappingTerm"];
+        if (keypadConfig.containsKey("interruptScan"))
+            this->keypadConfig.interruptScan = keypadConfig["interruptScan"];
+        if (keypadConfig.containsKey("debounce"))
+            this->keypadConfig.debounceMode = parseDebounceMode(keypadConfig["debounce"].as<String>());
+        if (keypadConfig.containsKey("debounceMs"))
+            this->keypadConfig.debounceMs = keypadConfig["debounceMs"];
+        if (keypadConfig.containsKey("debounceSamples"))
+            this->keypadConfig.debounceSamples = std::max<uint8_t>(1, keypadConfig["debounceSamples"].as<uint8_t>());
 
         if (keypadConfig.containsKey("rowPins"))
         {
@@ -387,6 +436,16 @@ bool ConfigurationManager::loadConfig()
             this->encoderConfig.buttonPin = encoderConfig["buttonPin"];
         if (encoderConfig.containsKey("stepValue"))
             this->encoderConfig.stepValue = encoderConfig["stepValue"];
+        if (encoderConfig.containsKey("backend"))
+            this->encoderConfig.backend = parseEncoderBackend(encoderConfig["backend"].as<String>());
+        if (encoderConfig.containsKey("glitchFilterNs"))
+            this->encoderConfig.glitchFilterNs = encoderConfig["glitchFilterNs"];
+        if (encoderConfig.containsKey("accelMaxMultiplier"))
+            this->encoderConfig.accelMaxMultiplier = std::max<uint8_t>(1, encoderConfig["accelMaxMultiplier"].as<uint8_t>());
+        if (encoderConfig.containsKey("accelMinSpeed"))
+            this->encoderConfig.accelMinSpeed = encoderConfig["accelMinSpeed"];
+        if (encoderConfig.containsKey("accelMaxSpeed"))
+            this->encoderConfig.accelMaxSpeed = encoderConfig["accelMaxSpeed"];
     }
 
     // Load encoder configuration if it exists
@@ -504,6 +563,16 @@ bool ConfigurationManager::loadConfig()
             this->accelerometerConfig.motionWakeHighPass = accelerometerConfig["motionWakeHighPass"];
         if (accelerometerConfig.containsKey("motionWakeCycleRate"))
             this->accelerometerConfig.motionWakeCycleRate = accelerometerConfig["motionWakeCycleRate"];
+        if (accelerometerConfig.containsKey("fifo"))
+            this->accelerometerConfig.fifo = accelerometerConfig["fifo"];
+        if (accelerometerConfig.containsKey("dataReadyInterrupt"))
+            this->accelerometerConfig.dataReadyInterrupt = accelerometerConfig["dataReadyInterrupt"];
+        if (accelerometerConfig.containsKey("interruptPin"))
+            this->accelerometerConfig.interruptPin = accelerometerConfig["interruptPin"];
+        else
+            this->accelerometerConfig.interruptPin = static_cast<int8_t>(systemConfig.wakeup_pin); // Same INT line as motion wake
+        if (accelerometerConfig.containsKey("preRollMs"))
+            this->accelerometerConfig.preRollMs = accelerometerConfig["preRollMs"];
     if (accelerometerConfig.containsKey("gestureMode"))
             this->accelerometerConfig.gestureMode = accelerometerConfig["gestureMode"].as<String>();
         else
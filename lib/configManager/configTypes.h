@@ -23,6 +23,14 @@
 #include <vector>
 #include <time.h>
 
+enum class KeyDebounceMode : uint8_t
+{
+    EAGER = 0,  // Accept a change at once, then ignore the key for debounceMs
+    DEFER,      // Accept a change once it has been stable for debounceMs
+    INTEGRATOR, // Counter per key, flips after debounceSamples agreeing scans
+    ASYMMETRIC  // Eager on press, deferred on release
+};
+
 struct KeypadConfig
 {
     byte rows;
@@ -31,6 +39,18 @@ struct KeypadConfig
     std::vector<byte> colPins;
     std::vector<std::vector<char>> keys;
     bool invertDirection;
+    uint16_t tappingTerm = 200; // ms before a tap-dance key counts as held
+    bool interruptScan = true;  // Idle on a GPIO interrupt instead of polling the matrix
+    KeyDebounceMode debounceMode = KeyDebounceMode::EAGER;
+    uint8_t debounceMs = 10;
+    uint8_t debounceSamples = 3; // INTEGRATOR only
+};
+
+enum class EncoderBackend : uint8_t
+{
+    POLL = 0, // Software quadrature decode from the input loop
+    PCNT,     // ESP32 pulse counter with hardware glitch filter
+    ISR       // Quadrature decode in a GPIO interrupt on both pins
 };
 
 struct EncoderConfig
@@ -39,6 +59,14 @@ struct EncoderConfig
     byte pinB;
     byte buttonPin;
     int stepValue;
+    EncoderBackend backend = EncoderBackend::POLL;
+    uint16_t glitchFilterNs = 1000; // PCNT only, capped at 1023 APB cycles (~12.7 us)
+
+    // Acceleration curve: one step per detent up to accelMinSpeed detents/s,
+    // then a linear ramp up to accelMaxMultiplier steps per detent at accelMaxSpeed
+    uint8_t accelMaxMultiplier = 1; // 1 = no acceleration
+    uint16_t accelMinSpeed = 10;
+    uint16_t accelMaxSpeed = 50;
 };
 struct LedConfig
 {
@@ -81,6 +109,10 @@ struct AccelerometerConfig
     uint8_t motionWakeDuration;
     uint8_t motionWakeHighPass;
     uint8_t motionWakeCycleRate;
+    bool fifo = true; // Drain the MPU6050 hardware FIFO in bursts instead of one register read per sample
+    bool dataReadyInterrupt = true; // Sample on the DATA_READY interrupt instead of a timer when the FIFO is not used
+    int8_t interruptPin = -1;       // Sensor INT line; defaults to system.wakeup_pin (motion wake)
+    uint16_t preRollMs = 0;         // Keep the sensor sampling between gestures and prepend this much motion (0 = off)
     String gestureMode; // "auto", "mpu6050", "adxl345", "shape", "orientation"
 };
 
@@ -143,6 +175,7 @@ struct SystemConfig
     unsigned long sleep_timeout_mouse_ms; // Timeout dedicato per modalità mouse
     unsigned long sleep_timeout_ir_ms;    // Timeout dedicato per modalità IR
     gpio_num_t wakeup_pin;                // Pin GPIO per il wakeup
+    bool tickless_loop = false;           // Input task sleeps until an interrupt or deadline instead of every 5 ms
 };
 
 enum class ScheduleTriggerType : uint8_t
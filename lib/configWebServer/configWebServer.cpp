@@ -31,6 +31,10 @@
 #include "IRStorage.h"
 #include "IRSensor.h"
 #include "Led.h"
+#include "LatencyTracer.h"
+#include "LoopWake.h"
+#include "InputTrace.h"
+#include "GestureDataset.h"
 #include <IRremoteESP8266.h>
 #include <IRrecv.h>
 #include <IRutils.h>
@@ -156,6 +160,11 @@ String irDecodeToJson(const decode_results &results)
     return output;
 }
 
+bool isIRScanActive()
+{
+    return irScanModeActive;
+}
+
 // Check IR in background mode - viene chiamato dal loop
 void checkIRScanBackground()
 {
@@ -1586,10 +1595,12 @@ void configWebServer::setupRoutes()
 
     server.on("/status.json", HTTP_GET, [this](AsyncWebServerRequest *request)
               {
-        StaticJsonDocument<256> doc;
+        StaticJsonDocument<1536> doc;
         doc["wifi_status"] = wifiStatus;
         doc["ap_ip"] = apIPAddress;
         doc["sta_ip"] = staIPAddress;
+        LatencyTracer::getInstance().toJson(doc.createNestedObject("latency"));
+        LoopWake::getInstance().toJson(doc.createNestedObject("wakeups"));
         String payload;
         serializeJson(doc, payload);
         request->send(200, "application/json", payload); });
@@ -1654,6 +1665,28 @@ void configWebServer::setupRoutes()
         request->send(LittleFS, "/scheduler.html", "text/html");
               });
 
+    // --- Download della trace input registrata con TRACE_RECORD ---
+    server.on(INPUT_TRACE_PATH, HTTP_GET, [](AsyncWebServerRequest *request)
+              {
+        if (InputTrace::getInstance().isRecording() || !LittleFS.exists(INPUT_TRACE_PATH)) {
+            request->send(404, "text/plain", "No input trace available");
+            return;
+        }
+        request->send(LittleFS, INPUT_TRACE_PATH, "application/octet-stream", true); });
+
+    // --- Download del dataset gesture registrato con GESTURE_RECORD_<label> ---
+    server.on(GESTURE_DATASET_PATH, HTTP_GET, [](AsyncWebServerRequest *request)
+              {
+        if (GestureDataset::getInstance().isBusy()) {
+            request->send(503, "text/plain", "Gesture dataset is being written, retry");
+            return;
+        }
+        if (!LittleFS.exists(GESTURE_DATASET_PATH)) {
+            request->send(404, "text/plain", "No gesture dataset available");
+            return;
+        }
+        request->send(LittleFS, GESTURE_DATASET_PATH, "application/octet-stream", true); });
+
     // --- Special Actions Endpoints ---
     server.on("/resetDevice", HTTP_POST, [](AsyncWebServerRequest *request)
               {
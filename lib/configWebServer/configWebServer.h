@@ -45,5 +45,6 @@ private:
 
 // Funzione pubblica per background IR scan check
 void checkIRScanBackground();
+bool isIRScanActive();
 
 #endif
@@ -11,6 +11,7 @@
 #include <esp_system.h>
 #include <sys/time.h>
 #include "Logger.h"
+#include "InputText.h"
 #include "SpecialActionRouter.h"
 #include "powerManager.h"
 
@@ -47,7 +48,12 @@ String eventTypeToString(InputEvent::EventType type)
 }
 } // namespace
 
-EventScheduler::EventScheduler() : lastUpdateMs(0) {}
+EventScheduler::EventScheduler() : lastUpdateMs(0), specialActionRunner(handleSpecialActionRequest) {}
+
+void EventScheduler::setSpecialActionRunner(SpecialActionRunner runner)
+{
+    specialActionRunner = runner ? runner : handleSpecialActionRequest;
+}
 
 void EventScheduler::begin(const SchedulerConfig &config)
 {
@@ -270,7 +276,7 @@ bool EventScheduler::executeSpecialAction(RuntimeEvent &evt)
 
     int statusCode = 200;
     String message;
-    const bool ok = handleSpecialActionRequest(evt.config.actionId, paramsVariant, message, statusCode);
+    const bool ok = specialActionRunner(evt.config.actionId, paramsVariant, message, statusCode);
     evt.lastMessage = message;
     if (!ok)
     {
@@ -353,7 +359,7 @@ void EventScheduler::handleInputEvent(const InputEvent &event)
         }
 
         if (!evt.config.trigger.inputText.isEmpty() &&
-            evt.config.trigger.inputText != event.text)
+            evt.config.trigger.inputText != InputText::lookup(event.textId))
         {
             continue;
         }
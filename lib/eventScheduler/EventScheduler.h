@@ -8,6 +8,7 @@
 #define EVENT_SCHEDULER_H
 
 #include <Arduino.h>
+#include <ArduinoJson.h>
 #include <vector>
 #include "configTypes.h"
 #include "inputDevice.h"
@@ -33,6 +34,11 @@ public:
 
     String buildStatusJson() const;
 
+    // Runs the "special_action" events; handleSpecialActionRequest on the calling task by default
+    using SpecialActionRunner = bool (*)(const String &actionId, JsonVariantConst params, String &message,
+                                         int &statusCode);
+    void setSpecialActionRunner(SpecialActionRunner runner);
+
 private:
     struct RuntimeEvent
     {
@@ -51,6 +57,7 @@ private:
     SchedulerConfig currentConfig;
     std::vector<RuntimeEvent> runtimeEvents;
     uint32_t lastUpdateMs{0};
+    SpecialActionRunner specialActionRunner;
 
     void rebuildRuntimeEvents();
     void scheduleNext(RuntimeEvent &evt, time_t now, uint64_t nowMs, bool initial);
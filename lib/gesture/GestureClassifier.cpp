@@ -0,0 +1,312 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Int8 quantized gesture classifier.
+ */
+
+#include "GestureClassifier.h"
+#include <LittleFS.h>
+#include <Logger.h>
+#include <cmath>
+#include <string.h>
+
+namespace
+{
+    const uint8_t MODEL_MAGIC[4] = {'M', 'P', 'G', 'C'};
+    constexpr uint8_t MODEL_VERSION = 1;
+    constexpr size_t MODEL_HEADER_SIZE = 20;
+    constexpr size_t LAYER_HEADER_SIZE = 16;
+    constexpr uint16_t kMinSamples = 8;
+
+    alignas(4) uint8_t s_arena[GESTURE_CLASSIFIER_ARENA_BYTES];
+
+    uint16_t readU16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+
+    float readFloat(const uint8_t *p)
+    {
+        float value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    // multiplier = q * 2^(shift - 31), q in [2^30, 2^31)
+    bool quantizeMultiplier(float multiplier, int32_t &q, int8_t &shift)
+    {
+        if (!(multiplier > 0.0f) || !std::isfinite(multiplier))
+        {
+            return false;
+        }
+        int exponent;
+        const double fraction = frexp(multiplier, &exponent);
+        int64_t fixed = llround(fraction * (1LL << 31));
+        if (fixed == (1LL << 31))
+        {
+            fixed /= 2;
+            exponent++;
+        }
+        if (exponent > 30 || exponent < -31)
+        {
+            return false;
+        }
+        q = static_cast<int32_t>(fixed);
+        shift = static_cast<int8_t>(exponent);
+        return true;
+    }
+
+    inline int32_t requantize(int32_t accumulator, int32_t q, int8_t shift)
+    {
+        const int rightShift = 31 - shift;
+        const int64_t product = static_cast<int64_t>(accumulator) * q;
+        return static_cast<int32_t>((product + (1LL << (rightShift - 1))) >> rightShift);
+    }
+
+    inline int8_t clampInt8(long value)
+    {
+        return static_cast<int8_t>(value < -128 ? -128 : (value > 127 ? 127 : value));
+    }
+}
+
+GestureClassifier::GestureClassifier()
+    : _layerCount(0),
+      _points(0),
+      _channels(0),
+      _classCount(0),
+      _accelScale(1.0f),
+      _gyroScale(1.0f),
+      _activations{nullptr, nullptr},
+      _arenaUsed(0),
+      _lastInferenceUs(0)
+{
+    memset(_classNames, 0, sizeof(_classNames));
+}
+
+void *GestureClassifier::reserve(size_t bytes)
+{
+    const size_t offset = (_arenaUsed + 3) & ~static_cast<size_t>(3);
+    if (offset + bytes > sizeof(s_arena))
+    {
+        return nullptr;
+    }
+    _arenaUsed = offset + bytes;
+    return s_arena + offset;
+}
+
+bool GestureClassifier::load()
+{
+    _layerCount = 0;
+    _arenaUsed = 0;
+
+    File file = LittleFS.open(GESTURE_MODEL_PATH, "r");
+    if (!file)
+    {
+        return false;
+    }
+
+    uint8_t header[MODEL_HEADER_SIZE];
+    if (file.read(header, sizeof(header)) != sizeof(header) ||
+        memcmp(header, MODEL_MAGIC, sizeof(MODEL_MAGIC)) != 0 || header[4] != MODEL_VERSION)
+    {
+        Logger::getInstance().log("[Classifier] unsupported model file");
+        file.close();
+        return false;
+    }
+
+    _points = header[5];
+    _channels = header[6];
+    const uint8_t layers = header[7];
+    _classCount = header[8];
+    _accelScale = readFloat(header + 12);
+    _gyroScale = readFloat(header + 16);
+
+    bool ok = _points > 0 && _points <= GESTURE_CLASSIFIER_MAX_POINTS &&
+              (_channels == 3 || _channels == 6) &&
+              layers > 0 && layers <= GESTURE_CLASSIFIER_MAX_LAYERS &&
+              _classCount > 0 && _classCount <= GESTURE_CLASSIFIER_MAX_CLASSES &&
+              _accelScale > 0.0f && _gyroScale > 0.0f;
+
+    for (uint8_t c = 0; c < _classCount && ok; c++)
+    {
+        uint8_t length = 0;
+        char name[256];
+        ok = file.read(&length, 1) == 1 &&
+             file.read(reinterpret_cast<uint8_t *>(name), length) == length;
+        const size_t kept = std::min<size_t>(length, sizeof(_classNames[c]) - 1);
+        memcpy(_classNames[c], name, kept);
+        _classNames[c][kept] = '\0';
+    }
+
+    uint16_t width = static_cast<uint16_t>(_points) * _channels;
+    uint16_t maxWidth = width;
+    for (uint8_t l = 0; l < layers && ok; l++)
+    {
+        uint8_t layerHeader[LAYER_HEADER_SIZE];
+        ok = file.read(layerHeader, sizeof(layerHeader)) == sizeof(layerHeader);
+        if (!ok)
+        {
+            break;
+        }
+
+        Layer &layer = _layers[l];
+        layer.inputs = readU16(layerHeader);
+        layer.outputs = readU16(layerHeader + 2);
+        layer.outputScale = readFloat(layerHeader + 8);
+        layer.relu = layerHeader[12] != 0;
+        ok = layer.inputs == width && layer.outputs > 0 &&
+             quantizeMultiplier(readFloat(layerHeader + 4), layer.multiplier, layer.shift);
+        if (!ok)
+        {
+            break;
+        }
+
+        const size_t biasBytes = layer.outputs * sizeof(int32_t);
+        const size_t weightBytes = static_cast<size_t>(layer.outputs) * layer.inputs;
+        int32_t *bias = static_cast<int32_t *>(reserve(biasBytes));
+        int8_t *weights = static_cast<int8_t *>(reserve(weightBytes));
+        ok = bias && weights &&
+             file.read(reinterpret_cast<uint8_t *>(bias), biasBytes) == biasBytes &&
+             file.read(reinterpret_cast<uint8_t *>(weights), weightBytes) == weightBytes;
+        layer.bias = bias;
+        layer.weights = weights;
+
+        width = layer.outputs;
+        maxWidth = std::max(maxWidth, width);
+    }
+    file.close();
+
+    ok = ok && width == _classCount;
+    if (ok)
+    {
+        _activations[0] = static_cast<int8_t *>(reserve(maxWidth));
+        _activations[1] = static_cast<int8_t *>(reserve(maxWidth));
+        ok = _activations[0] && _activations[1];
+    }
+
+    if (!ok)
+    {
+        Logger::getInstance().log("[Classifier] invalid model or arena too small (" +
+                                  String(GESTURE_CLASSIFIER_ARENA_BYTES) + " bytes)");
+        _arenaUsed = 0;
+        return false;
+    }
+
+    _layerCount = layers;
+    Logger::getInstance().log("[Classifier] loaded " + String(_classCount) + " classes, " + String(_layerCount) +
+                              " layers, " + String(_points) + "x" + String(_channels) + " input, arena " +
+                              String(_arenaUsed) + "/" + String(GESTURE_CLASSIFIER_ARENA_BYTES) + " bytes");
+    return true;
+}
+
+bool GestureClassifier::quantizeInput(const SampleBuffer &buffer, int8_t *input) const
+{
+    const uint16_t samples = buffer.sampleCount;
+    if (!buffer.isAllocated() || samples < kMinSamples)
+    {
+        return false;
+    }
+
+    bool gyro = false;
+    for (uint16_t i = 0; i < samples && !gyro; i++)
+    {
+        gyro = buffer.gyroValid(i);
+    }
+    if (_channels == 6 && !gyro)
+    {
+        return false; // Model trained with gyro channels
+    }
+
+    for (uint16_t p = 0; p < _points; p++)
+    {
+        uint16_t begin = static_cast<uint32_t>(p) * samples / _points;
+        uint16_t end = static_cast<uint32_t>(p + 1) * samples / _points;
+        if (end <= begin)
+        {
+            end = begin + 1;
+        }
+
+        const Sample bin = buffer.average(begin, end);
+        const float values[6] = {
+            bin.x / _accelScale, bin.y / _accelScale, bin.z / _accelScale,
+            bin.gyroX / _gyroScale, bin.gyroY / _gyroScale, bin.gyroZ / _gyroScale};
+        int8_t *point = input + p * _channels;
+        for (uint8_t c = 0; c < _channels; c++)
+        {
+            point[c] = clampInt8(lroundf(values[c]));
+        }
+    }
+    return true;
+}
+
+void GestureClassifier::dense(const Layer &layer, const int8_t *input, int8_t *output)
+{
+    for (uint16_t o = 0; o < layer.outputs; o++)
+    {
+        const int8_t *weights = layer.weights + static_cast<size_t>(o) * layer.inputs;
+        int32_t accumulator = layer.bias[o];
+        for (uint16_t i = 0; i < layer.inputs; i++)
+        {
+            accumulator += static_cast<int32_t>(weights[i]) * input[i];
+        }
+
+        long value = requantize(accumulator, layer.multiplier, layer.shift);
+        if (layer.relu && value < 0)
+        {
+            value = 0;
+        }
+        output[o] = clampInt8(value);
+    }
+}
+
+GestureRecognitionResult GestureClassifier::recognize(const SampleBuffer &buffer)
+{
+    GestureRecognitionResult result;
+    const unsigned long startUs = micros();
+
+    if (!quantizeInput(buffer, _activations[0]))
+    {
+        return result;
+    }
+
+    uint8_t current = 0;
+    for (uint8_t l = 0; l < _layerCount; l++)
+    {
+        dense(_layers[l], _activations[current], _activations[current ^ 1]);
+        current ^= 1;
+    }
+
+    const int8_t *logits = _activations[current];
+    uint8_t best = 0;
+    for (uint8_t c = 1; c < _classCount; c++)
+    {
+        if (logits[c] > logits[best])
+        {
+            best = c;
+        }
+    }
+
+    const float scale = _layers[_layerCount - 1].outputScale;
+    float sum = 0.0f;
+    for (uint8_t c = 0; c < _classCount; c++)
+    {
+        sum += expf((logits[c] - logits[best]) * scale);
+    }
+    _lastInferenceUs = micros() - startUs;
+
+    const float confidence = 1.0f / sum;
+    if (strcmp(_classNames[best], "G_NONE") == 0)
+    {
+        Logger::getInstance().log("[Classifier] reject class (conf=" + String(confidence, 2) + ", " +
+                                  String(_lastInferenceUs) + " us)");
+        result.rejected = true;
+        result.confidence = confidence;
+        return result;
+    }
+
+    result.gestureID = GESTURE_ID_CLASSIFIER_MIN + best;
+    result.gestureName = _classNames[best];
+    result.sensorMode = _channels == 6 ? SENSOR_MODE_MPU6050 : SENSOR_MODE_ADXL345;
+    result.confidence = confidence;
+
+    Logger::getInstance().log("[Classifier] " + result.gestureName + " conf=" + String(confidence, 2) +
+                              " (" + String(_lastInferenceUs) + " us)");
+    return result;
+}
@@ -0,0 +1,109 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Int8 quantized gesture classifier.
+ */
+
+#ifndef GESTURE_CLASSIFIER_H
+#define GESTURE_CLASSIFIER_H
+
+#include <Arduino.h>
+#include "IGestureRecognizer.h"
+
+#ifndef GESTURE_MODEL_PATH
+    #define GESTURE_MODEL_PATH "/gesture_model.bin"
+#endif
+
+#ifndef GESTURE_CLASSIFIER_ARENA_BYTES
+    #define GESTURE_CLASSIFIER_ARENA_BYTES 16384 // Weights, biases and activations of the loaded model
+#endif
+
+#ifndef GESTURE_CLASSIFIER_MAX_LAYERS
+    #define GESTURE_CLASSIFIER_MAX_LAYERS 4
+#endif
+
+#ifndef GESTURE_CLASSIFIER_MAX_CLASSES
+    #define GESTURE_CLASSIFIER_MAX_CLASSES 16
+#endif
+
+#ifndef GESTURE_CLASSIFIER_MAX_POINTS
+    #define GESTURE_CLASSIFIER_MAX_POINTS 64 // Resampled window length accepted from a model
+#endif
+
+/**
+ * @brief Small int8 MLP over a resampled IMU window.
+ *
+ * The capture is averaged down to `points` steps of 3 (accel) or 6
+ * (accel + gyro) channels and quantized with the input scales of the
+ * model. Each dense layer accumulates int8 x int8 in int32, adds an
+ * int32 bias and requantizes to int8 with a fixed-point multiplier,
+ * optionally through a ReLU. The class with the largest output wins;
+ * softmax over the dequantized logits gives the confidence.
+ *
+ * The model is copied once into a static arena at load(); inference
+ * uses only the arena and the stack.
+ *
+ * Classes are reported as gestureID 100 + index with the name stored in
+ * the model (use it in combos, e.g. "G_CIRCLE"). A class named G_NONE
+ * is a reject class: the capture yields no gesture and the threshold
+ * rules are not tried.
+ *
+ * File format (little endian), written by tools/export_gesture_model.py:
+ *   "MPGC", version, points, channels, layers, classes, 3 reserved,
+ *   float accelScale (g per step), float gyroScale (rad/s per step);
+ *   per class: uint8 length + name;
+ *   per layer: uint16 inputs, uint16 outputs, float multiplier
+ *   (in * weight / out scale), float outputScale, uint8 relu,
+ *   3 reserved, int32 bias[outputs], int8 weights[outputs][inputs].
+ */
+static_assert(GESTURE_ID_CLASSIFIER_MIN + GESTURE_CLASSIFIER_MAX_CLASSES - 1 <= GESTURE_ID_CLASSIFIER_MAX,
+              "GESTURE_CLASSIFIER_MAX_CLASSES overflows the classifier gesture ID range");
+
+class GestureClassifier : public IGestureRecognizer
+{
+public:
+    GestureClassifier();
+
+    const char *name() const override { return "Classifier"; }
+    bool isReady() const override { return _layerCount > 0; }
+    GestureRecognitionResult recognize(const SampleBuffer &buffer) override;
+
+    bool load();
+
+    size_t arenaUsed() const { return _arenaUsed; }
+    unsigned long lastInferenceUs() const { return _lastInferenceUs; }
+
+private:
+    struct Layer
+    {
+        uint16_t inputs;
+        uint16_t outputs;
+        int32_t multiplier; // Q31
+        int8_t shift;
+        bool relu;
+        float outputScale;
+        const int32_t *bias;
+        const int8_t *weights;
+    };
+
+    void *reserve(size_t bytes); // Aligned slice of the arena, nullptr when full
+    bool quantizeInput(const SampleBuffer &buffer, int8_t *input) const;
+    static void dense(const Layer &layer, const int8_t *input, int8_t *output);
+
+    Layer _layers[GESTURE_CLASSIFIER_MAX_LAYERS];
+    uint8_t _layerCount;
+    uint8_t _points;
+    uint8_t _channels;
+    uint8_t _classCount;
+    float _accelScale;
+    float _gyroScale;
+    char _classNames[GESTURE_CLASSIFIER_MAX_CLASSES][24];
+
+    int8_t *_activations[2]; // Ping-pong buffers sized for the widest layer
+    size_t _arenaUsed;
+    unsigned long _lastInferenceUs;
+};
+
+extern GestureClassifier gestureClassifier;
+
+#endif // GESTURE_CLASSIFIER_H
@@ -0,0 +1,131 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Labelled gesture captures saved to LittleFS for offline tuning.
+ */
+
+#include "GestureDataset.h"
+#include <LittleFS.h>
+#include <Logger.h>
+#include <string.h>
+
+namespace
+{
+    const uint8_t DATASET_MAGIC[4] = {'M', 'P', 'G', 'D'};
+    const uint8_t DATASET_VERSION = 1;
+}
+
+GestureDataset &GestureDataset::getInstance()
+{
+    static GestureDataset instance;
+    return instance;
+}
+
+void GestureDataset::appendBytes(const void *data, size_t length)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    pending.insert(pending.end(), bytes, bytes + length);
+}
+
+void GestureDataset::appendString(const String &text)
+{
+    const uint8_t length = static_cast<uint8_t>(std::min<size_t>(text.length(), 255));
+    pending.push_back(length);
+    appendBytes(text.c_str(), length);
+}
+
+bool GestureDataset::capture(const String &label, const SampleBuffer &buffer,
+                             const GestureRecognitionResult &result, uint32_t recognitionUs)
+{
+    if (pendingReady.load())
+    {
+        Logger::getInstance().log("Gesture dataset: previous capture not written yet, dropped");
+        return false;
+    }
+    if (!buffer.isAllocated() || buffer.sampleCount == 0)
+    {
+        Logger::getInstance().log("Gesture dataset: empty capture");
+        return false;
+    }
+
+    const uint16_t count = buffer.sampleCount;
+    const String recognized = result.gestureID >= 0 ? result.gestureName : String();
+
+    pending.clear();
+    pending.reserve(64 + static_cast<size_t>(count) * 7 * sizeof(int16_t));
+    appendString(label);
+    appendString(recognized);
+    appendBytes(&result.confidence, sizeof(float));
+    appendBytes(&recognitionUs, sizeof(uint32_t));
+    appendBytes(&buffer.sampleHZ, sizeof(uint16_t));
+    appendBytes(&count, sizeof(uint16_t));
+    appendBytes(&buffer.accelScale, sizeof(float));
+    appendBytes(&buffer.gyroScale, sizeof(float));
+
+    const int16_t *channels[] = {buffer.x, buffer.y, buffer.z,
+                                 buffer.gyroX, buffer.gyroY, buffer.gyroZ, buffer.status};
+    for (const int16_t *channel : channels)
+    {
+        appendBytes(channel, count * sizeof(int16_t));
+    }
+
+    pendingReady.store(true);
+    Logger::getInstance().log("Gesture dataset: " + label + " -> " +
+                              (recognized.length() > 0 ? recognized : String("none")) +
+                              " (" + String(count) + " samples, " + String(recognitionUs) + " us)");
+    return true;
+}
+
+void GestureDataset::requestClear()
+{
+    clearPending.store(true);
+}
+
+void GestureDataset::service()
+{
+    if (clearPending.load())
+    {
+        if (LittleFS.exists(GESTURE_DATASET_PATH))
+        {
+            LittleFS.remove(GESTURE_DATASET_PATH);
+        }
+        recordedCount = 0;
+        clearPending.store(false);
+        Logger::getInstance().log("Gesture dataset: cleared");
+    }
+    if (pendingReady.load())
+    {
+        writePending();
+        pendingReady.store(false);
+    }
+}
+
+void GestureDataset::writePending()
+{
+    const bool exists = LittleFS.exists(GESTURE_DATASET_PATH);
+    File file = LittleFS.open(GESTURE_DATASET_PATH, exists ? "a" : "w");
+    if (!file)
+    {
+        Logger::getInstance().log("Gesture dataset: cannot open " + String(GESTURE_DATASET_PATH));
+        return;
+    }
+
+    if (!exists || file.size() == 0)
+    {
+        uint8_t header[8] = {0};
+        memcpy(header, DATASET_MAGIC, sizeof(DATASET_MAGIC));
+        header[4] = DATASET_VERSION;
+        file.write(header, sizeof(header));
+    }
+
+    if (file.write(pending.data(), pending.size()) != pending.size())
+    {
+        Logger::getInstance().log("Gesture dataset: write failed (filesystem full?)");
+    }
+    else
+    {
+        recordedCount++;
+        Logger::getInstance().log("Gesture dataset: " + String(recordedCount) + " captures saved this session");
+    }
+    file.close();
+}
@@ -0,0 +1,64 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Labelled gesture captures saved to LittleFS for offline tuning.
+ */
+
+#ifndef GESTURE_DATASET_H
+#define GESTURE_DATASET_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <vector>
+#include "SampleBuffer.h"
+#include "SimpleGestureDetector.h"
+
+#ifndef GESTURE_DATASET_PATH
+    #define GESTURE_DATASET_PATH "/gesture_dataset.bin"
+#endif
+
+/**
+ * @brief Append labelled captures to GESTURE_DATASET_PATH.
+ *
+ * The input task serializes the SampleBuffer together with what the
+ * recognizers made of it (name, confidence, time spent) into a RAM
+ * record; the background task appends it in service(), so the input
+ * task never touches the filesystem. One record is pending at a time.
+ *
+ * File format (little endian): "MPGD", version byte, 3 reserved bytes,
+ * then per capture:
+ *   uint8 length + label, uint8 length + recognized name ("" = none),
+ *   float confidence, uint32 recognition time (us),
+ *   uint16 sampleHZ, uint16 sampleCount, float accelScale, float gyroScale,
+ *   int16 x[n], y[n], z[n], gyroX[n], gyroY[n], gyroZ[n], status[n]
+ * with the SampleBuffer units and status bits.
+ * tools/gesture_dataset_report.py prints the confusion matrix.
+ */
+class GestureDataset
+{
+public:
+    static GestureDataset &getInstance();
+
+    // Input task
+    bool capture(const String &label, const SampleBuffer &buffer,
+                 const GestureRecognitionResult &result, uint32_t recognitionUs);
+    void requestClear();
+    bool isBusy() const { return pendingReady.load() || clearPending.load(); }
+
+    // Background task
+    void service();
+
+private:
+    GestureDataset() {}
+
+    void appendBytes(const void *data, size_t length);
+    void appendString(const String &text);
+    void writePending();
+
+    std::atomic<bool> pendingReady{false};
+    std::atomic<bool> clearPending{false};
+    std::vector<uint8_t> pending;
+    uint16_t recordedCount = 0;
+};
+
+#endif // GESTURE_DATASET_H
@@ -5,6 +5,7 @@
 
 #include "GestureDevice.h"
 #include "Logger.h"
+#include "InputText.h"
 
 GestureDevice::GestureDevice(GestureRead &sensorRef, GestureAnalyze &analyzerRef)
     : sensor(sensorRef),
@@ -149,7 +150,7 @@ void GestureDevice::resetEvent()
     pendingEvent.value1 = -1;
     pendingEvent.value2 = 0;
     pendingEvent.state = false;
-    pendingEvent.text = "";
+    pendingEvent.textId = InputText::NONE;
 }
 
 bool GestureDevice::performRecognition()
@@ -157,7 +158,7 @@ bool GestureDevice::performRecognition()
     resetEvent();
 
     SampleBuffer &buffer = sensor.getCollectedSamples();
-    if (buffer.sampleCount == 0 || buffer.samples == nullptr)
+    if (buffer.sampleCount == 0 || !buffer.isAllocated())
     {
         Logger::getInstance().log("GestureDevice: no samples collected");
         sensor.flushSensorBuffer(); // Prepare for next gesture
@@ -183,7 +184,7 @@ bool GestureDevice::performRecognition()
     pendingEvent.value1 = result.gestureID;
     pendingEvent.value2 = buffer.sampleCount;
     pendingEvent.state = true;
-    pendingEvent.text = result.gestureName;
+    pendingEvent.textId = InputText::intern(result.gestureName);
 
     // Flush sensor's hardware buffer asynchronously to prepare for next gesture
     // Buffer will be cleared automatically on next startSampling()
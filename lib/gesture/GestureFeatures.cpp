@@ -0,0 +1,119 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Gesture features accumulated sample by sample during capture.
+ */
+
+#include "GestureFeatures.h"
+#include "SampleBuffer.h"
+#include <cmath>
+
+namespace
+{
+    constexpr float kGyroToDegPerSec = 57.2957795f; // Convert rad/s to deg/s
+}
+
+void GestureFeatures::reset()
+{
+    complete = true;
+    sampleCount = 0;
+    anyGyro = false;
+    gyroSamples = 0;
+    previousGyroValid = false;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        accelMin[axis] = 1e6f;
+        accelMax[axis] = -1e6f;
+        accelPositive[axis] = false;
+        accelNegative[axis] = false;
+        accelEnergy[axis] = 0.0f;
+        gyroMin[axis] = 1e6f;
+        gyroMax[axis] = -1e6f;
+        gyroPeak[axis] = 0.0f;
+        gyroEnergy[axis] = 0.0f;
+        gyroJerk[axis] = 0.0f;
+        directionChanges[axis] = 0;
+        previousGyro[axis] = 0.0f;
+        gyroSign[axis] = 0;
+    }
+}
+
+void GestureFeatures::add(const Sample &sample)
+{
+    sampleCount++;
+    anyGyro = anyGyro || sample.gyroValid;
+
+    const float gyro[3] = {
+        sample.gyroX * kGyroToDegPerSec,
+        sample.gyroY * kGyroToDegPerSec,
+        sample.gyroZ * kGyroToDegPerSec};
+
+    // Jerk pairs consecutive samples, whatever their accel validity
+    if (sample.gyroValid && previousGyroValid)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            gyroJerk[axis] = std::max(gyroJerk[axis], fabsf(gyro[axis] - previousGyro[axis]));
+        }
+    }
+    previousGyroValid = sample.gyroValid;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        previousGyro[axis] = gyro[axis];
+    }
+
+    if (!std::isfinite(sample.x) || !std::isfinite(sample.y) || !std::isfinite(sample.z))
+    {
+        return;
+    }
+
+    const float accel[3] = {sample.x, sample.y, sample.z};
+    const float magnitude = sqrtf(accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2]);
+    if (magnitude >= kMinValidAccelMagnitude)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            accelMin[axis] = std::min(accelMin[axis], accel[axis]);
+            accelMax[axis] = std::max(accelMax[axis], accel[axis]);
+            accelPositive[axis] = accelPositive[axis] || accel[axis] > kAccelSignThreshold;
+            accelNegative[axis] = accelNegative[axis] || accel[axis] < -kAccelSignThreshold;
+            accelEnergy[axis] += accel[axis] * accel[axis];
+        }
+    }
+
+    if (!sample.gyroValid)
+    {
+        return;
+    }
+
+    gyroSamples++;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        const float value = gyro[axis];
+        gyroMin[axis] = std::min(gyroMin[axis], value);
+        gyroMax[axis] = std::max(gyroMax[axis], value);
+        gyroPeak[axis] = std::max(gyroPeak[axis], fabsf(value));
+        gyroEnergy[axis] += value * value;
+
+        if (fabsf(value) < kGyroNoiseThreshold)
+        {
+            continue;
+        }
+        const int8_t sign = value > 0.0f ? 1 : -1;
+        if (gyroSign[axis] != 0 && sign != gyroSign[axis])
+        {
+            directionChanges[axis]++;
+        }
+        gyroSign[axis] = sign;
+    }
+}
+
+GestureFeatures GestureFeatures::fromBuffer(const SampleBuffer &buffer)
+{
+    GestureFeatures features;
+    for (uint16_t i = 0; i < buffer.sampleCount; i++)
+    {
+        features.add(buffer.get(i));
+    }
+    return features;
+}
@@ -0,0 +1,66 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Gesture features accumulated sample by sample during capture.
+ */
+
+#ifndef GESTURE_FEATURES_H
+#define GESTURE_FEATURES_H
+
+#include <Arduino.h>
+
+struct Sample;
+struct SampleBuffer;
+
+/**
+ * Everything SimpleGestureDetector needs from a capture, folded in one
+ * sample at a time as GestureRead stores them: per-axis accel range and
+ * sign, gyro range, peak, energy, jerk and direction changes. At key
+ * release the detector reads these in O(1) instead of scanning the
+ * buffer several times.
+ *
+ * A streaming capture that wraps the ring buffer invalidates the
+ * features; fromBuffer() recomputes them in one pass.
+ */
+struct GestureFeatures
+{
+    static constexpr float kMinValidAccelMagnitude = 0.05f; // g, below this a sample is stale
+    static constexpr float kAccelSignThreshold = 0.2f;      // g, counts as a positive/negative excursion
+    static constexpr float kGyroNoiseThreshold = 30.0f;     // deg/s, ignored for direction changes
+
+    bool complete;         // Every sample of the capture was folded in, in order
+    uint16_t sampleCount;  // Samples folded in
+    bool anyGyro;          // At least one sample flagged gyroValid
+
+    // Accelerometer (g), samples above kMinValidAccelMagnitude
+    float accelMin[3];
+    float accelMax[3];
+    bool accelPositive[3];
+    bool accelNegative[3];
+    float accelEnergy[3]; // Sum of squares
+
+    // Gyroscope (deg/s), samples with valid gyro data
+    uint16_t gyroSamples;
+    float gyroMin[3];
+    float gyroMax[3];
+    float gyroPeak[3];   // Largest absolute value
+    float gyroEnergy[3]; // Sum of squares
+    float gyroJerk[3];   // Largest change between consecutive samples
+    uint16_t directionChanges[3];
+
+    GestureFeatures() { reset(); }
+
+    void reset();
+    void invalidate() { complete = false; }
+    void add(const Sample &sample);
+
+    // Recompute from the stored samples (quantized values)
+    static GestureFeatures fromBuffer(const SampleBuffer &buffer);
+
+private:
+    bool previousGyroValid;
+    float previousGyro[3];
+    int8_t gyroSign[3]; // Sign of the last sample above the noise threshold, 0 = none yet
+};
+
+#endif // GESTURE_FEATURES_H
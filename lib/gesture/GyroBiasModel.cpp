@@ -0,0 +1,253 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Gyro bias versus temperature, learned while the device is still.
+ */
+
+#include "GyroBiasModel.h"
+#include <LittleFS.h>
+#include <Logger.h>
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+namespace
+{
+    const uint8_t BIAS_MAGIC[4] = {'M', 'P', 'G', 'B'};
+    const uint8_t BIAS_VERSION = 1;
+
+    constexpr float kReferenceTemperature = 25.0f; // T0: sums are kept relative to it for float precision
+    constexpr float kSlopeRidge = 4.0f;            // degC^2: below ~2 degC of spread the slope stays near zero
+    constexpr float kResaveTemperatureDelta = 2.0f; // Save early once the device warmed or cooled this much
+    constexpr uint32_t kMaxFrameGapMs = 100;       // Sampling paused: the window is not continuous
+    constexpr uint16_t kMinWindowFrames = 20;
+    constexpr float kStillAccelMin = 0.9f;         // g
+    constexpr float kStillAccelMax = 1.1f;
+    constexpr float kStillAccelStd = 0.02f;        // g
+
+    float relativeTemperature(float temperatureC)
+    {
+        return std::isfinite(temperatureC) ? temperatureC - kReferenceTemperature : 0.0f;
+    }
+}
+
+GyroBiasModel &GyroBiasModel::getInstance()
+{
+    static GyroBiasModel instance;
+    return instance;
+}
+
+void GyroBiasModel::resetWindow()
+{
+    windowCount = 0;
+    windowT = 0.0f;
+    windowAccel = 0.0f;
+    windowAccel2 = 0.0f;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        windowGyro[axis] = 0.0f;
+        windowGyro2[axis] = 0.0f;
+    }
+}
+
+void GyroBiasModel::observe(const MotionSensor::Frame &raw, float temperatureC)
+{
+    const unsigned long now = millis();
+    if (windowCount > 0 && now - windowLastMs > kMaxFrameGapMs)
+    {
+        resetWindow();
+    }
+    if (windowCount == 0)
+    {
+        windowStartMs = now;
+    }
+    windowLastMs = now;
+
+    const float gyro[3] = {raw.gyroX, raw.gyroY, raw.gyroZ};
+    const float accel = sqrtf(raw.x * raw.x + raw.y * raw.y + raw.z * raw.z);
+    windowT += relativeTemperature(temperatureC);
+    windowAccel += accel;
+    windowAccel2 += accel * accel;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        windowGyro[axis] += gyro[axis];
+        windowGyro2[axis] += gyro[axis] * gyro[axis];
+    }
+    windowCount++;
+
+    if (now - windowStartMs < GYRO_BIAS_WINDOW_MS || windowCount < kMinWindowFrames)
+    {
+        return;
+    }
+
+    // Variance = E[X^2] - E[X]^2 over the window
+    const float invCount = 1.0f / windowCount;
+    const float accelMean = windowAccel * invCount;
+    bool still = accelMean > kStillAccelMin && accelMean < kStillAccelMax &&
+                 windowAccel2 * invCount - accelMean * accelMean < kStillAccelStd * kStillAccelStd;
+
+    const float temperature = windowT * invCount;
+    float bias[3];
+    for (int axis = 0; axis < 3 && still; axis++)
+    {
+        bias[axis] = windowGyro[axis] * invCount;
+        const float variance = windowGyro2[axis] * invCount - bias[axis] * bias[axis];
+        still = variance < GYRO_BIAS_STILL_STD * GYRO_BIAS_STILL_STD && fabsf(bias[axis]) < GYRO_BIAS_MAX &&
+                (!ready || fabsf(bias[axis] - predict(axis, temperature)) < GYRO_BIAS_MAX_STEP);
+    }
+
+    if (still)
+    {
+        addObservation(temperature, bias);
+    }
+    resetWindow();
+}
+
+void GyroBiasModel::addObservation(float temperature, const float bias[3])
+{
+    {
+        std::lock_guard<std::mutex> lock(sumsMutex);
+        sums.weight = sums.weight * GYRO_BIAS_FORGET + 1.0f;
+        sums.sumT = sums.sumT * GYRO_BIAS_FORGET + temperature;
+        sums.sumT2 = sums.sumT2 * GYRO_BIAS_FORGET + temperature * temperature;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            sums.sumB[axis] = sums.sumB[axis] * GYRO_BIAS_FORGET + bias[axis];
+            sums.sumTB[axis] = sums.sumTB[axis] * GYRO_BIAS_FORGET + temperature * bias[axis];
+        }
+    }
+    fit();
+    dirty.store(true);
+}
+
+// Caller must not hold sumsMutex
+void GyroBiasModel::fit()
+{
+    std::lock_guard<std::mutex> lock(sumsMutex);
+    if (sums.weight <= 0.0f)
+    {
+        ready = false;
+        return;
+    }
+
+    const float invWeight = 1.0f / sums.weight;
+    const float tMean = sums.sumT * invWeight;
+    const float tVariance = std::max(0.0f, sums.sumT2 * invWeight - tMean * tMean);
+    // Fixed penalty on the unnormalized sums: it fades as still time accumulates
+    const float ridge = kSlopeRidge * invWeight;
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        const float bMean = sums.sumB[axis] * invWeight;
+        const float covariance = sums.sumTB[axis] * invWeight - tMean * bMean;
+        slope[axis] = covariance / (tVariance + ridge);
+        offset[axis] = bMean;
+    }
+    meanT = tMean;
+    ready = true;
+}
+
+float GyroBiasModel::predict(int axis, float temperature) const
+{
+    return offset[axis] + slope[axis] * (temperature - meanT);
+}
+
+void GyroBiasModel::apply(MotionSensor::Frame &frame, float temperatureC) const
+{
+    if (!ready)
+    {
+        return;
+    }
+    const float temperature = relativeTemperature(temperatureC);
+    frame.gyroX -= predict(0, temperature);
+    frame.gyroY -= predict(1, temperature);
+    frame.gyroZ -= predict(2, temperature);
+}
+
+bool GyroBiasModel::load()
+{
+    File file = LittleFS.open(GYRO_BIAS_MODEL_PATH, "r");
+    if (!file)
+    {
+        Logger::getInstance().log("Gyro bias model: none saved yet, learning while still");
+        return false;
+    }
+
+    uint8_t header[8];
+    Sums loaded;
+    const bool valid = file.read(header, sizeof(header)) == sizeof(header) &&
+                       memcmp(header, BIAS_MAGIC, sizeof(BIAS_MAGIC)) == 0 && header[4] == BIAS_VERSION &&
+                       file.read(reinterpret_cast<uint8_t *>(&loaded), sizeof(loaded)) == sizeof(loaded) &&
+                       std::isfinite(loaded.weight) && loaded.weight > 0.0f;
+    file.close();
+
+    if (!valid)
+    {
+        Logger::getInstance().log("Gyro bias model: " + String(GYRO_BIAS_MODEL_PATH) + " invalid, ignored");
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sumsMutex);
+        sums = loaded;
+    }
+    fit();
+    lastSavedT = meanT;
+
+    Logger::getInstance().log("Gyro bias model: offset [" + String(offset[0], 4) + "," + String(offset[1], 4) + "," +
+                              String(offset[2], 4) + "] rad/s, slope [" + String(slope[0], 5) + "," +
+                              String(slope[1], 5) + "," + String(slope[2], 5) + "] rad/s/degC at " +
+                              String(meanT + kReferenceTemperature, 1) + " degC");
+    return true;
+}
+
+void GyroBiasModel::service()
+{
+    if (!dirty.load())
+    {
+        return;
+    }
+
+    Sums snapshot;
+    {
+        std::lock_guard<std::mutex> lock(sumsMutex);
+        snapshot = sums;
+    }
+
+    const float temperature = snapshot.sumT / snapshot.weight;
+    const bool drifted = fabsf(temperature - lastSavedT) > kResaveTemperatureDelta;
+    if (!drifted && lastSaveMs != 0 && millis() - lastSaveMs < GYRO_BIAS_SAVE_INTERVAL_MS)
+    {
+        return;
+    }
+
+    dirty.store(false);
+    lastSaveMs = millis();
+    lastSavedT = temperature;
+    save(snapshot);
+}
+
+bool GyroBiasModel::save(const Sums &snapshot)
+{
+    File file = LittleFS.open(GYRO_BIAS_MODEL_PATH, "w");
+    if (!file)
+    {
+        Logger::getInstance().log("Gyro bias model: cannot open " + String(GYRO_BIAS_MODEL_PATH));
+        return false;
+    }
+
+    uint8_t header[8] = {0};
+    memcpy(header, BIAS_MAGIC, sizeof(BIAS_MAGIC));
+    header[4] = BIAS_VERSION;
+    const bool written = file.write(header, sizeof(header)) == sizeof(header) &&
+                         file.write(reinterpret_cast<const uint8_t *>(&snapshot), sizeof(snapshot)) == sizeof(snapshot);
+    file.close();
+
+    if (!written)
+    {
+        Logger::getInstance().log("Gyro bias model: write failed (filesystem full?)");
+        return false;
+    }
+    Logger::getInstance().log("Gyro bias model saved (" + String(snapshot.weight, 1) + " still windows)");
+    return true;
+}
@@ -0,0 +1,121 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Gyro bias versus temperature, learned while the device is still.
+ */
+
+#ifndef GYRO_BIAS_MODEL_H
+#define GYRO_BIAS_MODEL_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <mutex>
+#include "MotionSensor.h"
+
+#ifndef GYRO_BIAS_MODEL_PATH
+    #define GYRO_BIAS_MODEL_PATH "/gyro_bias.bin"
+#endif
+
+#ifndef GYRO_BIAS_WINDOW_MS
+    #define GYRO_BIAS_WINDOW_MS 1000 // Still time averaged into one observation
+#endif
+
+#ifndef GYRO_BIAS_STILL_STD
+    #define GYRO_BIAS_STILL_STD 0.02f // rad/s per axis; hand tremor is well above, sensor noise well below
+#endif
+
+#ifndef GYRO_BIAS_MAX
+    #define GYRO_BIAS_MAX 0.35f // rad/s (20 deg/s, MPU6050 zero-rate spec); above it the device is turning
+#endif
+
+#ifndef GYRO_BIAS_MAX_STEP
+    #define GYRO_BIAS_MAX_STEP 0.05f // rad/s (3 deg/s) per axis from the current estimate; a slow turn is further
+#endif
+
+#ifndef GYRO_BIAS_FORGET
+    #define GYRO_BIAS_FORGET 0.998f // Weight kept by past observations at each new one
+#endif
+
+#ifndef GYRO_BIAS_SAVE_INTERVAL_MS
+    #define GYRO_BIAS_SAVE_INTERVAL_MS 300000UL
+#endif
+
+/**
+ * @brief Per-axis linear model bias = offset + slope * (T - T0).
+ *
+ * The sampling task feeds raw frames to observe(): every captured frame,
+ * and in standby one short window every GYRO_BIAS_IDLE_INTERVAL_MS, the
+ * only frames that are usually still. One second of frames with a quiet
+ * gyro and about 1 g on the accelerometer becomes an observation (mean
+ * temperature, mean gyro) added to exponentially forgotten least-squares
+ * sums. Once the model is ready, a window whose
+ * mean is more than GYRO_BIAS_MAX_STEP from the predicted bias is a slow
+ * steady turn, not drift, and is dropped. The slope is ridge-regularized towards
+ * zero, so until the device has been seen still over a few degrees the
+ * model is a plain offset. apply() subtracts the predicted bias before
+ * the frame is stored or published, so fusion only sees the residual.
+ *
+ * The sums are kept in GYRO_BIAS_MODEL_PATH and loaded at boot: the
+ * model keeps improving across restarts instead of starting from zero.
+ * File format (little endian): "MPGB", version byte, 3 reserved bytes,
+ * float weight, float sumT, float sumT2, then per axis float sumB and
+ * float sumTB, temperatures relative to T0 = 25 degC.
+ */
+class GyroBiasModel
+{
+public:
+    static GyroBiasModel &getInstance();
+
+    bool load(); // Boot, before the sampling task starts
+
+    // Sampling task
+    void observe(const MotionSensor::Frame &raw, float temperatureC);
+    void apply(MotionSensor::Frame &frame, float temperatureC) const;
+
+    // Background task: writes the sums when they changed and GYRO_BIAS_SAVE_INTERVAL_MS passed
+    void service();
+
+    bool isReady() const { return ready; }
+
+private:
+    struct Sums
+    {
+        float weight;
+        float sumT;
+        float sumT2;
+        float sumB[3];
+        float sumTB[3];
+    };
+
+    GyroBiasModel() {}
+
+    void resetWindow();
+    float predict(int axis, float temperature) const; // Relative temperature, model ready
+    void addObservation(float temperature, const float bias[3]);
+    void fit();
+    bool save(const Sums &snapshot);
+
+    // Window of still frames, sampling task only
+    uint16_t windowCount = 0;
+    unsigned long windowStartMs = 0;
+    unsigned long windowLastMs = 0;
+    float windowT = 0.0f;
+    float windowGyro[3] = {0.0f, 0.0f, 0.0f};
+    float windowGyro2[3] = {0.0f, 0.0f, 0.0f};
+    float windowAccel = 0.0f;
+    float windowAccel2 = 0.0f;
+
+    // Fitted model, written and read by the sampling task
+    bool ready = false;
+    float meanT = 0.0f;
+    float offset[3] = {0.0f, 0.0f, 0.0f};
+    float slope[3] = {0.0f, 0.0f, 0.0f};
+
+    std::mutex sumsMutex; // Sums are copied by service()
+    Sums sums = {};
+    std::atomic<bool> dirty{false};
+    unsigned long lastSaveMs = 0;
+    float lastSavedT = 0.0f;
+};
+
+#endif // GYRO_BIAS_MODEL_H
@@ -0,0 +1,35 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Interface for gesture recognizers plugged into GestureAnalyze.
+ */
+
+#ifndef I_GESTURE_RECOGNIZER_H
+#define I_GESTURE_RECOGNIZER_H
+
+#include "SampleBuffer.h"
+#include "SimpleGestureDetector.h"
+
+/**
+ * A recognizer turns a finished capture into a GestureRecognitionResult.
+ * GestureAnalyze asks it first and falls back to the threshold rules of
+ * detectSimpleGesture when it is not ready or finds nothing. A result
+ * with rejected set ends the chain: the capture is not a gesture.
+ *
+ * Called on the input task once per capture; implementations must not
+ * block on the filesystem there.
+ */
+class IGestureRecognizer
+{
+public:
+    virtual ~IGestureRecognizer() {}
+
+    virtual const char *name() const = 0;
+
+    // False while there is nothing to match against (no templates, no model)
+    virtual bool isReady() const = 0;
+
+    virtual GestureRecognitionResult recognize(const SampleBuffer &buffer) = 0;
+};
+
+#endif // I_GESTURE_RECOGNIZER_H
@@ -0,0 +1,81 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Latest IMU frame shared lock-free between the sampling task and readers.
+ */
+
+#ifndef IMU_SNAPSHOT_H
+#define IMU_SNAPSHOT_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "MotionSensor.h"
+
+struct ImuFrame
+{
+    MotionSensor::Frame axes; // Mapped axes, g and rad/s
+    bool gyroValid;
+    uint32_t timestampUs;     // micros() when the frame was read
+    uint32_t sequence;        // Publish count: unchanged means no new data
+};
+
+/**
+ * @brief Single-writer, multi-reader latest-frame snapshot.
+ *
+ * Sequence lock over two slots: publish k writes slot k & 1, so the slot
+ * holding the latest frame is never the one being written. The sequence
+ * is odd while a write is in progress. A reader only retries if the
+ * writer completed a whole publish and started the next one into the
+ * slot being copied, which at IMU rates practically never happens. The
+ * writer never waits.
+ */
+class ImuSnapshot
+{
+public:
+    // Sampling task only
+    void publish(const MotionSensor::Frame &axes, bool gyroValid, uint32_t timestampUs)
+    {
+        const uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+        const uint32_t published = (sequence >> 1) + 1;
+        _sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        ImuFrame &slot = _slots[published & 1];
+        slot.axes = axes;
+        slot.gyroValid = gyroValid;
+        slot.timestampUs = timestampUs;
+        slot.sequence = published;
+
+        _sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Any task; false until the first frame is published
+    bool read(ImuFrame &out) const
+    {
+        for (;;)
+        {
+            const uint32_t before = _sequence.load(std::memory_order_acquire);
+            const uint32_t published = before >> 1;
+            if (published == 0)
+            {
+                return false;
+            }
+
+            out = _slots[published & 1];
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // Slot published & 1 is rewritten from sequence 2 * published + 3 on
+            const uint32_t after = _sequence.load(std::memory_order_relaxed);
+            if (after - (before & ~1u) < 3)
+            {
+                return true;
+            }
+        }
+    }
+
+private:
+    std::atomic<uint32_t> _sequence{0};
+    ImuFrame _slots[2] = {};
+};
+
+#endif // IMU_SNAPSHOT_H
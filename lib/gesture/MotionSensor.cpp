@@ -33,6 +33,23 @@ public:
     virtual float readTemperatureC() const { return 0.0f; }
     virtual bool setSampleRate(uint16_t hz, bool lowPower) = 0;
     virtual bool setRange(float g) = 0;
+    virtual uint16_t outputDataRateHz(uint16_t hz) const { return hz; }
+    virtual bool enableFifo(bool enable)
+    {
+        (void)enable;
+        return false;
+    }
+    virtual size_t readFifo(MotionSensor::Frame *frames, size_t maxFrames)
+    {
+        (void)frames;
+        (void)maxFrames;
+        return 0;
+    }
+    virtual bool enableDataReadyInterrupt(bool enable)
+    {
+        (void)enable;
+        return false;
+    }
     virtual bool configureMotionWakeup(uint8_t threshold, uint8_t duration, uint8_t highPassCode, uint8_t cycleRateCode)
     {
         (void)threshold;
@@ -178,12 +195,163 @@ namespace
     constexpr uint8_t MPU6050_REG_ACCEL_XOUT_H = 0x3B;
     constexpr uint8_t MPU6050_INT_MOTION_BIT = 0x40;
     constexpr uint8_t MPU6050_INT_DATA_RDY_BIT = 0x01;
+    constexpr uint8_t MPU6050_REG_TEMP_OUT_H = 0x41;
+    constexpr uint8_t MPU6050_REG_FIFO_EN = 0x23;
+    constexpr uint8_t MPU6050_REG_USER_CTRL = 0x6A;
+    constexpr uint8_t MPU6050_REG_FIFO_COUNTH = 0x72;
+    constexpr uint8_t MPU6050_REG_FIFO_R_W = 0x74;
+    constexpr uint8_t MPU6050_FIFO_EN_ACCEL_GYRO = 0x78; // XG, YG, ZG, ACCEL
+    constexpr uint8_t MPU6050_USER_CTRL_FIFO_EN = 0x40;
+    constexpr uint8_t MPU6050_USER_CTRL_FIFO_RESET = 0x04;
+    constexpr uint16_t MPU6050_FIFO_SIZE = 1024;
+    constexpr uint8_t MPU6050_FIFO_FRAME_BYTES = 12; // accel XYZ then gyro XYZ, big endian
+    constexpr uint8_t MPU6050_INT_PIN_CFG_DATA_READY = 0xF0; // Active low, open drain, latched, cleared by any read
+
+    constexpr uint8_t ADXL345_REG_INT_ENABLE = 0x2E;
+    constexpr uint8_t ADXL345_REG_INT_MAP = 0x2F;
+    constexpr uint8_t ADXL345_REG_DATA_FORMAT = 0x31;
+    constexpr uint8_t ADXL345_INT_DATA_READY_BIT = 0x80;
+    constexpr uint8_t ADXL345_DATA_FORMAT_INT_INVERT = 0x20; // INT pins active low
+
+    // Sample rate = 1 kHz gyro output rate (DLPF on) / (1 + divisor)
+    uint8_t mpu6050RateDivisor(uint16_t hz)
+    {
+        uint16_t effectiveHz = std::max<uint16_t>(5, clampSampleRateImpl(hz));
+        return static_cast<uint8_t>(std::max<uint16_t>(1, 1000 / effectiveHz) - 1);
+    }
+
+    uint16_t mpu6050OutputRate(uint16_t hz)
+    {
+        return 1000 / (mpu6050RateDivisor(hz) + 1);
+    }
+
+    bool mpu6050ResetFifo(TwoWire *wire, uint8_t address)
+    {
+        return modifyRegister(wire, address, MPU6050_REG_USER_CTRL,
+                              MPU6050_USER_CTRL_FIFO_EN | MPU6050_USER_CTRL_FIFO_RESET,
+                              MPU6050_USER_CTRL_FIFO_RESET) &&
+               modifyRegister(wire, address, MPU6050_REG_USER_CTRL,
+                              MPU6050_USER_CTRL_FIFO_EN, MPU6050_USER_CTRL_FIFO_EN);
+    }
+
+    bool mpu6050EnableFifo(TwoWire *wire, uint8_t address, bool enable)
+    {
+        if (!enable)
+        {
+            return modifyRegister(wire, address, MPU6050_REG_USER_CTRL, MPU6050_USER_CTRL_FIFO_EN, 0x00) &&
+                   writeRegister(wire, address, MPU6050_REG_FIFO_EN, 0x00);
+        }
+        return writeRegister(wire, address, MPU6050_REG_FIFO_EN, MPU6050_FIFO_EN_ACCEL_GYRO) &&
+               mpu6050ResetFifo(wire, address);
+    }
+
+    bool mpu6050ReadTemperature(TwoWire *wire, uint8_t address, float &temperatureC)
+    {
+        uint8_t data[2] = {0};
+        if (!readRegisters(wire, address, MPU6050_REG_TEMP_OUT_H, data, sizeof(data)))
+        {
+            return false;
+        }
+        int16_t raw = static_cast<int16_t>((data[0] << 8) | data[1]);
+        temperatureC = (static_cast<float>(raw) / 340.0f) + 36.53f;
+        return true;
+    }
+
+    // Interrupt registers saved while DATA_READY owns the INT pin
+    struct Mpu6050InterruptState
+    {
+        uint8_t pinConfig = 0;
+        uint8_t enable = 0;
+        bool saved = false;
+    };
+
+    bool mpu6050EnableDataReady(TwoWire *wire, uint8_t address, bool enable, Mpu6050InterruptState &state)
+    {
+        if (!enable)
+        {
+            if (!state.saved)
+            {
+                return true;
+            }
+            state.saved = false;
+            return writeRegister(wire, address, MPU6050_REG_INT_ENABLE, state.enable) &&
+                   writeRegister(wire, address, MPU6050_REG_INT_PIN_CFG, state.pinConfig);
+        }
+
+        if (!state.saved)
+        {
+            if (!readRegister(wire, address, MPU6050_REG_INT_PIN_CFG, state.pinConfig) ||
+                !readRegister(wire, address, MPU6050_REG_INT_ENABLE, state.enable))
+            {
+                return false;
+            }
+            state.saved = true;
+        }
+
+        // Latched until the sample is read, so an edge cannot be lost between reads
+        uint8_t pinConfig = static_cast<uint8_t>((state.pinConfig & 0x0F) | MPU6050_INT_PIN_CFG_DATA_READY);
+        uint8_t status = 0;
+        return writeRegister(wire, address, MPU6050_REG_INT_PIN_CFG, pinConfig) &&
+               writeRegister(wire, address, MPU6050_REG_INT_ENABLE, MPU6050_INT_DATA_RDY_BIT) &&
+               readRegister(wire, address, MPU6050_REG_INT_STATUS, status);
+    }
+
+    // Drain whole frames from the FIFO; a partial or overflowed FIFO is reset
+    // because frame alignment can no longer be trusted
+    size_t mpu6050ReadFifo(TwoWire *wire, uint8_t address, MotionSensor::Frame *frames, size_t maxFrames,
+                           float accelLsbPerG, float gyroLsbPerDps)
+    {
+        uint8_t countData[2] = {0};
+        if (!readRegisters(wire, address, MPU6050_REG_FIFO_COUNTH, countData, sizeof(countData)))
+        {
+            return 0;
+        }
+
+        uint16_t available = static_cast<uint16_t>((countData[0] << 8) | countData[1]);
+        if (available > MPU6050_FIFO_SIZE - MPU6050_FIFO_FRAME_BYTES)
+        {
+            Logger::getInstance().log("MPU6050 FIFO overflow, " + String(available / MPU6050_FIFO_FRAME_BYTES) +
+                                      " frames discarded");
+            mpu6050ResetFifo(wire, address);
+            return 0;
+        }
+
+        const size_t frameCount = std::min<size_t>(available / MPU6050_FIFO_FRAME_BYTES, maxFrames);
+        const float gyroScale = DEG_TO_RAD / gyroLsbPerDps;
+        uint8_t burst[MOTION_FIFO_BURST_FRAMES * MPU6050_FIFO_FRAME_BYTES];
+        size_t done = 0;
+
+        while (done < frameCount)
+        {
+            const size_t chunk = std::min<size_t>(frameCount - done, MOTION_FIFO_BURST_FRAMES);
+            if (!readRegisters(wire, address, MPU6050_REG_FIFO_R_W, burst, chunk * MPU6050_FIFO_FRAME_BYTES))
+            {
+                mpu6050ResetFifo(wire, address);
+                break;
+            }
+
+            for (size_t i = 0; i < chunk; ++i)
+            {
+                const uint8_t *data = burst + i * MPU6050_FIFO_FRAME_BYTES;
+                MotionSensor::Frame &frame = frames[done + i];
+                frame.x = static_cast<int16_t>((data[0] << 8) | data[1]) / accelLsbPerG;
+                frame.y = static_cast<int16_t>((data[2] << 8) | data[3]) / accelLsbPerG;
+                frame.z = static_cast<int16_t>((data[4] << 8) | data[5]) / accelLsbPerG;
+                frame.gyroX = static_cast<int16_t>((data[6] << 8) | data[7]) * gyroScale;
+                frame.gyroY = static_cast<int16_t>((data[8] << 8) | data[9]) * gyroScale;
+                frame.gyroZ = static_cast<int16_t>((data[10] << 8) | data[11]) * gyroScale;
+            }
+            done += chunk;
+        }
+        return done;
+    }
 
     class ADXL345Driver final : public AccelerometerDriver
     {
     public:
         ADXL345Driver(TwoWire *wire, uint8_t address, const String &axisMap, const String &axisDir)
-            : _address(address ? address : ADXL345_ALT),
+            : _wire(wire),
+              _address(address ? address : ADXL345_ALT),
               _sensor(_address, wire),
               _axisMap("xyz"),
               _axisDir("+++")
@@ -287,6 +455,21 @@ namespace
             return _sensor.writeRange(rangeCode);
         }
 
+        bool enableDataReadyInterrupt(bool enable) override
+        {
+            if (!enable)
+            {
+                return modifyRegister(_wire, _address, ADXL345_REG_INT_ENABLE, ADXL345_INT_DATA_READY_BIT, 0x00) &&
+                       modifyRegister(_wire, _address, ADXL345_REG_DATA_FORMAT, ADXL345_DATA_FORMAT_INT_INVERT, 0x00);
+            }
+            // DATA_READY on INT1, active low; cleared when update() reads the data registers
+            return modifyRegister(_wire, _address, ADXL345_REG_INT_MAP, ADXL345_INT_DATA_READY_BIT, 0x00) &&
+                   modifyRegister(_wire, _address, ADXL345_REG_DATA_FORMAT, ADXL345_DATA_FORMAT_INT_INVERT,
+                                  ADXL345_DATA_FORMAT_INT_INVERT) &&
+                   modifyRegister(_wire, _address, ADXL345_REG_INT_ENABLE, ADXL345_INT_DATA_READY_BIT,
+                                  ADXL345_INT_DATA_READY_BIT);
+        }
+
     private:
         void applyAxisMapping(const String &axisMap, const String &axisDir)
         {
@@ -370,6 +553,7 @@ namespace
             return value;
         }
 
+        TwoWire *_wire;
         uint8_t _address;
         mutable ADXL345 _sensor;
         String _axisMap;
@@ -492,10 +676,7 @@ namespace
         bool setSampleRate(uint16_t hz, bool lowPower) override
         {
             hz = clampSampleRateImpl(hz);
-
-            uint16_t effectiveHz = std::max<uint16_t>(5, hz);
-            uint8_t divisor = static_cast<uint8_t>(std::max<uint16_t>(1, 1000 / effectiveHz) - 1);
-            _sensor.setSampleRateDivisor(divisor);
+            _sensor.setSampleRateDivisor(mpu6050RateDivisor(hz));
 
             if (lowPower)
             {
@@ -549,6 +730,41 @@ namespace
             }
             return true;
         }
+        uint16_t outputDataRateHz(uint16_t hz) const override
+        {
+            return mpu6050OutputRate(hz);
+        }
+
+        bool enableFifo(bool enable) override
+        {
+            if (enable)
+            {
+                // Full-scale ranges may have changed since the last capture
+                _fifoAccelLsbPerG = 16384.0f / (1 << static_cast<uint8_t>(_sensor.getAccelerometerRange()));
+                _fifoGyroLsbPerDps = 131.0f / (1 << static_cast<uint8_t>(_sensor.getGyroRange()));
+            }
+            return mpu6050EnableFifo(_wire, _address, enable);
+        }
+
+        bool enableDataReadyInterrupt(bool enable) override
+        {
+            return mpu6050EnableDataReady(_wire, _address, enable, _interruptState);
+        }
+
+        size_t readFifo(MotionSensor::Frame *frames, size_t maxFrames) override
+        {
+            size_t count = mpu6050ReadFifo(_wire, _address, frames, maxFrames, _fifoAccelLsbPerG, _fifoGyroLsbPerDps);
+            if (count > 0)
+            {
+                float temperatureC = 0.0f;
+                if (mpu6050ReadTemperature(_wire, _address, temperatureC))
+                {
+                    _tempEvent.temperature = temperatureC;
+                }
+            }
+            return count;
+        }
+
         bool configureMotionWakeup(uint8_t threshold, uint8_t duration, uint8_t highPassCode, uint8_t cycleRateCode) override
         {
             if (highPassCode > static_cast<uint8_t>(MPU6050_HIGHPASS_HOLD))
@@ -620,6 +836,9 @@ namespace
         bool _hasTemp;
         bool _motionWakeEnabled;
         uint8_t _motionWakeCycleCode;
+        float _fifoAccelLsbPerG = 16384.0f;
+        float _fifoGyroLsbPerDps = 131.0f;
+        Mpu6050InterruptState _interruptState;
     };
 
     class MPU6050CloneDriver final : public AccelerometerDriver
@@ -792,11 +1011,7 @@ namespace
             hz = clampSampleRateImpl(hz);
             _sampleRate = hz;
 
-            uint16_t effectiveHz = std::max<uint16_t>(5, hz);
-            uint16_t divisorBase = 1000;
-            uint8_t divisor = static_cast<uint8_t>(std::max<uint16_t>(1, divisorBase / effectiveHz) - 1);
-
-            if (!writeRegister(_wire, _address, MPU6050_REG_SMPLRT_DIV, divisor))
+            if (!writeRegister(_wire, _address, MPU6050_REG_SMPLRT_DIV, mpu6050RateDivisor(hz)))
             {
                 return false;
             }
@@ -893,6 +1108,32 @@ namespace
             return true;
         }
 
+        uint16_t outputDataRateHz(uint16_t hz) const override
+        {
+            return mpu6050OutputRate(hz);
+        }
+
+        bool enableFifo(bool enable) override
+        {
+            return mpu6050EnableFifo(_wire, _address, enable);
+        }
+
+        bool enableDataReadyInterrupt(bool enable) override
+        {
+            return mpu6050EnableDataReady(_wire, _address, enable, _interruptState);
+        }
+
+        size_t readFifo(MotionSensor::Frame *frames, size_t maxFrames) override
+        {
+            constexpr float gyroLsbPerDps = 131.0f; // +/-250 deg/s, as in update()
+            size_t count = mpu6050ReadFifo(_wire, _address, frames, maxFrames, _scale, gyroLsbPerDps);
+            if (count > 0)
+            {
+                _hasTemperature = mpu6050ReadTemperature(_wire, _address, _temperatureC);
+            }
+            return count;
+        }
+
         bool configureMotionWakeup(uint8_t threshold, uint8_t duration, uint8_t highPassCode, uint8_t cycleRateCode) override
         {
             (void)cycleRateCode; // clone driver ignores cycle rate hints
@@ -1074,6 +1315,7 @@ namespace
         uint8_t _motionWakeDuration;
         uint8_t _motionWakeCycleCode;
         uint8_t _motionWakeHighPassCode;
+        Mpu6050InterruptState _interruptState;
     };
 
     std::unique_ptr<AccelerometerDriver> createDriver(const AccelerometerConfig &config, TwoWire *wire, bool useCloneDriver)
@@ -1220,7 +1462,9 @@ MotionSensor::MotionSensor(TwoWire *wire)
       _configLoaded(false),
       _expectGyro(false),
       _motionWakeEnabled(false),
-      _sampleHz(kDefaultSampleHz)
+      _sampleHz(kDefaultSampleHz),
+      _fifoActive(false),
+      _lastFrame{}
 {
 }
 
@@ -1320,6 +1564,15 @@ uint16_t MotionSensor::sampleRateHz() const
     return _sampleHz;
 }
 
+uint16_t MotionSensor::outputDataRateHz() const
+{
+    if (!_driver)
+    {
+        return _sampleHz;
+    }
+    return _driver->outputDataRateHz(_sampleHz);
+}
+
 bool MotionSensor::update()
 {
     if (!_driver)
@@ -1329,12 +1582,76 @@ bool MotionSensor::update()
     return _driver->update();
 }
 
+bool MotionSensor::startFifo()
+{
+    if (!_driver || _fifoActive)
+    {
+        return _fifoActive;
+    }
+
+    if (!_driver->enableFifo(true))
+    {
+        return false;
+    }
+
+    // Until the first drain the mapped accessors keep returning the last update()
+    _lastFrame.x = _driver->readX();
+    _lastFrame.y = _driver->readY();
+    _lastFrame.z = _driver->readZ();
+    _lastFrame.gyroX = _driver->readGyroX();
+    _lastFrame.gyroY = _driver->readGyroY();
+    _lastFrame.gyroZ = _driver->readGyroZ();
+    _fifoActive = true;
+    return true;
+}
+
+void MotionSensor::stopFifo()
+{
+    if (!_fifoActive)
+    {
+        return;
+    }
+    _fifoActive = false;
+    if (_driver)
+    {
+        _driver->enableFifo(false);
+    }
+}
+
+size_t MotionSensor::readFifo(Frame *frames, size_t maxFrames)
+{
+    if (!_driver || !_fifoActive || !frames || maxFrames == 0)
+    {
+        return 0;
+    }
+
+    size_t count = _driver->readFifo(frames, maxFrames);
+    if (count > 0)
+    {
+        _lastFrame = frames[count - 1];
+    }
+    return count;
+}
+
+bool MotionSensor::enableDataReadyInterrupt(bool enable)
+{
+    if (!_driver)
+    {
+        return false;
+    }
+    return _driver->enableDataReadyInterrupt(enable);
+}
+
 float MotionSensor::getMappedX() const
 {
     if (!_driver)
     {
         return 0.0f;
     }
+    if (_fifoActive)
+    {
+        return _lastFrame.x;
+    }
     return _driver->readX();
 }
 
@@ -1344,6 +1661,10 @@ float MotionSensor::getMappedY() const
     {
         return 0.0f;
     }
+    if (_fifoActive)
+    {
+        return _lastFrame.y;
+    }
     return _driver->readY();
 }
 
@@ -1353,6 +1674,10 @@ float MotionSensor::getMappedZ() const
     {
         return 0.0f;
     }
+    if (_fifoActive)
+    {
+        return _lastFrame.z;
+    }
     return _driver->readZ();
 }
 
@@ -1372,6 +1697,13 @@ void MotionSensor::getMappedGyro(float &x, float &y, float &z) const
     }
     // Gyro values are NOT mapped - gyroscope measures angular velocity
     // in the sensor's physical reference frame
+    if (_fifoActive)
+    {
+        x = _lastFrame.gyroX;
+        y = _lastFrame.gyroY;
+        z = _lastFrame.gyroZ;
+        return;
+    }
     x = _driver->readGyroX();
     y = _driver->readGyroY();
     z = _driver->readGyroZ();
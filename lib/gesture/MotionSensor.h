@@ -7,6 +7,10 @@
 
 #include "configTypes.h"
 
+#ifndef MOTION_FIFO_BURST_FRAMES
+    #define MOTION_FIFO_BURST_FRAMES 10 // FIFO frames per I2C read (12 bytes each, Wire buffer is 128)
+#endif
+
 class AccelerometerDriver;
 
 class MotionSensor
@@ -16,6 +20,17 @@ public:
     static constexpr uint16_t kDefaultSampleHz = 100;
     static constexpr uint16_t kLowPowerSampleHz = 12;
 
+    // One accelerometer + gyro sample as drained from the hardware FIFO
+    struct Frame
+    {
+        float x; // g
+        float y;
+        float z;
+        float gyroX; // rad/s
+        float gyroY;
+        float gyroZ;
+    };
+
     explicit MotionSensor(TwoWire *wire = &Wire);
     ~MotionSensor();
 
@@ -28,9 +43,31 @@ public:
     bool setSampleRate(uint16_t hz, bool lowPower);
     bool setRange(float g);
     uint16_t sampleRateHz() const;
+    uint16_t outputDataRateHz() const; // Rate actually produced for sampleRateHz() (divider rounding)
 
     bool update();
 
+    /**
+     * @brief Hardware FIFO (MPU6050 only).
+     *
+     * startFifo() resets and enables the FIFO; readFifo() drains up to
+     * maxFrames frames in I2C bursts of MOTION_FIFO_BURST_FRAMES, oldest
+     * first, one frame per ODR period. While the FIFO is active the mapped
+     * accessors return the last drained frame.
+     */
+    bool startFifo();
+    void stopFifo();
+    bool isFifoActive() const { return _fifoActive; }
+    size_t readFifo(Frame *frames, size_t maxFrames);
+
+    /**
+     * @brief Drive the INT pin on every new sample (active low, cleared by the data read).
+     *
+     * Only DATA_READY is routed to INT while enabled; disabling restores the
+     * interrupt configuration used for motion wake.
+     */
+    bool enableDataReadyInterrupt(bool enable);
+
     float getMappedX() const;
     float getMappedY() const;
     float getMappedZ() const;
@@ -61,6 +98,8 @@ private:
     bool _expectGyro;
     bool _motionWakeEnabled;
     uint16_t _sampleHz;
+    bool _fifoActive;
+    Frame _lastFrame;
     std::unique_ptr<AccelerometerDriver> _driver;
 };
 
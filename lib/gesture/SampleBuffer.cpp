@@ -0,0 +1,127 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Gesture capture buffer, shared by the sampler, the recognizers and the dataset tools.
+ */
+
+#include "SampleBuffer.h"
+#include <cmath>
+#include <cstring>
+#include <new>
+
+namespace
+{
+    constexpr uint8_t kSampleChannels = 7; // x, y, z, gyroX, gyroY, gyroZ, status
+
+    int16_t toCounts(float value, float scale)
+    {
+        float counts = roundf(value / scale);
+        if (!(counts > -32768.0f))
+        {
+            return -32768; // Also NaN
+        }
+        return counts > 32767.0f ? 32767 : static_cast<int16_t>(counts);
+    }
+} // namespace
+
+bool SampleBuffer::allocate(uint16_t samples)
+{
+    release();
+    int16_t *block = new (std::nothrow) int16_t[static_cast<size_t>(samples) * kSampleChannels];
+    if (!block)
+    {
+        return false;
+    }
+    x = block;
+    y = x + samples;
+    z = y + samples;
+    gyroX = z + samples;
+    gyroY = gyroX + samples;
+    gyroZ = gyroY + samples;
+    status = gyroZ + samples;
+    maxSamples = samples;
+    clear();
+    return true;
+}
+
+void SampleBuffer::release()
+{
+    delete[] x;
+    x = y = z = gyroX = gyroY = gyroZ = status = nullptr;
+    maxSamples = 0;
+    sampleCount = 0;
+    features.reset();
+}
+
+void SampleBuffer::clear()
+{
+    if (x)
+    {
+        memset(x, 0, static_cast<size_t>(maxSamples) * kSampleChannels * sizeof(int16_t));
+    }
+    sampleCount = 0;
+    features.reset();
+}
+
+Sample SampleBuffer::get(uint16_t i) const
+{
+    Sample sample;
+    sample.x = getX(i);
+    sample.y = getY(i);
+    sample.z = getZ(i);
+    sample.gyroX = getGyroX(i);
+    sample.gyroY = getGyroY(i);
+    sample.gyroZ = getGyroZ(i);
+    sample.gyroValid = gyroValid(i);
+    sample.temperatureValid = temperatureValid(i);
+    sample.temperature = temperature(i);
+    return sample;
+}
+
+Sample SampleBuffer::average(uint16_t begin, uint16_t end) const
+{
+    Sample sample;
+    int32_t sum[6] = {0, 0, 0, 0, 0, 0};
+    uint8_t flags = 0;
+    for (uint16_t i = begin; i < end; i++)
+    {
+        sum[0] += x[i];
+        sum[1] += y[i];
+        sum[2] += z[i];
+        sum[3] += gyroX[i];
+        sum[4] += gyroY[i];
+        sum[5] += gyroZ[i];
+        flags |= status[i];
+    }
+
+    const float count = end > begin ? static_cast<float>(end - begin) : 1.0f;
+    sample.x = sum[0] * accelScale / count;
+    sample.y = sum[1] * accelScale / count;
+    sample.z = sum[2] * accelScale / count;
+    sample.gyroX = sum[3] * gyroScale / count;
+    sample.gyroY = sum[4] * gyroScale / count;
+    sample.gyroZ = sum[5] * gyroScale / count;
+    sample.gyroValid = flags & SAMPLE_GYRO_VALID;
+    sample.temperatureValid = false;
+    sample.temperature = 0.0f;
+    return sample;
+}
+
+void SampleBuffer::set(uint16_t i, const Sample &sample)
+{
+    x[i] = toCounts(sample.x, accelScale);
+    y[i] = toCounts(sample.y, accelScale);
+    z[i] = toCounts(sample.z, accelScale);
+    gyroX[i] = sample.gyroValid ? toCounts(sample.gyroX, gyroScale) : 0;
+    gyroY[i] = sample.gyroValid ? toCounts(sample.gyroY, gyroScale) : 0;
+    gyroZ[i] = sample.gyroValid ? toCounts(sample.gyroZ, gyroScale) : 0;
+
+    int16_t temperatureCounts = 0;
+    if (sample.temperatureValid)
+    {
+        temperatureCounts = static_cast<int16_t>(constrain(roundf(sample.temperature * 8.0f), -8192.0f, 8191.0f));
+    }
+    status[i] = static_cast<int16_t>(temperatureCounts * 4) |
+                (sample.gyroValid ? SAMPLE_GYRO_VALID : 0) |
+                (sample.temperatureValid ? SAMPLE_TEMPERATURE_VALID : 0);
+}
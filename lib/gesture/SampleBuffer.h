@@ -0,0 +1,77 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Gesture capture buffer, shared by the sampler, the recognizers and the dataset tools.
+ */
+
+#ifndef SAMPLE_BUFFER_H
+#define SAMPLE_BUFFER_H
+
+#include <Arduino.h>
+#include "GestureFeatures.h"
+
+// Decoded view of one sample (calibrated accel in g, gyro in rad/s)
+struct Sample
+{
+    float x;
+    float y;
+    float z;
+    float gyroX;
+    float gyroY;
+    float gyroZ;
+    float temperature;
+    bool gyroValid;
+    bool temperatureValid;
+};
+
+/**
+ * @brief Capture buffer in int16 counts, one array per channel.
+ *
+ * 14 bytes per sample instead of the 32 of a Sample: six axes plus a
+ * status word packing the temperature (1/8 degC, bits 15..2) with the
+ * SAMPLE_* flags (bits 1..0). Scale factors are kept once per buffer;
+ * use the accessors rather than the raw arrays unless a loop needs a
+ * single channel.
+ */
+struct SampleBuffer
+{
+    static constexpr uint8_t SAMPLE_GYRO_VALID = 0x01;
+    static constexpr uint8_t SAMPLE_TEMPERATURE_VALID = 0x02;
+    static constexpr float kGyroFullScale = 1000.0f * DEG_TO_RAD; // rad/s, twice the widest MPU6050 range in use
+
+    int16_t *x = nullptr;
+    int16_t *y = nullptr;
+    int16_t *z = nullptr;
+    int16_t *gyroX = nullptr;
+    int16_t *gyroY = nullptr;
+    int16_t *gyroZ = nullptr;
+    int16_t *status = nullptr;
+    float accelScale = 8.0f / 32767.0f;          // g per count
+    float gyroScale = kGyroFullScale / 32767.0f; // rad/s per count
+    uint16_t sampleCount = 0;
+    uint16_t maxSamples = 0;
+    uint16_t sampleHZ = 0;
+    GestureFeatures features; // Folded in by GestureRead as samples are stored
+
+    bool allocate(uint16_t samples); // One block for every channel
+    void release();
+    void clear();
+    bool isAllocated() const { return x != nullptr; }
+    void setAccelRange(float g) { accelScale = (g > 0.0f ? g * 2.0f : 8.0f) / 32767.0f; } // Headroom for the offset
+
+    float getX(uint16_t i) const { return x[i] * accelScale; }
+    float getY(uint16_t i) const { return y[i] * accelScale; }
+    float getZ(uint16_t i) const { return z[i] * accelScale; }
+    float getGyroX(uint16_t i) const { return gyroX[i] * gyroScale; }
+    float getGyroY(uint16_t i) const { return gyroY[i] * gyroScale; }
+    float getGyroZ(uint16_t i) const { return gyroZ[i] * gyroScale; }
+    bool gyroValid(uint16_t i) const { return status[i] & SAMPLE_GYRO_VALID; }
+    bool temperatureValid(uint16_t i) const { return status[i] & SAMPLE_TEMPERATURE_VALID; }
+    float temperature(uint16_t i) const { return (status[i] >> 2) / 8.0f; }
+
+    Sample get(uint16_t i) const;
+    Sample average(uint16_t begin, uint16_t end) const; // Mean of samples [begin, end), gyroValid if any had gyro
+    void set(uint16_t i, const Sample &sample); // Values outside the int16 range saturate
+};
+
+#endif // SAMPLE_BUFFER_H
@@ -11,21 +11,6 @@
 
 namespace
 {
-    constexpr float kMinValidSampleMagnitude = 0.05f;  // Minimum accel magnitude to consider valid
-    constexpr float kGyroToDegPerSec = 57.2957795f;    // Convert rad/s to deg/s
-
-    bool isSampleValid(const Sample &sample)
-    {
-        return std::isfinite(sample.x) &&
-               std::isfinite(sample.y) &&
-               std::isfinite(sample.z);
-    }
-
-    float accelMagnitude(const Sample &sample)
-    {
-        return sqrtf(sample.x * sample.x + sample.y * sample.y + sample.z * sample.z);
-    }
-
     // Find axis with maximum range and return stats
     struct AxisAnalysis
     {
@@ -36,157 +21,46 @@ namespace
         bool crossedZero;   // For shake detection
     };
 
-    AxisAnalysis analyzeAccelAxis(const SampleBuffer *buffer)
+    AxisAnalysis analyzeAccelAxis(const GestureFeatures &features)
     {
         AxisAnalysis result = {-1, 0.0f, 0.0f, 0.0f, false};
 
-        if (!buffer || buffer->sampleCount < 3)
-            return result;
-
-        // Track min/max for each axis
-        float minVals[3] = {1e6f, 1e6f, 1e6f};
-        float maxVals[3] = {-1e6f, -1e6f, -1e6f};
-        bool hasPositive[3] = {false, false, false};
-        bool hasNegative[3] = {false, false, false};
-
-        for (uint16_t i = 0; i < buffer->sampleCount; i++)
-        {
-            const Sample &s = buffer->samples[i];
-            if (!isSampleValid(s) || accelMagnitude(s) < kMinValidSampleMagnitude)
-                continue;
-
-            float vals[3] = {s.x, s.y, s.z};
-            for (int axis = 0; axis < 3; axis++)
-            {
-                if (vals[axis] < minVals[axis]) minVals[axis] = vals[axis];
-                if (vals[axis] > maxVals[axis]) maxVals[axis] = vals[axis];
-                if (vals[axis] > 0.2f) hasPositive[axis] = true;
-                if (vals[axis] < -0.2f) hasNegative[axis] = true;
-            }
-        }
-
         // Find axis with maximum range
         for (int axis = 0; axis < 3; axis++)
         {
-            float range = maxVals[axis] - minVals[axis];
+            float range = features.accelMax[axis] - features.accelMin[axis];
             if (range > result.range)
             {
                 result.axis = axis;
-                result.min = minVals[axis];
-                result.max = maxVals[axis];
+                result.min = features.accelMin[axis];
+                result.max = features.accelMax[axis];
                 result.range = range;
-                result.crossedZero = hasPositive[axis] && hasNegative[axis];
+                result.crossedZero = features.accelPositive[axis] && features.accelNegative[axis];
             }
         }
 
         return result;
     }
 
-    // Count direction changes (zero crossings) for shake detection
-    int countDirectionChanges(const SampleBuffer *buffer, int axis)
-    {
-        if (!buffer || buffer->sampleCount < 3)
-            return 0;
-
-        int changes = 0;
-        bool wasPositive = false;
-        bool firstValid = true;
-        constexpr float kNoiseThreshold = 30.0f;  // deg/s - ignore small noise
-
-        for (uint16_t i = 0; i < buffer->sampleCount; i++)
-        {
-            const Sample &s = buffer->samples[i];
-            if (!s.gyroValid || !isSampleValid(s))
-                continue;
-
-            float vals[3] = {
-                s.gyroX * kGyroToDegPerSec,
-                s.gyroY * kGyroToDegPerSec,
-                s.gyroZ * kGyroToDegPerSec
-            };
-
-            // Ignore samples below noise threshold
-            if (fabsf(vals[axis]) < kNoiseThreshold)
-                continue;
-
-            bool isPositive = vals[axis] > 0.0f;
-
-            if (firstValid)
-            {
-                wasPositive = isPositive;
-                firstValid = false;
-            }
-            else if (isPositive != wasPositive)
-            {
-                changes++;
-                wasPositive = isPositive;
-            }
-        }
-
-        return changes;
-    }
-
-    AxisAnalysis analyzeGyroAxis(const SampleBuffer *buffer)
+    AxisAnalysis analyzeGyroAxis(const GestureFeatures &features)
     {
         AxisAnalysis result = {-1, 0.0f, 0.0f, 0.0f, false};
 
-        if (!buffer || buffer->sampleCount < 3)
-            return result;
-
-        // Track min/max gyro for each axis (in deg/s)
-        float minVals[3] = {1e6f, 1e6f, 1e6f};
-        float maxVals[3] = {-1e6f, -1e6f, -1e6f};
-        float peakVals[3] = {0.0f, 0.0f, 0.0f};  // Track absolute peak
-        float maxPositive[3] = {0.0f, 0.0f, 0.0f};  // Track max positive value
-        float maxNegative[3] = {0.0f, 0.0f, 0.0f};  // Track max negative value (abs)
-
-        uint16_t validSamples = 0;
-
-        for (uint16_t i = 0; i < buffer->sampleCount; i++)
-        {
-            const Sample &s = buffer->samples[i];
-            if (!s.gyroValid || !isSampleValid(s))
-                continue;
-
-            float vals[3] = {
-                s.gyroX * kGyroToDegPerSec,
-                s.gyroY * kGyroToDegPerSec,
-                s.gyroZ * kGyroToDegPerSec
-            };
-
-            for (int axis = 0; axis < 3; axis++)
-            {
-                if (vals[axis] < minVals[axis]) minVals[axis] = vals[axis];
-                if (vals[axis] > maxVals[axis]) maxVals[axis] = vals[axis];
-
-                float absVal = fabsf(vals[axis]);
-                if (absVal > peakVals[axis]) peakVals[axis] = absVal;
-
-                // Track peaks in each direction separately
-                if (vals[axis] > maxPositive[axis]) maxPositive[axis] = vals[axis];
-                if (vals[axis] < 0.0f && fabsf(vals[axis]) > maxNegative[axis])
-                    maxNegative[axis] = fabsf(vals[axis]);
-            }
-
-            validSamples++;
-        }
-
-        if (validSamples < 2)
+        if (features.gyroSamples < 2)
             return result;
 
         // Find axis with maximum peak velocity
         for (int axis = 0; axis < 3; axis++)
         {
-            if (peakVals[axis] > result.range)
+            if (features.gyroPeak[axis] > result.range)
             {
                 result.axis = axis;
-                result.min = minVals[axis];
-                result.max = maxVals[axis];
-                result.range = peakVals[axis];  // Store peak as "range"
+                result.min = features.gyroMin[axis];
+                result.max = features.gyroMax[axis];
+                result.range = features.gyroPeak[axis];  // Store peak as "range"
 
                 // For shake: require at least 3 direction changes (not just 2 peaks)
-                int dirChanges = countDirectionChanges(buffer, axis);
-                result.crossedZero = (dirChanges >= 3);
+                result.crossedZero = (features.directionChanges[axis] >= 3);
             }
         }
 
@@ -210,32 +84,26 @@ GestureRecognitionResult detectSimpleGesture(SampleBuffer *buffer, const SimpleG
     GestureRecognitionResult result;
     result.sensorMode = config.sensorMode;
 
-    if (!buffer || buffer->sampleCount < 3 || buffer->samples == nullptr)
+    if (!buffer || buffer->sampleCount < 3 || !buffer->isAllocated())
     {
         Logger::getInstance().log(String(config.sensorTag) + ": insufficient samples");
         return result;
     }
 
-    Logger::getInstance().log(String(config.sensorTag) + ": analyzing " + String(buffer->sampleCount) + " samples");
+    // Features folded in during capture; a wrapped streaming ring needs one pass
+    const bool streamed = buffer->features.complete && buffer->features.sampleCount == buffer->sampleCount;
+    const GestureFeatures features = streamed ? buffer->features : GestureFeatures::fromBuffer(*buffer);
+
+    Logger::getInstance().log(String(config.sensorTag) + ": analyzing " + String(buffer->sampleCount) + " samples" +
+                              (streamed ? "" : " (recomputed)"));
 
     // Check if we have gyro data
-    bool hasGyro = false;
-    if (config.useGyro)
-    {
-        for (uint16_t i = 0; i < buffer->sampleCount; i++)
-        {
-            if (buffer->samples[i].gyroValid)
-            {
-                hasGyro = true;
-                break;
-            }
-        }
-    }
+    const bool hasGyro = config.useGyro && features.anyGyro;
 
     if (hasGyro)
     {
         // === GYRO-BASED DETECTION (MPU6050) ===
-        AxisAnalysis gyro = analyzeGyroAxis(buffer);
+        AxisAnalysis gyro = analyzeGyroAxis(features);
 
         if (gyro.axis < 0)
         {
@@ -243,7 +111,7 @@ GestureRecognitionResult detectSimpleGesture(SampleBuffer *buffer, const SimpleG
             return result;
         }
 
-        int dirChanges = countDirectionChanges(buffer, gyro.axis);
+        int dirChanges = features.directionChanges[gyro.axis];
         Logger::getInstance().log(String(config.sensorTag) + ": gyro " +
                                   String(axisName(gyro.axis)) + " peak=" + String(gyro.range, 1) + " deg/s" +
                                   " [" + String(gyro.min, 1) + " to " + String(gyro.max, 1) + "]" +
@@ -266,22 +134,8 @@ GestureRecognitionResult detectSimpleGesture(SampleBuffer *buffer, const SimpleG
         // Detect swipe: unidirectional motion with moderate peak (less than 3 direction changes)
         if (dirChanges < 3 && gyro.range >= config.gyroSwipeThreshold)
         {
-            // Calculate jerk (rate of change of acceleration) for better swipe detection
-            float maxJerk = 0.0f;
-            for (uint16_t i = 1; i < buffer->sampleCount; i++)
-            {
-                const Sample &s1 = buffer->samples[i - 1];
-                const Sample &s2 = buffer->samples[i];
-                if (!s1.gyroValid || !s2.gyroValid)
-                    continue;
-
-                float vals1[3] = {s1.gyroX * kGyroToDegPerSec, s1.gyroY * kGyroToDegPerSec, s1.gyroZ * kGyroToDegPerSec};
-                float vals2[3] = {s2.gyroX * kGyroToDegPerSec, s2.gyroY * kGyroToDegPerSec, s2.gyroZ * kGyroToDegPerSec};
-
-                float jerk = fabsf(vals2[gyro.axis] - vals1[gyro.axis]);
-                if (jerk > maxJerk)
-                    maxJerk = jerk;
-            }
+            // Jerk (largest step between consecutive gyro samples) for better swipe detection
+            float maxJerk = features.gyroJerk[gyro.axis];
 
             // Determine direction from sign of dominant motion
             bool isPositive = (gyro.max > fabsf(gyro.min));
@@ -306,7 +160,7 @@ GestureRecognitionResult detectSimpleGesture(SampleBuffer *buffer, const SimpleG
     else
     {
         // === ACCEL-BASED DETECTION (ADXL345) ===
-        AxisAnalysis accel = analyzeAccelAxis(buffer);
+        AxisAnalysis accel = analyzeAccelAxis(features);
 
         if (accel.axis < 0)
         {
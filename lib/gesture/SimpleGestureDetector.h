@@ -1,7 +1,7 @@
 #ifndef SIMPLE_GESTURE_DETECTOR_H
 #define SIMPLE_GESTURE_DETECTOR_H
 
-#include "gestureRead.h"
+#include "SampleBuffer.h"
 
 /**
  * Sensor-specific gesture recognition type
@@ -12,21 +12,33 @@ enum SensorGestureMode {
     SENSOR_MODE_AUTO            // Auto-detect based on sensor type
 };
 
+/**
+ * Gesture ID ranges, one per source, so a combo never fires for a gesture
+ * another recognizer produced
+ */
+constexpr int GESTURE_ID_TEMPLATE_MIN = 0;      // User templates (GESTURE_TRAIN_n), G_ID:n
+constexpr int GESTURE_ID_TEMPLATE_MAX = 99;
+constexpr int GESTURE_ID_CLASSIFIER_MIN = 100;  // Classifier classes, 100 + class index
+constexpr int GESTURE_ID_CLASSIFIER_MAX = 199;
+constexpr int GESTURE_ID_RULE_MIN = 201;        // Threshold rules: 201 swipe right, 202 swipe left, 203 shake
+constexpr int GESTURE_ID_RULE_MAX = 203;
+
 /**
  * Unified gesture result structure
  */
 struct GestureRecognitionResult {
-    int gestureID;              // Gesture ID (-1 if unknown, 0-8 for custom, 100+ for predefined)
+    int gestureID;              // Gesture ID (-1 if unknown, ranges above)
     float confidence;           // Confidence score 0-1
     SensorGestureMode sensorMode; // Which sensor mode was used
     String gestureName;         // Human-readable name
+    bool rejected;              // Definitely not a gesture: no further recognizer or rule is tried
 
     // Mode-specific data (optional)
     void* modeSpecificData;     // Can hold ShapeType, OrientationType, etc.
 
     GestureRecognitionResult()
         : gestureID(-1), confidence(0.0f), sensorMode(SENSOR_MODE_AUTO),
-          gestureName("G_UNKNOWN"), modeSpecificData(nullptr) {}
+          gestureName("G_UNKNOWN"), rejected(false), modeSpecificData(nullptr) {}
 };
 
 struct SimpleGestureConfig {
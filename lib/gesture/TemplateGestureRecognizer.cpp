@@ -0,0 +1,313 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Gesture recognition by matching user-recorded templates.
+ */
+
+#include "TemplateGestureRecognizer.h"
+#include <LittleFS.h>
+#include <Logger.h>
+#include <cmath>
+#include <string.h>
+
+namespace
+{
+    const uint8_t TEMPLATE_MAGIC[4] = {'M', 'P', 'G', 'T'};
+    constexpr uint8_t TEMPLATE_VERSION = 1;
+    constexpr size_t TEMPLATE_RECORD_SIZE = 4 + GESTURE_TEMPLATE_POINTS * 3 * sizeof(int16_t);
+
+    constexpr float kGyroUnitsPerRad = 4.0f * 57.2957795f; // 1/4 deg/s per rad/s
+    constexpr float kAccelUnitsPerG = 1000.0f;             // mg per g
+    constexpr uint32_t kInfinity = 0x3FFFFFFF;             // Leaves room to add a point cost
+
+    inline uint32_t pointCost(const int16_t *a, const int16_t *b)
+    {
+        return abs(a[0] - b[0]) + abs(a[1] - b[1]) + abs(a[2] - b[2]);
+    }
+
+    inline int16_t saturate(float value)
+    {
+        return static_cast<int16_t>(constrain(lroundf(value), -32767L, 32767L));
+    }
+}
+
+TemplateGestureRecognizer::TemplateGestureRecognizer()
+    : _count(0),
+      _earlyAbandon(true)
+{
+}
+
+bool TemplateGestureRecognizer::extract(const SampleBuffer &buffer, Template &out)
+{
+    const uint16_t samples = buffer.sampleCount;
+    if (!buffer.isAllocated() || samples < GESTURE_TEMPLATE_MIN_SAMPLES)
+    {
+        return false;
+    }
+
+    bool gyro = false;
+    for (uint16_t i = 0; i < samples && !gyro; i++)
+    {
+        gyro = buffer.gyroValid(i);
+    }
+    out.flags = gyro ? FLAG_GYRO : 0;
+
+    // Average each bin of the capture into one point
+    float points[GESTURE_TEMPLATE_POINTS][3];
+    float mean[3] = {0.0f, 0.0f, 0.0f};
+    for (uint16_t p = 0; p < GESTURE_TEMPLATE_POINTS; p++)
+    {
+        uint16_t begin = static_cast<uint32_t>(p) * samples / GESTURE_TEMPLATE_POINTS;
+        uint16_t end = static_cast<uint32_t>(p + 1) * samples / GESTURE_TEMPLATE_POINTS;
+        if (end <= begin)
+        {
+            end = begin + 1;
+        }
+
+        const Sample bin = buffer.average(begin, end);
+        const float values[3] = {
+            gyro ? bin.gyroX * kGyroUnitsPerRad : bin.x * kAccelUnitsPerG,
+            gyro ? bin.gyroY * kGyroUnitsPerRad : bin.y * kAccelUnitsPerG,
+            gyro ? bin.gyroZ * kGyroUnitsPerRad : bin.z * kAccelUnitsPerG};
+        for (int axis = 0; axis < 3; axis++)
+        {
+            points[p][axis] = values[axis];
+            mean[axis] += values[axis] / GESTURE_TEMPLATE_POINTS;
+        }
+    }
+
+    // Accel: drop gravity and the hand orientation, keep the motion
+    for (uint16_t p = 0; p < GESTURE_TEMPLATE_POINTS; p++)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            out.points[p][axis] = saturate(gyro ? points[p][axis] : points[p][axis] - mean[axis]);
+        }
+    }
+    return true;
+}
+
+uint32_t TemplateGestureRecognizer::distance(const int16_t (*a)[3], const int16_t (*b)[3], uint32_t limit)
+{
+    const int points = GESTURE_TEMPLATE_POINTS;
+    uint32_t rows[2][GESTURE_TEMPLATE_POINTS];
+    uint32_t *previous = rows[0];
+    uint32_t *current = rows[1];
+
+    for (int i = 0; i < points; i++)
+    {
+        const int low = std::max(0, i - GESTURE_DTW_BAND);
+        const int high = std::min(points - 1, i + GESTURE_DTW_BAND);
+        uint32_t rowMin = kInfinity;
+
+        for (int j = 0; j < points; j++)
+        {
+            current[j] = kInfinity;
+        }
+
+        for (int j = low; j <= high; j++)
+        {
+            uint32_t best;
+            if (i == 0 && j == 0)
+            {
+                best = 0;
+            }
+            else
+            {
+                best = kInfinity;
+                if (i > 0)
+                    best = std::min(best, previous[j]);
+                if (j > 0)
+                    best = std::min(best, current[j - 1]);
+                if (i > 0 && j > 0)
+                    best = std::min(best, previous[j - 1]);
+            }
+
+            current[j] = best >= kInfinity ? kInfinity : best + pointCost(a[i], b[j]);
+            rowMin = std::min(rowMin, current[j]);
+        }
+
+        // Costs only grow along the path: no cell of this row can lead under the limit
+        if (rowMin > limit)
+        {
+            return rowMin;
+        }
+
+        uint32_t *swap = previous;
+        previous = current;
+        current = swap;
+    }
+
+    return previous[points - 1];
+}
+
+GestureRecognitionResult TemplateGestureRecognizer::recognize(const SampleBuffer &buffer)
+{
+    GestureRecognitionResult result;
+    const unsigned long startUs = micros();
+
+    Template probe;
+    if (!extract(buffer, probe))
+    {
+        return result;
+    }
+
+    const bool gyro = probe.flags & FLAG_GYRO;
+    const uint32_t reject = gyro ? GESTURE_DTW_GYRO_REJECT : GESTURE_DTW_ACCEL_REJECT;
+    uint32_t limit = reject * GESTURE_TEMPLATE_POINTS; // Zero confidence from here on
+    int bestIndex = -1;
+    uint8_t compared = 0;
+
+    for (uint8_t t = 0; t < _count; t++)
+    {
+        const Template &candidate = _templates[t];
+        if (candidate.flags != probe.flags)
+        {
+            continue; // Trained on the other sensor type
+        }
+        compared++;
+
+        // Both ends are always on the warping path
+        const uint32_t bound = pointCost(probe.points[0], candidate.points[0]) +
+                               pointCost(probe.points[GESTURE_TEMPLATE_POINTS - 1],
+                                         candidate.points[GESTURE_TEMPLATE_POINTS - 1]);
+        if (_earlyAbandon && bound >= limit)
+        {
+            continue;
+        }
+
+        const uint32_t cost = distance(probe.points, candidate.points, _earlyAbandon ? limit : kInfinity);
+        if (cost < limit)
+        {
+            limit = cost;
+            bestIndex = t;
+        }
+    }
+
+    const unsigned long elapsedUs = micros() - startUs;
+    if (bestIndex < 0)
+    {
+        Logger::getInstance().log("[Template] no match among " + String(compared) + " templates (" +
+                                  String(elapsedUs) + " us)");
+        return result;
+    }
+
+    const float averageCost = static_cast<float>(limit) / GESTURE_TEMPLATE_POINTS;
+    const uint8_t id = _templates[bestIndex].id;
+    result.gestureID = id;
+    result.gestureName = "G_ID:" + String(id);
+    result.sensorMode = gyro ? SENSOR_MODE_MPU6050 : SENSOR_MODE_ADXL345;
+    result.confidence = constrain(1.0f - averageCost / reject, 0.0f, 1.0f);
+
+    Logger::getInstance().log("[Template] " + result.gestureName + " distance=" + String(averageCost, 1) +
+                              " conf=" + String(result.confidence, 2) + " (" + String(compared) +
+                              " templates, " + String(elapsedUs) + " us)");
+    return result;
+}
+
+bool TemplateGestureRecognizer::train(uint8_t id, const SampleBuffer &buffer)
+{
+    if (id > GESTURE_ID_TEMPLATE_MAX)
+    {
+        Logger::getInstance().log("[Template] G_ID:" + String(id) + " outside the template range " +
+                                  String(GESTURE_ID_TEMPLATE_MIN) + "-" + String(GESTURE_ID_TEMPLATE_MAX));
+        return false;
+    }
+    if (_count >= GESTURE_TEMPLATE_MAX)
+    {
+        Logger::getInstance().log("[Template] template store full (" + String(GESTURE_TEMPLATE_MAX) + ")");
+        return false;
+    }
+
+    Template &slot = _templates[_count];
+    if (!extract(buffer, slot))
+    {
+        Logger::getInstance().log("[Template] capture too short to train (" + String(buffer.sampleCount) + " samples)");
+        return false;
+    }
+    slot.id = id;
+    _count++;
+
+    Logger::getInstance().log("[Template] trained G_ID:" + String(id) + " from " + String(buffer.sampleCount) +
+                              " samples (" + String(_count) + " templates)");
+    return save();
+}
+
+void TemplateGestureRecognizer::clear()
+{
+    _count = 0;
+    if (LittleFS.exists(GESTURE_TEMPLATE_PATH))
+    {
+        LittleFS.remove(GESTURE_TEMPLATE_PATH);
+    }
+    Logger::getInstance().log("[Template] templates cleared");
+}
+
+bool TemplateGestureRecognizer::load()
+{
+    _count = 0;
+    File file = LittleFS.open(GESTURE_TEMPLATE_PATH, "r");
+    if (!file)
+    {
+        return false;
+    }
+
+    uint8_t header[8];
+    if (file.read(header, sizeof(header)) != sizeof(header) ||
+        memcmp(header, TEMPLATE_MAGIC, sizeof(TEMPLATE_MAGIC)) != 0 ||
+        header[4] != TEMPLATE_VERSION || header[5] != GESTURE_TEMPLATE_POINTS)
+    {
+        Logger::getInstance().log("[Template] unsupported template file");
+        file.close();
+        return false;
+    }
+
+    const uint8_t stored = header[6];
+    uint8_t record[TEMPLATE_RECORD_SIZE];
+    while (_count < stored && _count < GESTURE_TEMPLATE_MAX &&
+           file.read(record, sizeof(record)) == sizeof(record))
+    {
+        Template &slot = _templates[_count++];
+        slot.id = record[0];
+        slot.flags = record[1];
+        memcpy(slot.points, record + 4, sizeof(slot.points));
+    }
+    file.close();
+
+    Logger::getInstance().log("[Template] loaded " + String(_count) + " templates");
+    return true;
+}
+
+bool TemplateGestureRecognizer::save() const
+{
+    File file = LittleFS.open(GESTURE_TEMPLATE_PATH, "w");
+    if (!file)
+    {
+        Logger::getInstance().log("[Template] cannot write " + String(GESTURE_TEMPLATE_PATH));
+        return false;
+    }
+
+    uint8_t header[8] = {0};
+    memcpy(header, TEMPLATE_MAGIC, sizeof(TEMPLATE_MAGIC));
+    header[4] = TEMPLATE_VERSION;
+    header[5] = GESTURE_TEMPLATE_POINTS;
+    header[6] = _count;
+    bool ok = file.write(header, sizeof(header)) == sizeof(header);
+
+    uint8_t record[TEMPLATE_RECORD_SIZE];
+    for (uint8_t t = 0; t < _count && ok; t++)
+    {
+        memset(record, 0, 4);
+        record[0] = _templates[t].id;
+        record[1] = _templates[t].flags;
+        memcpy(record + 4, _templates[t].points, sizeof(_templates[t].points));
+        ok = file.write(record, sizeof(record)) == sizeof(record);
+    }
+    file.close();
+
+    if (!ok)
+    {
+        Logger::getInstance().log("[Template] failed to write " + String(GESTURE_TEMPLATE_PATH));
+    }
+    return ok;
+}
@@ -0,0 +1,103 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Gesture recognition by matching user-recorded templates.
+ */
+
+#ifndef TEMPLATE_GESTURE_RECOGNIZER_H
+#define TEMPLATE_GESTURE_RECOGNIZER_H
+
+#include <Arduino.h>
+#include "IGestureRecognizer.h"
+
+#ifndef GESTURE_TEMPLATE_PATH
+    #define GESTURE_TEMPLATE_PATH "/gesture_templates.bin"
+#endif
+
+#ifndef GESTURE_TEMPLATE_MAX
+    #define GESTURE_TEMPLATE_MAX 24 // Templates kept in RAM, 194 bytes each
+#endif
+
+#ifndef GESTURE_TEMPLATE_POINTS
+    #define GESTURE_TEMPLATE_POINTS 32 // Points per trajectory after downsampling
+#endif
+
+#ifndef GESTURE_TEMPLATE_MIN_SAMPLES
+    #define GESTURE_TEMPLATE_MIN_SAMPLES 8 // Shorter captures are neither trained nor matched
+#endif
+
+#ifndef GESTURE_DTW_BAND
+    #define GESTURE_DTW_BAND 4 // Sakoe-Chiba band radius, in points
+#endif
+
+// Average L1 distance per point at which confidence reaches zero
+#ifndef GESTURE_DTW_GYRO_REJECT
+    #define GESTURE_DTW_GYRO_REJECT 480 // 1/4 deg/s units (120 deg/s)
+#endif
+#ifndef GESTURE_DTW_ACCEL_REJECT
+    #define GESTURE_DTW_ACCEL_REJECT 600 // mg
+#endif
+
+/**
+ * @brief Dynamic-time-warping matcher over user-trained templates.
+ *
+ * A capture is reduced to GESTURE_TEMPLATE_POINTS points of three int16
+ * channels: gyro in 1/4 deg/s when the sensor has one, otherwise accel
+ * in mg with the per-axis mean removed (orientation independent). Each
+ * template is compared with a banded DTW on L1 distances; a template is
+ * abandoned as soon as a whole row of the cost matrix exceeds the best
+ * distance found so far.
+ *
+ * The gesture ID of a template is chosen when training (GESTURE_TRAIN_n,
+ * n in GESTURE_ID_TEMPLATE_MIN..MAX) and reported as G_ID:n. Several
+ * templates may share an ID.
+ *
+ * File format (little endian): "MPGT", version, points, count, reserved;
+ * then per template: id, flags (bit 0 = gyro), 2 reserved bytes and
+ * points * 3 int16 values (x, y, z interleaved).
+ */
+class TemplateGestureRecognizer : public IGestureRecognizer
+{
+public:
+    static constexpr uint8_t FLAG_GYRO = 0x01;
+
+    struct Template
+    {
+        uint8_t id;
+        uint8_t flags;
+        int16_t points[GESTURE_TEMPLATE_POINTS][3];
+    };
+
+    TemplateGestureRecognizer();
+
+    const char *name() const override { return "Template"; }
+    bool isReady() const override { return _count > 0; }
+    GestureRecognitionResult recognize(const SampleBuffer &buffer) override;
+
+    bool load();
+    bool save() const;
+
+    // Add the capture as a template for id and save the set
+    bool train(uint8_t id, const SampleBuffer &buffer);
+    void clear(); // Drop every template and delete the file
+
+    uint8_t count() const { return _count; }
+
+    // On by default; off compares every template in full (same result, for benchmarks)
+    void setEarlyAbandon(bool enabled) { _earlyAbandon = enabled; }
+
+private:
+    // Downsample and scale the capture; false when it is too short
+    static bool extract(const SampleBuffer &buffer, Template &out);
+
+    // Banded DTW; returns a value above limit once the match cannot beat it
+    static uint32_t distance(const int16_t (*a)[3], const int16_t (*b)[3], uint32_t limit);
+
+    Template _templates[GESTURE_TEMPLATE_MAX];
+    uint8_t _count;
+    bool _earlyAbandon;
+};
+
+extern TemplateGestureRecognizer gestureTemplates;
+
+#endif // TEMPLATE_GESTURE_RECOGNIZER_H
@@ -9,7 +9,9 @@
 GestureAnalyze::GestureAnalyze(GestureRead &gestureReader)
     : _gestureReader(gestureReader),
       _confidenceThreshold(0.5f),
-      _currentSensorType("")
+      _currentSensorType(""),
+      _recognizers{},
+      _recognizerCount(0)
 {
 }
 
@@ -25,12 +27,29 @@ SampleBuffer &GestureAnalyze::getRawSample()
 
 GestureRecognitionResult GestureAnalyze::recognize(SampleBuffer* buffer)
 {
-    if (!buffer || buffer->sampleCount == 0 || buffer->samples == nullptr)
+    if (!buffer || buffer->sampleCount == 0 || !buffer->isAllocated())
     {
         Logger::getInstance().log("[GestureAnalyze] No samples to analyze");
         return GestureRecognitionResult();
     }
 
+    for (uint8_t i = 0; i < _recognizerCount; i++)
+    {
+        if (!_recognizers[i]->isReady())
+        {
+            continue;
+        }
+        GestureRecognitionResult matched = _recognizers[i]->recognize(*buffer);
+        if (matched.rejected)
+        {
+            return GestureRecognitionResult();
+        }
+        if (matched.gestureID >= 0 && matched.confidence >= _confidenceThreshold)
+        {
+            return matched;
+        }
+    }
+
     SimpleGestureConfig config;
     String normalizedSensor = _currentSensorType;
     normalizedSensor.toLowerCase();
@@ -70,6 +89,17 @@ GestureRecognitionResult GestureAnalyze::recognize(SampleBuffer* buffer)
     return result;
 }
 
+bool GestureAnalyze::addRecognizer(IGestureRecognizer *recognizer)
+{
+    if (!recognizer || _recognizerCount >= kMaxRecognizers)
+    {
+        return false;
+    }
+    _recognizers[_recognizerCount++] = recognizer;
+    Logger::getInstance().log("[GestureAnalyze] recognizer added: " + String(recognizer->name()));
+    return true;
+}
+
 void GestureAnalyze::setSensorType(const String& sensorType)
 {
     _currentSensorType = sensorType;
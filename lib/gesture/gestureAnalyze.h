@@ -9,6 +9,7 @@
 #include <Arduino.h>
 #include "gestureRead.h"
 #include "SimpleGestureDetector.h"
+#include "IGestureRecognizer.h"
 
 class GestureAnalyze
 {
@@ -22,6 +23,9 @@ public:
 
     void setSensorType(const String& sensorType);
 
+    // Recognizers are tried in the order added, before the threshold rules
+    bool addRecognizer(IGestureRecognizer *recognizer);
+
     void setConfidenceThreshold(float threshold);
     float getConfidenceThreshold() const { return _confidenceThreshold; }
 
@@ -29,6 +33,9 @@ private:
     GestureRead &_gestureReader;
     float _confidenceThreshold;
     String _currentSensorType;
+    static constexpr uint8_t kMaxRecognizers = 4;
+    IGestureRecognizer *_recognizers[kMaxRecognizers];
+    uint8_t _recognizerCount;
 };
 
 extern GestureAnalyze gestureAnalyzer;
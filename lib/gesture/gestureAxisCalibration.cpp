@@ -53,9 +53,9 @@ AxisCalibrationResult AxisCalibration::calibrate(GestureRead* gestureRead, uint3
     float avgX = 0, avgY = 0, avgZ = 0;
     for (uint16_t i = 0; i < samples.sampleCount; i++) {
         // Samples are already calibrated (offset removed), so we need to add offset back to get raw values
-        avgX += samples.samples[i].x;
-        avgY += samples.samples[i].y;
-        avgZ += samples.samples[i].z;
+        avgX += samples.getX(i);
+        avgY += samples.getY(i);
+        avgZ += samples.getZ(i);
     }
 
     avgX /= samples.sampleCount;
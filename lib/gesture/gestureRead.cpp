@@ -2,7 +2,9 @@
 
 #include <Arduino.h>
 #include <Logger.h>
+#include "GyroBiasModel.h"
 #include "Led.h"
+#include "LoopWake.h"
 
 #include <algorithm>
 #include <cmath>
@@ -102,13 +104,41 @@ bool GestureRead::ensureSamplingTask()
     return true;
 }
 
+void IRAM_ATTR GestureRead::onDataReady(void *arg)
+{
+    GestureRead *self = static_cast<GestureRead *>(arg);
+    TaskHandle_t task = self->_samplingTaskHandle;
+    if (!task)
+    {
+        return;
+    }
+    BaseType_t higherPriorityWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(task, &higherPriorityWoken);
+    if (higherPriorityWoken)
+    {
+        portYIELD_FROM_ISR();
+    }
+}
+
 void GestureRead::samplingTaskLoop()
 {
     TickType_t lastWakeTime = xTaskGetTickCount();
 
     while (_samplingTaskShouldRun)
     {
-        uint32_t intervalMs = MotionSensor::sampleIntervalMs(_sampleHZ);
+        if (_dataReadyActive)
+        {
+            // One wakeup per new sample; the timeout re-reads if an edge was missed,
+            // which also clears the latched INT line
+            const uint32_t timeoutMs = MotionSensor::sampleIntervalMs(_sampleHZ) * 2 + GESTURE_DATA_READY_SLACK_MS;
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs));
+            updateSampling();
+            lastWakeTime = xTaskGetTickCount();
+            continue;
+        }
+
+        // FIFO: wake once per batch and drain every frame queued since
+        uint32_t intervalMs = _fifoActive ? GESTURE_FIFO_BATCH_MS : MotionSensor::sampleIntervalMs(_sampleHZ);
         if (intervalMs == 0)
         {
             intervalMs = 1;
@@ -140,21 +170,27 @@ GestureRead::GestureRead(TwoWire *wire)
       _expectGyro(false),
       _streamingMode(false),
       _writeIndex(0),
-      _totalSamples(0)
+      _totalSamples(0),
+      _fifoActive(false),
+      _dataReadyActive(false),
+      _preRollHead(0),
+      _preRollCount(0),
+      _preRollActive(false),
+      _biasWindowActive(false),
+      _biasWindowStartMs(0),
+      _lastBiasWindowMs(0),
+      _biasWindowTemperature(NAN)
 {
     _calibrationOffset = {0, 0, 0};
     _sampleHZ = MotionSensor::kDefaultSampleHz;
     _maxSamples = 300;
 
-    _sampleBuffer.samples = new Sample[_maxSamples];
-    if (!_sampleBuffer.samples)
+    if (!_sampleBuffer.allocate(_maxSamples))
     {
         Logger::getInstance().log("FATAL: Failed to allocate sample buffer!");
         while (true)
             ;
     }
-    _sampleBuffer.sampleCount = 0;
-    _sampleBuffer.maxSamples = _maxSamples;
     _sampleBuffer.sampleHZ = _sampleHZ;
     _samplingTaskHandle = nullptr;
     _samplingTaskShouldRun = false;
@@ -176,11 +212,8 @@ GestureRead::~GestureRead()
         }
     }
 
-    if (_sampleBuffer.samples)
-    {
-        delete[] _sampleBuffer.samples;
-        _sampleBuffer.samples = nullptr;
-    }
+    _sampleBuffer.release();
+    _preRoll.release();
 }
 
 bool GestureRead::begin(const AccelerometerConfig &config)
@@ -199,6 +232,7 @@ bool GestureRead::begin(const AccelerometerConfig &config)
 
     _sampleHZ = MotionSensor::clampSampleRate(_config.sampleRate > 0 ? _config.sampleRate : MotionSensor::kDefaultSampleHz);
     _sampleBuffer.sampleHZ = _sampleHZ;
+    _sampleBuffer.setAccelRange(_config.sensitivity);
 
     // Auto-calibration disabled - using manual calibration only
 
@@ -208,19 +242,15 @@ bool GestureRead::begin(const AccelerometerConfig &config)
 
     if (desiredSamples != _maxSamples)
     {
-        if (_sampleBuffer.samples)
-        {
-            delete[] _sampleBuffer.samples;
-        }
-        _sampleBuffer.samples = new Sample[desiredSamples];
-        if (!_sampleBuffer.samples)
+        std::lock_guard<std::mutex> lock(_bufferMutex);
+        if (!_sampleBuffer.allocate(desiredSamples))
         {
+            _maxSamples = 0;
             Logger::getInstance().log("FATAL: Failed to allocate new sample buffer!");
             return false;
         }
         _maxSamples = desiredSamples;
-        _sampleBuffer.maxSamples = _maxSamples;
-        clearMemory();
+        clearMemoryNoLock();
     }
 
     if (!_sensor->begin(_config))
@@ -229,6 +259,10 @@ bool GestureRead::begin(const AccelerometerConfig &config)
     }
 
     _config = _sensor->config(); // sync resolved address
+    _config.fifo = config.fifo;
+    _config.dataReadyInterrupt = config.dataReadyInterrupt;
+    _config.interruptPin = config.interruptPin;
+    _sampleBuffer.sampleHZ = _sensor->outputDataRateHz(); // Divider rounding: 300 Hz runs at 333 Hz
 
     Logger::getInstance().log("Auto-calibration is DISABLED. Use manual calibration command.");
 
@@ -265,7 +299,7 @@ bool GestureRead::begin(const AccelerometerConfig &config)
         _motionWakeEnabled = false;
     }
 
-    if (!standby())
+    if (!idle())
     {
         return false;
     }
@@ -275,10 +309,9 @@ bool GestureRead::begin(const AccelerometerConfig &config)
 
 void GestureRead::clearMemoryNoLock()
 {
-    if (_sampleBuffer.samples)
+    if (_sampleBuffer.isAllocated())
     {
-        memset(_sampleBuffer.samples, 0, _maxSamples * sizeof(Sample));
-        _sampleBuffer.sampleCount = 0;
+        _sampleBuffer.clear();
         _bufferFull = false;
         lastSampleTime = 0;
         _writeIndex = 0;
@@ -305,6 +338,13 @@ void GestureRead::flushSensorBuffer()
         return;
     }
 
+    if (_preRollActive)
+    {
+        // The pre-roll ring only ever holds the last few hundred ms: nothing stale to drain
+        clearMemory();
+        return;
+    }
+
     // Temporarily wake the sensor so we can drain any residual samples that
     // may still be buffered by the device after the previous capture.
     if (!wakeup())
@@ -408,6 +448,8 @@ bool GestureRead::calibrate(uint16_t calibrationSamples)
         calibrationSamples = 10;  // Increased from 2 to 10
     }
 
+    disarmPreRoll(); // Calibration reads the sensor itself
+
     if (!wakeup())
     {
         return false;
@@ -550,7 +592,7 @@ bool GestureRead::calibrate(uint16_t calibrationSamples)
     Logger::getInstance().log("  Z: " + String(fabsf(_calibrationOffset.z), 4) + "g " +
                              (fabsf(_calibrationOffset.z) > 0.8f ? "<-- VERTICAL AXIS" : ""));
 
-    return standby();
+    return idle();
 }
 
 bool GestureRead::startSampling()
@@ -563,6 +605,21 @@ bool GestureRead::startSampling()
         }
         // Clear buffer immediately while holding lock to prevent race with sampling task
         clearMemoryNoLock();
+
+        if (_preRollActive)
+        {
+            // Sensor already awake and fresh: no wakeup, drain or warmup, and the
+            // motion just before the trigger leads the capture
+            const unsigned long now = millis();
+            const uint16_t attached = attachPreRollNoLock(now);
+            startSampleSource();
+            _isSampling = true;
+            _bufferFull = false;
+            lastSampleTime = now;
+            // The attached frames count towards the minimum sampling window
+            samplingStartTime = now - static_cast<unsigned long>(attached) * MotionSensor::sampleIntervalMs(_sampleHZ);
+            return true;
+        }
     }
 
     if (!_sensor || !_sensor->isReady())
@@ -608,6 +665,8 @@ bool GestureRead::startSampling()
     // Prime driver with the most recent frame so the first stored sample is current
     _sensor->update();
 
+    startSampleSource();
+
     {
         std::lock_guard<std::mutex> lock(_bufferMutex);
         _isSampling = true;
@@ -670,6 +729,20 @@ bool GestureRead::stopSampling()
         return false;
     }
 
+    // Up to a batch period of motion is still in the FIFO: it belongs to this capture
+    if (_fifoActive)
+    {
+        MotionSensor::Frame frames[GESTURE_FIFO_READ_FRAMES];
+        const bool gyroAvailable = _sensor->hasGyro();
+        bool requestStop = false;
+        Sample lastStored{};
+        bool stored = false;
+        while (!requestStop &&
+               storeFifoBatchNoLock(frames, gyroAvailable, requestStop, lastStored, stored) == GESTURE_FIFO_READ_FRAMES)
+        {
+        }
+    }
+
     const bool bufferWasFull = _sampleBuffer.sampleCount >= _maxSamples;
     _isSampling = false;
 
@@ -683,7 +756,7 @@ bool GestureRead::stopSampling()
         Logger::getInstance().log("Stopped sampling - buffer full (" + String(_maxSamples) + " samples collected)");
     }
 
-    if (!standby())
+    if (!idle())
     {
         Logger::getInstance().log("Failed to enter accelerometer standby after sampling stop");
         return false;
@@ -723,8 +796,19 @@ bool GestureRead::standby()
         return false;
     }
 
+    holdOffBiasWindow();
+
     const bool motionWakeActive = isMotionWakeEnabled();
 
+    disarmPreRoll();
+
+    if (_fifoActive)
+    {
+        _fifoActive = false;
+        _sensor->stopFifo();
+    }
+    disableDataReady();
+
     if (!enableLowPowerMode())
     {
         Logger::getInstance().log("Failed to configure accelerometer low power mode");
@@ -740,15 +824,248 @@ bool GestureRead::standby()
     return true;
 }
 
+bool GestureRead::enableDataReady()
+{
+    if (_dataReadyActive || _config.interruptPin < 0 || !_sensor->enableDataReadyInterrupt(true))
+    {
+        return false;
+    }
+
+    const uint8_t pin = static_cast<uint8_t>(_config.interruptPin);
+    pinMode(pin, INPUT_PULLUP); // INT is open drain on the MPU6050
+    attachInterruptArg(pin, onDataReady, this, FALLING);
+    _dataReadyActive = true;
+
+    // Release a line latched before the interrupt was attached
+    _sensor->update();
+    return true;
+}
+
+void GestureRead::disableDataReady()
+{
+    if (!_dataReadyActive)
+    {
+        return;
+    }
+    _dataReadyActive = false;
+    detachInterrupt(static_cast<uint8_t>(_config.interruptPin));
+    _sensor->enableDataReadyInterrupt(false);
+}
+
+// FIFO reset drops anything queued during warmup: the first frame drained is fresh.
+// Streaming (gyro mouse) wants the newest sample at once, not a batch every
+// GESTURE_FIFO_BATCH_MS, so it samples on DATA_READY instead
+void GestureRead::startSampleSource()
+{
+    if (_config.fifo && !_streamingMode && _sensor->startFifo())
+    {
+        disableDataReady(); // Left on by the pre-roll; the FIFO batches replace it
+        _fifoActive = true;
+        Logger::getInstance().log("GestureRead: FIFO sampling at " + String(_sensor->outputDataRateHz()) + " Hz");
+    }
+    else if (_config.dataReadyInterrupt && (_dataReadyActive || enableDataReady()))
+    {
+        Logger::getInstance().log("GestureRead: DATA_READY sampling on GPIO " + String(_config.interruptPin));
+    }
+}
+
+bool GestureRead::idle()
+{
+    if (_configLoaded && _config.preRollMs > 0 && armPreRoll())
+    {
+        return true;
+    }
+
+    const bool stopped = standby();
+    if (_config.preRollMs == 0 && _preRoll.isAllocated())
+    {
+        std::lock_guard<std::mutex> lock(_bufferMutex);
+        if (!_preRollActive)
+        {
+            _preRoll.release(); // Pre-roll turned off by a config reload
+        }
+    }
+    return stopped;
+}
+
+// Keep the sensor running at the capture rate between gestures so startSampling()
+// can hand over the last preRollMs of motion instead of waking a cold sensor
+bool GestureRead::armPreRoll()
+{
+    if (!_sensor || !_sensor->isReady())
+    {
+        return false;
+    }
+
+    if (_fifoActive)
+    {
+        _fifoActive = false;
+        _sensor->stopFifo();
+    }
+
+    if (!wakeup() || !disableLowPowerMode())
+    {
+        Logger::getInstance().log("GestureRead: pre-roll unavailable, sensor did not wake");
+        return false;
+    }
+
+    if (_config.dataReadyInterrupt)
+    {
+        enableDataReady(); // Already on after a DATA_READY capture
+    }
+
+    const uint32_t frames = static_cast<uint32_t>(_config.preRollMs) * _sampleBuffer.sampleHZ / 1000;
+    const uint16_t capacity = static_cast<uint16_t>(std::max<uint32_t>(1, std::min<uint32_t>(frames, GESTURE_PREROLL_MAX_FRAMES)));
+
+    std::lock_guard<std::mutex> lock(_bufferMutex);
+    if (capacity != _preRoll.maxSamples)
+    {
+        if (!_preRoll.allocate(capacity))
+        {
+            _preRollActive = false;
+            Logger::getInstance().log("GestureRead: pre-roll unavailable, no memory for " + String(capacity) + " frames");
+            return false;
+        }
+        Logger::getInstance().log("GestureRead: pre-roll " + String(capacity) + " frames (" +
+                                  String(capacity * 1000UL / std::max<uint16_t>(1, _sampleBuffer.sampleHZ)) + " ms)");
+    }
+    _preRoll.accelScale = _sampleBuffer.accelScale;
+    _preRoll.gyroScale = _sampleBuffer.gyroScale;
+    _preRollHead = 0;
+    _preRollCount = 0;
+    lastSampleTime = 0;
+    _preRollActive = true;
+    return true;
+}
+
+void GestureRead::disarmPreRoll()
+{
+    std::lock_guard<std::mutex> lock(_bufferMutex);
+    _preRollActive = false;
+    _preRollCount = 0;
+}
+
+void GestureRead::pushPreRollNoLock(const MotionSensor::Frame &frame, bool gyroAvailable)
+{
+    Sample sample{};
+    sample.x = frame.x;
+    sample.y = frame.y;
+    sample.z = frame.z;
+    sample.gyroX = frame.gyroX;
+    sample.gyroY = frame.gyroY;
+    sample.gyroZ = frame.gyroZ;
+    sample.gyroValid = gyroAvailable;
+    _preRoll.set(_preRollHead, sample);
+
+    const uint16_t capacity = _preRoll.maxSamples;
+    _preRollHead = (_preRollHead + 1) % capacity;
+    if (_preRollCount < capacity)
+    {
+        _preRollCount++;
+    }
+}
+
+// Caller holds _bufferMutex; moves the ring into the cleared capture buffer, oldest first
+uint16_t GestureRead::attachPreRollNoLock(unsigned long currentTime)
+{
+    const uint16_t attached = _preRollCount;
+    const uint16_t capacity = _preRoll.maxSamples;
+    bool requestStop = false; // The ring is far smaller than the capture buffer
+    uint16_t index = (_preRollHead + capacity - attached) % capacity;
+    for (uint16_t i = 0; i < attached; ++i)
+    {
+        const Sample sample = _preRoll.get(index);
+        const MotionSensor::Frame frame = {sample.x, sample.y, sample.z, sample.gyroX, sample.gyroY, sample.gyroZ};
+        storeSampleNoLock(frame, sample.gyroValid, currentTime, requestStop);
+        index = (index + 1) % capacity;
+    }
+    _preRollActive = false;
+    _preRollCount = 0;
+    return attached;
+}
+
 bool GestureRead::wakeup()
 {
     if (!_sensor || !_sensor->isReady())
     {
         return false;
     }
+    holdOffBiasWindow();
     return _sensor->start();
 }
 
+// Caller holds _bufferMutex; the sensor is in standby (no capture, no pre-roll).
+// Gesture captures and the gyro mouse are motion, so the bias model gets its
+// still frames here: every GYRO_BIAS_IDLE_INTERVAL_MS the gyro runs at the
+// capture rate for one GYRO_BIAS_WINDOW_MS window. A device in use fails the
+// model's stillness check and the window is simply dropped
+void GestureRead::serviceBiasWindowNoLock(unsigned long currentTime)
+{
+    if (!_biasWindowActive)
+    {
+        if (GYRO_BIAS_IDLE_INTERVAL_MS == 0 || _streamingMode || !_expectGyro || !_sensor->hasGyro() ||
+            currentTime - _lastBiasWindowMs < GYRO_BIAS_IDLE_INTERVAL_MS)
+        {
+            return;
+        }
+        _lastBiasWindowMs = currentTime;
+        if (!_sensor->start() || !disableLowPowerMode())
+        {
+            enableLowPowerMode();
+            _sensor->stop();
+            return;
+        }
+        _biasWindowActive = true;
+        _biasWindowStartMs = currentTime;
+        _biasWindowTemperature = NAN;
+        return;
+    }
+
+    const unsigned long elapsed = currentTime - _biasWindowStartMs;
+    const unsigned long interval = MotionSensor::sampleIntervalMs(_sampleHZ);
+    if (elapsed >= GYRO_BIAS_IDLE_SETTLE_MS + GYRO_BIAS_WINDOW_MS + 2 * interval)
+    {
+        // Back to the state standby() left
+        _biasWindowActive = false;
+        enableLowPowerMode();
+        _sensor->stop();
+        lastSampleTime = 0;
+        return;
+    }
+    if (elapsed < GYRO_BIAS_IDLE_SETTLE_MS || !_sensor->update())
+    {
+        return;
+    }
+
+    MotionSensor::Frame frame{};
+    frame.x = getMappedX();
+    frame.y = getMappedY();
+    frame.z = getMappedZ();
+    getMappedGyro(frame.gyroX, frame.gyroY, frame.gyroZ);
+    lastSampleTime = currentTime;
+    if (!std::isfinite(frame.x) || !std::isfinite(frame.y) || !std::isfinite(frame.z) ||
+        fabsf(frame.x) + fabsf(frame.y) + fabsf(frame.z) < kMinValidAccelMagnitude)
+    {
+        return;
+    }
+
+    // One reading per window: the die temperature does not move within a second
+    if (!std::isfinite(_biasWindowTemperature))
+    {
+        _biasWindowTemperature = gyroTemperatureC();
+    }
+    learnGyroBias(frame, _biasWindowTemperature);
+}
+
+// wakeup()/standby() take the sensor over: end a running idle bias window and
+// restart its interval. Never called with _bufferMutex held
+void GestureRead::holdOffBiasWindow()
+{
+    std::lock_guard<std::mutex> lock(_bufferMutex);
+    _biasWindowActive = false;
+    _lastBiasWindowMs = millis();
+}
+
 bool GestureRead::configureMotionWakeup(uint8_t threshold, uint8_t duration, uint8_t highPassCode, uint8_t cycleRateCode)
 {
     if (!_sensor || !_sensor->isReady())
@@ -970,15 +1287,27 @@ void GestureRead::updateSampling()
         return;
     }
 
+    if (_fifoActive)
+    {
+        updateSamplingFromFifo();
+        return;
+    }
+
     bool requestStop = false;
     bool ledSetIdle = false;
-    bool ledSetFull = false;
 
-    std::unique_lock<std::mutex> lock(_bufferMutex);
+    // Start/stop/clear hold the lock briefly: skip this tick rather than wait,
+    // the sensor keeps the data (and DATA_READY stays latched) until the next one
+    std::unique_lock<std::mutex> lock(_bufferMutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        return;
+    }
     const unsigned long currentTime = millis();
     const unsigned long interval = MotionSensor::sampleIntervalMs(_sampleHZ);
 
-    if (currentTime - lastSampleTime < interval)
+    // DATA_READY paces the reads: a millis() interval check would drop samples on jitter
+    if (!_dataReadyActive && currentTime - lastSampleTime < interval)
     {
         return;
     }
@@ -995,42 +1324,52 @@ void GestureRead::updateSampling()
             return;
         }
 
-        const float mappedX = getMappedX();
-        const float mappedY = getMappedY();
-        const float mappedZ = getMappedZ();
+        MotionSensor::Frame frame{};
+        frame.x = getMappedX();
+        frame.y = getMappedY();
+        frame.z = getMappedZ();
 
-        if (!std::isfinite(mappedX) || !std::isfinite(mappedY) || !std::isfinite(mappedZ))
+        if (!std::isfinite(frame.x) || !std::isfinite(frame.y) || !std::isfinite(frame.z))
         {
             return;
         }
 
-        const float accelSum = fabsf(mappedX) + fabsf(mappedY) + fabsf(mappedZ);
+        const float accelSum = fabsf(frame.x) + fabsf(frame.y) + fabsf(frame.z);
         if (accelSum < kMinValidAccelMagnitude)
         {
             // Skip clearly stale readings (all zeros)
             return;
         }
 
+        const bool gyroAvailable = _sensor->hasGyro();
+        MotionSensor::Frame raw{};
+        float temperature = NAN;
+        if (gyroAvailable)
+        {
+            getMappedGyro(frame.gyroX, frame.gyroY, frame.gyroZ);
+            raw = frame;
+            temperature = gyroTemperatureC();
+            GyroBiasModel::getInstance().apply(frame, temperature);
+        }
+
         // Detect duplicate samples by comparing with last stored sample
         if (count > 0)
         {
             const uint16_t lastIndex = (count - 1) % _maxSamples;
-            const Sample &lastSample = _sampleBuffer.samples[lastIndex];
+            const Sample lastSample = _sampleBuffer.get(lastIndex);
 
-            const float accelDiff = fabsf(mappedX - (lastSample.x + _calibrationOffset.x)) +
-                                   fabsf(mappedY - (lastSample.y + _calibrationOffset.y)) +
-                                   fabsf(mappedZ - (lastSample.z + _calibrationOffset.z));
+            const float accelDiff = fabsf(frame.x - (lastSample.x + _calibrationOffset.x)) +
+                                   fabsf(frame.y - (lastSample.y + _calibrationOffset.y)) +
+                                   fabsf(frame.z - (lastSample.z + _calibrationOffset.z));
 
             // If accelerometer values are identical (within epsilon), check gyro too
             if (accelDiff < 0.001f)
             {
-                float mappedGyroX = 0.0f, mappedGyroY = 0.0f, mappedGyroZ = 0.0f;
-                if (_sensor->hasGyro())
+                if (gyroAvailable)
                 {
-                    getMappedGyro(mappedGyroX, mappedGyroY, mappedGyroZ);
-                    const float gyroDiff = fabsf(mappedGyroX - lastSample.gyroX) +
-                                          fabsf(mappedGyroY - lastSample.gyroY) +
-                                          fabsf(mappedGyroZ - lastSample.gyroZ);
+                    const float gyroDiff = fabsf(frame.gyroX - lastSample.gyroX) +
+                                          fabsf(frame.gyroY - lastSample.gyroY) +
+                                          fabsf(frame.gyroZ - lastSample.gyroZ);
 
                     if (gyroDiff < 0.001f)
                     {
@@ -1046,205 +1385,341 @@ void GestureRead::updateSampling()
             }
         }
 
-        const float calibratedX = mappedX - _calibrationOffset.x;
-        const float calibratedY = mappedY - _calibrationOffset.y;
-        const float calibratedZ = mappedZ - _calibrationOffset.z;
-
-        float mappedGyroX = 0.0f;
-        float mappedGyroY = 0.0f;
-        float mappedGyroZ = 0.0f;
-        const bool gyroAvailable = _sensor->hasGyro();
         if (gyroAvailable)
         {
-            getMappedGyro(mappedGyroX, mappedGyroY, mappedGyroZ);
+            learnGyroBias(raw, temperature);
         }
 
-        const uint16_t writeIndex = (count < _maxSamples) ? count : _writeIndex;
-        Sample &sample = _sampleBuffer.samples[writeIndex];
-
-        // Apply calibration offset (set during manual calibration)
-        sample.x = calibratedX;
-        sample.y = calibratedY;
-        sample.z = calibratedZ;
+        _snapshot.publish(frame, gyroAvailable, micros());
+        const Sample sample = storeSampleNoLock(frame, gyroAvailable, currentTime, requestStop);
+        // Only update lastSampleTime when we successfully got new data
+        lastSampleTime = currentTime;
+        showSampleOnLed(sample);
 
-        sample.gyroValid = gyroAvailable;
-        if (sample.gyroValid)
-        {
-            sample.gyroX = mappedGyroX;
-            sample.gyroY = mappedGyroY;
-            sample.gyroZ = mappedGyroZ;
-        }
-        else
+        if (_streamingMode && _dataReadyActive)
         {
-            sample.gyroX = 0.0f;
-            sample.gyroY = 0.0f;
-            sample.gyroZ = 0.0f;
+            LoopWake::notify(LoopWake::WAKE_IMU); // Tickless loop runs the gyro mouse on fresh data only
         }
+    }
+    else
+    {
+        ledSetIdle = true;
 
-        sample.temperatureValid = _sensor->hasTemperature();
-        sample.temperature = sample.temperatureValid ? _sensor->readTemperatureC() : 0.0f;
-
-        const uint32_t sampleNumber = _totalSamples++;
-
-        if (count < _maxSamples)
+        if (_preRollActive && _sensor->update())
         {
-            _sampleBuffer.sampleCount = count + 1;
-            if (_sampleBuffer.sampleCount == _maxSamples)
+            MotionSensor::Frame frame{};
+            frame.x = getMappedX();
+            frame.y = getMappedY();
+            frame.z = getMappedZ();
+            const bool gyroAvailable = _sensor->hasGyro();
+            if (gyroAvailable)
             {
-                _bufferFull = true;
-                if (!_streamingMode)
+                getMappedGyro(frame.gyroX, frame.gyroY, frame.gyroZ);
+            }
+
+            if (std::isfinite(frame.x) && std::isfinite(frame.y) && std::isfinite(frame.z) &&
+                fabsf(frame.x) + fabsf(frame.y) + fabsf(frame.z) >= kMinValidAccelMagnitude)
+            {
+                if (gyroAvailable)
                 {
-                    ledSetFull = true;
-                    requestStop = true;
+                    const float temperature = gyroTemperatureC();
+                    learnGyroBias(frame, temperature);
+                    GyroBiasModel::getInstance().apply(frame, temperature);
                 }
+                _snapshot.publish(frame, gyroAvailable, micros());
+                pushPreRollNoLock(frame, gyroAvailable);
+                lastSampleTime = currentTime;
             }
         }
-        else
+        else if (!_preRollActive)
         {
-            _sampleBuffer.sampleCount = _maxSamples;
-            _bufferFull = true;
-            if (!_streamingMode)
-            {
-                ledSetFull = true;
-                requestStop = true;
-            }
+            serviceBiasWindowNoLock(currentTime);
         }
+    }
 
-        _writeIndex = (writeIndex + 1) % _maxSamples;
-        // Only update lastSampleTime when we successfully got new data
-        lastSampleTime = currentTime;
+    lock.unlock();
 
-        static uint8_t initialDebugLogsRemaining = 0;
-        static unsigned long lastStreamingLogMs = 0;
-        static uint32_t lastStreamingLoggedSample = 0;
+    if (requestStop || ledSetIdle)
+    {
+        // Restore system LED color with brightness (not scaled values)
+        specialAction.restoreSystemLedColor();
+    }
+
+    if (requestStop)
+    {
+        stopSampling();
+    }
+}
 
-        if (sampleNumber == 0)
+// Every FIFO frame is a distinct sample one ODR period after the previous
+// one, so there is no rate limiting and no duplicate detection here
+void GestureRead::updateSamplingFromFifo()
+{
+    MotionSensor::Frame frames[GESTURE_FIFO_READ_FRAMES];
+    const bool gyroAvailable = _sensor->hasGyro();
+    bool requestStop = false;
+    size_t count = 0;
+
+    do
+    {
+        // The FIFO keeps the frames while start/stop/clear hold the lock
+        std::unique_lock<std::mutex> lock(_bufferMutex, std::try_to_lock);
+        if (!lock.owns_lock())
         {
-            initialDebugLogsRemaining = 3;
-            lastStreamingLogMs = 0;
-            lastStreamingLoggedSample = 0;
+            return;
+        }
+        if (!_isSampling)
+        {
+            return;
         }
 
-        bool shouldEmitLog = false;
-
-        if (initialDebugLogsRemaining > 0)
+        Sample lastStored{};
+        bool stored = false;
+        count = storeFifoBatchNoLock(frames, gyroAvailable, requestStop, lastStored, stored);
+        if (stored)
         {
-            shouldEmitLog = true;
-            initialDebugLogsRemaining--;
+            showSampleOnLed(lastStored);
         }
-        else if (_streamingMode)
+    } while (count == GESTURE_FIFO_READ_FRAMES && !requestStop);
+
+    if (requestStop)
+    {
+        specialAction.restoreSystemLedColor();
+        stopSampling();
+    }
+}
+
+// Caller holds _bufferMutex; reads one FIFO batch into the capture and returns the frames read
+size_t GestureRead::storeFifoBatchNoLock(MotionSensor::Frame *frames, bool gyroAvailable, bool &requestStop,
+                                        Sample &lastStored, bool &stored)
+{
+    const size_t count = _sensor->readFifo(frames, GESTURE_FIFO_READ_FRAMES);
+    if (count == 0)
+    {
+        return 0;
+    }
+    if (gyroAvailable)
+    {
+        // One reading per batch: the die temperature does not move within a few ODR periods
+        const float temperature = gyroTemperatureC();
+        GyroBiasModel &model = GyroBiasModel::getInstance();
+        for (size_t i = 0; i < count; ++i)
         {
-            const unsigned long elapsedMs = (lastStreamingLogMs <= currentTime)
-                                                ? (currentTime - lastStreamingLogMs)
-                                                : 0;
-            const uint32_t samplesSinceLast = (sampleNumber >= lastStreamingLoggedSample)
-                                                  ? (sampleNumber - lastStreamingLoggedSample)
-                                                  : 0;
-
-            if (elapsedMs >= 2000 || samplesSinceLast >= 200)
+            MotionSensor::Frame &frame = frames[i];
+            if (std::isfinite(frame.x) && std::isfinite(frame.y) && std::isfinite(frame.z))
             {
-                shouldEmitLog = true;
+                learnGyroBias(frame, temperature);
             }
+            model.apply(frame, temperature);
         }
+    }
+    _snapshot.publish(frames[count - 1], gyroAvailable, micros());
 
-        if (shouldEmitLog)
+    const unsigned long currentTime = millis();
+    for (size_t i = 0; i < count && !requestStop; ++i)
+    {
+        const MotionSensor::Frame &frame = frames[i];
+        if (!std::isfinite(frame.x) || !std::isfinite(frame.y) || !std::isfinite(frame.z))
         {
-            char logBuffer[256];
-            int length = snprintf(
-                logBuffer,
-                sizeof(logBuffer),
-                "gesture_sample idx=%lu mapped=[%.4f,%.4f,%.4f] offset=[%.4f,%.4f,%.4f] calibrated=[%.4f,%.4f,%.4f]",
-                static_cast<unsigned long>(sampleNumber),
-                mappedX,
-                mappedY,
-                mappedZ,
-                _calibrationOffset.x,
-                _calibrationOffset.y,
-                _calibrationOffset.z,
-                sample.x,
-                sample.y,
-                sample.z);
-
-            if (length < 0)
-            {
-                length = 0;
-            }
+            continue;
+        }
+        lastStored = storeSampleNoLock(frame, gyroAvailable, currentTime, requestStop);
+        stored = true;
+    }
+    lastSampleTime = currentTime;
+    return count;
+}
 
-            if (sample.gyroValid)
-            {
-                length += snprintf(
-                    logBuffer + length,
-                    length < static_cast<int>(sizeof(logBuffer)) ? sizeof(logBuffer) - length : 0,
-                    " gyro=[%.4f,%.4f,%.4f]",
-                    sample.gyroX,
-                    sample.gyroY,
-                    sample.gyroZ);
-            }
-            else
-            {
-                length += snprintf(
-                    logBuffer + length,
-                    length < static_cast<int>(sizeof(logBuffer)) ? sizeof(logBuffer) - length : 0,
-                    " gyro=NA");
-            }
+float GestureRead::gyroTemperatureC() const
+{
+    return _sensor->hasTemperature() ? _sensor->readTemperatureC() : NAN;
+}
 
-            if (sample.temperatureValid)
-            {
-                snprintf(
-                    logBuffer + length,
-                    length < static_cast<int>(sizeof(logBuffer)) ? sizeof(logBuffer) - length : 0,
-                    " temp=%.2fC",
-                    sample.temperature);
-            }
+// Still windows of raw frames keep refining the bias model; frames are corrected
+// with GyroBiasModel::apply before anything is stored or published. While the
+// gyro mouse streams the device is in the hand and moving, so nothing is learned.
+void GestureRead::learnGyroBias(const MotionSensor::Frame &raw, float temperatureC)
+{
+    if (!_streamingMode)
+    {
+        GyroBiasModel::getInstance().observe(raw, temperatureC);
+    }
+}
 
-            Logger::getInstance().log(String(logBuffer));
+// Caller holds _bufferMutex; sets requestStop when a non-streaming capture fills the buffer
+Sample GestureRead::storeSampleNoLock(const MotionSensor::Frame &frame, bool gyroAvailable,
+                                     unsigned long currentTime, bool &requestStop)
+{
+    const uint16_t count = _sampleBuffer.sampleCount;
+    const uint16_t writeIndex = (count < _maxSamples) ? count : _writeIndex;
+    Sample sample;
 
-            if (_streamingMode)
-            {
-                lastStreamingLogMs = currentTime;
-                lastStreamingLoggedSample = sampleNumber;
-            }
-        }
+    // Apply calibration offset (set during manual calibration)
+    sample.x = frame.x - _calibrationOffset.x;
+    sample.y = frame.y - _calibrationOffset.y;
+    sample.z = frame.z - _calibrationOffset.z;
 
-        float x = fabsf(sample.x);
-        float y = fabsf(sample.y);
-        float z = fabsf(sample.z);
+    sample.gyroValid = gyroAvailable;
+    if (sample.gyroValid)
+    {
+        sample.gyroX = frame.gyroX;
+        sample.gyroY = frame.gyroY;
+        sample.gyroZ = frame.gyroZ;
+    }
+    else
+    {
+        sample.gyroX = 0.0f;
+        sample.gyroY = 0.0f;
+        sample.gyroZ = 0.0f;
+    }
 
-        const float maxRange = _config.sensitivity;
-        x = x > maxRange ? maxRange : x;
-        y = y > maxRange ? maxRange : y;
-        z = z > maxRange ? maxRange : z;
+    sample.temperatureValid = _sensor->hasTemperature();
+    sample.temperature = sample.temperatureValid ? _sensor->readTemperatureC() : 0.0f;
+    _sampleBuffer.set(writeIndex, sample);
 
-        const int r = static_cast<int>(x * 255.0f / maxRange);
-        const int g = static_cast<int>(y * 255.0f / maxRange);
-        const int b = static_cast<int>(z * 255.0f / maxRange);
+    const uint32_t sampleNumber = _totalSamples++;
 
-        Led::getInstance().setColor(r, g, b, false);
+    if (count < _maxSamples)
+    {
+        // Fold in the stored (quantized) values so fromBuffer() would agree
+        _sampleBuffer.features.add(_sampleBuffer.get(writeIndex));
+        _sampleBuffer.sampleCount = count + 1;
+        if (_sampleBuffer.sampleCount == _maxSamples)
+        {
+            _bufferFull = true;
+            if (!_streamingMode)
+            {
+                requestStop = true;
+            }
+        }
     }
     else
     {
-        if (!sampling)
+        // Ring wrapped: the oldest sample is gone, recompute at recognition
+        _sampleBuffer.features.invalidate();
+        _sampleBuffer.sampleCount = _maxSamples;
+        _bufferFull = true;
+        if (!_streamingMode)
         {
-            ledSetIdle = true;
+            requestStop = true;
         }
     }
 
-    lock.unlock();
+    _writeIndex = (writeIndex + 1) % _maxSamples;
+
+    static uint8_t initialDebugLogsRemaining = 0;
+    static unsigned long lastStreamingLogMs = 0;
+    static uint32_t lastStreamingLoggedSample = 0;
 
-    if (ledSetFull || ledSetIdle)
+    if (sampleNumber == 0)
     {
-        // Restore system LED color with brightness (not scaled values)
-        specialAction.restoreSystemLedColor();
-        // Reset flags to prevent continuous restore calls
-        ledSetFull = false;
-        ledSetIdle = false;
+        initialDebugLogsRemaining = 3;
+        lastStreamingLogMs = 0;
+        lastStreamingLoggedSample = 0;
     }
 
-    if (requestStop)
+    bool shouldEmitLog = false;
+
+    if (initialDebugLogsRemaining > 0)
     {
-        stopSampling();
+        shouldEmitLog = true;
+        initialDebugLogsRemaining--;
     }
+    else if (_streamingMode)
+    {
+        const unsigned long elapsedMs = (lastStreamingLogMs <= currentTime)
+                                            ? (currentTime - lastStreamingLogMs)
+                                            : 0;
+        const uint32_t samplesSinceLast = (sampleNumber >= lastStreamingLoggedSample)
+                                              ? (sampleNumber - lastStreamingLoggedSample)
+                                              : 0;
+
+        if (elapsedMs >= 2000 || samplesSinceLast >= 200)
+        {
+            shouldEmitLog = true;
+        }
+    }
+
+    if (shouldEmitLog)
+    {
+        char logBuffer[256];
+        int length = snprintf(
+            logBuffer,
+            sizeof(logBuffer),
+            "gesture_sample idx=%lu mapped=[%.4f,%.4f,%.4f] offset=[%.4f,%.4f,%.4f] calibrated=[%.4f,%.4f,%.4f]",
+            static_cast<unsigned long>(sampleNumber),
+            frame.x,
+            frame.y,
+            frame.z,
+            _calibrationOffset.x,
+            _calibrationOffset.y,
+            _calibrationOffset.z,
+            sample.x,
+            sample.y,
+            sample.z);
+
+        if (length < 0)
+        {
+            length = 0;
+        }
+
+        if (sample.gyroValid)
+        {
+            length += snprintf(
+                logBuffer + length,
+                length < static_cast<int>(sizeof(logBuffer)) ? sizeof(logBuffer) - length : 0,
+                " gyro=[%.4f,%.4f,%.4f]",
+                sample.gyroX,
+                sample.gyroY,
+                sample.gyroZ);
+        }
+        else
+        {
+            length += snprintf(
+                logBuffer + length,
+                length < static_cast<int>(sizeof(logBuffer)) ? sizeof(logBuffer) - length : 0,
+                " gyro=NA");
+        }
+
+        if (sample.temperatureValid)
+        {
+            snprintf(
+                logBuffer + length,
+                length < static_cast<int>(sizeof(logBuffer)) ? sizeof(logBuffer) - length : 0,
+                " temp=%.2fC",
+                sample.temperature);
+        }
+
+        Logger::getInstance().log(String(logBuffer));
+
+        if (_streamingMode)
+        {
+            lastStreamingLogMs = currentTime;
+            lastStreamingLoggedSample = sampleNumber;
+        }
+    }
+
+    return sample;
 }
+
+void GestureRead::showSampleOnLed(const Sample &sample)
+{
+    float x = fabsf(sample.x);
+    float y = fabsf(sample.y);
+    float z = fabsf(sample.z);
+
+    const float maxRange = _config.sensitivity;
+    x = x > maxRange ? maxRange : x;
+    y = y > maxRange ? maxRange : y;
+    z = z > maxRange ? maxRange : z;
+
+    const int r = static_cast<int>(x * 255.0f / maxRange);
+    const int g = static_cast<int>(y * 255.0f / maxRange);
+    const int b = static_cast<int>(z * 255.0f / maxRange);
+
+    Led::getInstance().setColor(r, g, b, false);
+}
+
 void GestureRead::setStreamingMode(bool enable)
 {
     std::lock_guard<std::mutex> lock(_bufferMutex);
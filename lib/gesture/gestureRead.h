@@ -24,37 +24,43 @@
 #include <Wire.h>
 #include "configTypes.h"
 #include "MotionSensor.h"
+#include "GestureFeatures.h"
+#include "SampleBuffer.h"
+#include "ImuSnapshot.h"
 #include <memory>
 #include <mutex>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 
-struct Offset
-{
-    float x;
-    float y;
-    float z;
-};
+#ifndef GESTURE_FIFO_BATCH_MS
+    #define GESTURE_FIFO_BATCH_MS 20 // Sampling task period while the MPU6050 FIFO is active
+#endif
+
+#ifndef GESTURE_DATA_READY_SLACK_MS
+    #define GESTURE_DATA_READY_SLACK_MS 5 // Extra wait past two sample periods before re-reading without an edge
+#endif
+
+#ifndef GESTURE_FIFO_READ_FRAMES
+    #define GESTURE_FIFO_READ_FRAMES 32 // Frames drained per buffer lock
+#endif
+
+#ifndef GESTURE_PREROLL_MAX_FRAMES
+    #define GESTURE_PREROLL_MAX_FRAMES 128 // Pre-roll ring size; accelerometer.preRollMs is clamped to it
+#endif
+
+#ifndef GYRO_BIAS_IDLE_INTERVAL_MS
+    #define GYRO_BIAS_IDLE_INTERVAL_MS 60000UL // Standby: wake the gyro for one bias window this often (0 = never)
+#endif
 
-struct Sample
+#ifndef GYRO_BIAS_IDLE_SETTLE_MS
+    #define GYRO_BIAS_IDLE_SETTLE_MS 100 // Gyro start-up transient skipped at each idle bias window
+#endif
+
+struct Offset
 {
     float x;
     float y;
     float z;
-    float gyroX;
-    float gyroY;
-    float gyroZ;
-    float temperature;
-    bool gyroValid;
-    bool temperatureValid;
-};
-
-struct SampleBuffer
-{
-    Sample *samples; // Pointer to dynamically allocated samples
-    uint16_t sampleCount;
-    uint16_t maxSamples;
-    uint16_t sampleHZ;
 };
 
 class GestureRead
@@ -87,7 +93,10 @@ public:
     void clearMemory();
     void flushSensorBuffer(); // Flush hardware buffer to discard stale data
 
-    // Mapped axis accessors
+    // Last frame read by the sampling task, all six axes from the same read; never blocks the sampler
+    bool getLatestFrame(ImuFrame &out) const { return _snapshot.read(out); }
+
+    // Mapped axis accessors (read the driver directly)
     float getMappedX();
     float getMappedY();
     float getMappedZ();
@@ -104,10 +113,35 @@ public:
     void setStreamingMode(bool enable);
     bool isStreamingMode() const { return _streamingMode; }
 
+    // Streaming samples arrive on the sensor interrupt and wake the input loop (LoopWake::WAKE_IMU)
+    bool isDataReadyDriven() const { return _dataReadyActive; }
+
+    // Idle sensor kept awake filling the pre-roll ring (accelerometer.preRollMs > 0)
+    bool isPreRollActive() const { return _preRollActive; }
+
 private:
     static void samplingTaskTrampoline(void *param);
+    static void IRAM_ATTR onDataReady(void *arg);
+    bool enableDataReady();
+    void disableDataReady();
+    void startSampleSource();
+    bool idle(); // Pre-roll when configured, standby otherwise
+    bool armPreRoll();
+    void disarmPreRoll();
+    void serviceBiasWindowNoLock(unsigned long currentTime);
+    void holdOffBiasWindow();
+    void pushPreRollNoLock(const MotionSensor::Frame &frame, bool gyroAvailable);
+    uint16_t attachPreRollNoLock(unsigned long currentTime);
     bool ensureSamplingTask();
     void samplingTaskLoop();
+    void updateSamplingFromFifo();
+    size_t storeFifoBatchNoLock(MotionSensor::Frame *frames, bool gyroAvailable, bool &requestStop,
+                                Sample &lastStored, bool &stored);
+    float gyroTemperatureC() const; // NAN without a temperature sensor
+    void learnGyroBias(const MotionSensor::Frame &raw, float temperatureC); // Valid, distinct raw frames only
+    Sample storeSampleNoLock(const MotionSensor::Frame &frame, bool gyroAvailable,
+                             unsigned long currentTime, bool &requestStop);
+    void showSampleOnLed(const Sample &sample);
     void drainSensorBuffer(uint32_t timeoutMs, uint32_t waitMs, uint8_t stableReads);
     bool waitForGyroReady(uint32_t timeoutMs);
     bool waitForFreshAccelerometer(uint32_t timeoutMs);
@@ -121,7 +155,8 @@ private:
     Offset _calibrationOffset;
     bool _isCalibrated;
     // New members for continuous sampling
-    std::mutex _bufferMutex;
+    std::mutex _bufferMutex; // The sampling task only try-locks it
+    ImuSnapshot _snapshot;
     bool _isSampling;
     bool _bufferFull;
     unsigned long lastSampleTime;
@@ -131,6 +166,22 @@ private:
     bool _streamingMode;
     uint16_t _writeIndex;
     uint32_t _totalSamples;
+    volatile bool _fifoActive; // Set by startSampling(), cleared by standby()
+    volatile bool _dataReadyActive; // Sampling task blocks on the sensor INT pin
+
+    // Frames read while idle, oldest first from (_preRollHead - _preRollCount); guarded by _bufferMutex.
+    // Allocated by armPreRoll() only, so preRollMs 0 costs no RAM
+    SampleBuffer _preRoll;
+    uint16_t _preRollHead;
+    uint16_t _preRollCount;
+    volatile bool _preRollActive;
+
+    // Idle bias window: the sampling task wakes a standby gyro for one still
+    // window every GYRO_BIAS_IDLE_INTERVAL_MS; guarded by _bufferMutex
+    bool _biasWindowActive;
+    unsigned long _biasWindowStartMs;
+    unsigned long _lastBiasWindowMs;
+    float _biasWindowTemperature;
 
     SampleBuffer _sampleBuffer;
     uint16_t _maxSamples;
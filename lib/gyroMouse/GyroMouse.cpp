@@ -2,6 +2,7 @@
 #include "Logger.h"
 #include "BLEController.h"
 #include "InputHub.h"
+#include "GyroBiasModel.h"
 
 #include <cmath>
 
@@ -31,19 +32,16 @@ GyroMouse::GyroMouse()
       smoothedMouseY(0.0f),
       residualMouseX(0.0f),
       residualMouseY(0.0f),
-      lastUpdateTime(0),
+      lastFrameUs(0),
+      lastFrameSequence(0),
       clickSlowdownFactor(1.0f),
       lastClickCheckTime(0),
       neutralCapturePending(false),
       neutralCaptureSamples(0),
       neutralPitchAccum(0.0f),
       neutralRollAccum(0.0f),
-      gyroBiasAccumX(0.0f),
-      gyroBiasAccumY(0.0f),
-      gyroBiasAccumZ(0.0f),
-      gyroBiasSquaredAccumX(0.0f),
-      gyroBiasSquaredAccumY(0.0f),
-      gyroBiasSquaredAccumZ(0.0f) {
+      gyroSum{0.0f, 0.0f, 0.0f},
+      gyroSquaredSum{0.0f, 0.0f, 0.0f} {
 }
 
 GyroMouse::~GyroMouse() {
@@ -137,7 +135,7 @@ void GyroMouse::start() {
     fusion.reset();
     beginNeutralCapture();
     Logger::getInstance().log("GyroMouse: Neutral capture requested");
-    lastUpdateTime = millis();
+    lastFrameUs = micros();
 
     active = true;
 
@@ -156,15 +154,7 @@ void GyroMouse::stop() {
     residualMouseX = 0.0f;
     residualMouseY = 0.0f;
     neutralCapturePending = false;
-    neutralCaptureSamples = 0;
-    neutralPitchAccum = 0.0f;
-    neutralRollAccum = 0.0f;
-    gyroBiasAccumX = 0.0f;
-    gyroBiasAccumY = 0.0f;
-    gyroBiasAccumZ = 0.0f;
-    gyroBiasSquaredAccumX = 0.0f;
-    gyroBiasSquaredAccumY = 0.0f;
-    gyroBiasSquaredAccumZ = 0.0f;
+    resetNeutralAccumulators();
     gyroAvailable = false;
 
     if (ownsSampling && gestureSensor) {
@@ -192,25 +182,31 @@ void GyroMouse::update() {
         return;
     }
 
-    unsigned long currentTime = millis();
-    float deltaTime = (currentTime - lastUpdateTime) / 1000.0f;
-    lastUpdateTime = currentTime;
+    // All six axes from the same sensor read; nothing to do until a new one arrives
+    ImuFrame imu;
+    if (!gestureSensor->getLatestFrame(imu) || imu.sequence == lastFrameSequence) {
+        return;
+    }
+    lastFrameSequence = imu.sequence;
+
+    float deltaTime = (imu.timestampUs - lastFrameUs) / 1000000.0f;
+    lastFrameUs = imu.timestampUs;
 
     if (deltaTime > 0.1f || deltaTime <= 0.0f) {
         deltaTime = 0.005f; // Assume 200Hz
     }
 
     SensorFrame frame{};
-    frame.gyroX = gestureSensor->getMappedGyroX();
-    frame.gyroY = gestureSensor->getMappedGyroY();
-    frame.gyroZ = gestureSensor->getMappedGyroZ();
-    frame.accelX = gestureSensor->getMappedX();
-    frame.accelY = gestureSensor->getMappedY();
-    frame.accelZ = gestureSensor->getMappedZ();
+    frame.gyroX = imu.axes.gyroX;
+    frame.gyroY = imu.axes.gyroY;
+    frame.gyroZ = imu.axes.gyroZ;
+    frame.accelX = imu.axes.x;
+    frame.accelY = imu.axes.y;
+    frame.accelZ = imu.axes.z;
     frame.accelMagnitude = sqrtf(frame.accelX * frame.accelX +
                                  frame.accelY * frame.accelY +
                                  frame.accelZ * frame.accelZ);
-    frame.gyroValid = gyroAvailable;
+    frame.gyroValid = gyroAvailable && imu.gyroValid;
 
     fusion.update(frame, deltaTime);
 
@@ -399,18 +395,20 @@ int8_t GyroMouse::clampMouseValue(float pending, float& residual) {
     return static_cast<int8_t>(rounded);
 }
 
-void GyroMouse::beginNeutralCapture() {
-    fusion.reset();
-    neutralCapturePending = true;
+void GyroMouse::resetNeutralAccumulators() {
     neutralCaptureSamples = 0;
     neutralPitchAccum = 0.0f;
     neutralRollAccum = 0.0f;
-    gyroBiasAccumX = 0.0f;
-    gyroBiasAccumY = 0.0f;
-    gyroBiasAccumZ = 0.0f;
-    gyroBiasSquaredAccumX = 0.0f;
-    gyroBiasSquaredAccumY = 0.0f;
-    gyroBiasSquaredAccumZ = 0.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        gyroSum[axis] = 0.0f;
+        gyroSquaredSum[axis] = 0.0f;
+    }
+}
+
+void GyroMouse::beginNeutralCapture() {
+    fusion.reset();
+    neutralCapturePending = true;
+    resetNeutralAccumulators();
     smoothedMouseX = 0.0f;
     smoothedMouseY = 0.0f;
     residualMouseX = 0.0f;
@@ -628,29 +626,18 @@ void GyroMouse::accumulateNeutralCapture(float pitchAcc, float rollAcc, const Se
         gyroQuietY > kNeutralCaptureGyroThreshold ||
         gyroQuietZ > kNeutralCaptureGyroThreshold) {
         // Movement detected - reset accumulation
-        neutralCaptureSamples = 0;
-        neutralPitchAccum = 0.0f;
-        neutralRollAccum = 0.0f;
-        gyroBiasAccumX = 0.0f;
-        gyroBiasAccumY = 0.0f;
-        gyroBiasAccumZ = 0.0f;
-        gyroBiasSquaredAccumX = 0.0f;
-        gyroBiasSquaredAccumY = 0.0f;
-        gyroBiasSquaredAccumZ = 0.0f;
+        resetNeutralAccumulators();
         return;
     }
 
     // Accumulate samples for averaging and variance calculation
     neutralPitchAccum += pitchAcc;
     neutralRollAccum += rollAcc;
-    gyroBiasAccumX += frame.gyroX;
-    gyroBiasAccumY += frame.gyroY;
-    gyroBiasAccumZ += frame.gyroZ;
-
-    // Accumulate squared values for variance calculation
-    gyroBiasSquaredAccumX += frame.gyroX * frame.gyroX;
-    gyroBiasSquaredAccumY += frame.gyroY * frame.gyroY;
-    gyroBiasSquaredAccumZ += frame.gyroZ * frame.gyroZ;
+    const float gyro[3] = {frame.gyroX, frame.gyroY, frame.gyroZ};
+    for (int axis = 0; axis < 3; ++axis) {
+        gyroSum[axis] += gyro[axis];
+        gyroSquaredSum[axis] += gyro[axis] * gyro[axis];
+    }
 
     ++neutralCaptureSamples;
 
@@ -661,33 +648,26 @@ void GyroMouse::accumulateNeutralCapture(float pitchAcc, float rollAcc, const Se
 
     // Calculate variance to ensure stability (variance = E[X²] - E[X]²)
     const float invCount = 1.0f / static_cast<float>(neutralCaptureSamples);
-    const float meanX = gyroBiasAccumX * invCount;
-    const float meanY = gyroBiasAccumY * invCount;
-    const float meanZ = gyroBiasAccumZ * invCount;
-
-    const float varianceX = (gyroBiasSquaredAccumX * invCount) - (meanX * meanX);
-    const float varianceY = (gyroBiasSquaredAccumY * invCount) - (meanY * meanY);
-    const float varianceZ = (gyroBiasSquaredAccumZ * invCount) - (meanZ * meanZ);
-    const float totalVariance = varianceX + varianceY + varianceZ;
+    float mean[3];
+    float totalVariance = 0.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        mean[axis] = gyroSum[axis] * invCount;
+        totalVariance += (gyroSquaredSum[axis] * invCount) - (mean[axis] * mean[axis]);
+    }
 
     // If variance too high, device is not stable enough - retry
     if (totalVariance > kNeutralCaptureVarianceThreshold) {
         Logger::getInstance().log("GyroMouse: Neutral capture rejected (variance too high: " +
                                   String(totalVariance, 6) + ")");
-        neutralCaptureSamples = 0;
-        neutralPitchAccum = 0.0f;
-        neutralRollAccum = 0.0f;
-        gyroBiasAccumX = 0.0f;
-        gyroBiasAccumY = 0.0f;
-        gyroBiasAccumZ = 0.0f;
-        gyroBiasSquaredAccumX = 0.0f;
-        gyroBiasSquaredAccumY = 0.0f;
-        gyroBiasSquaredAccumZ = 0.0f;
+        resetNeutralAccumulators();
         return;
     }
 
-    // Variance acceptable - update bias with averaged values
-    fusion.updateGyroBias(meanX, meanY, meanZ);
+    // Frames arrive already corrected by GyroBiasModel; the still mean only
+    // seeds the fusion bias while the model has not learned one yet.
+    if (!GyroBiasModel::getInstance().isReady()) {
+        fusion.updateGyroBias(mean[0], mean[1], mean[2]);
+    }
 
     // Capture neutral orientation
     fusion.captureNeutralOrientation();
@@ -697,7 +677,7 @@ void GyroMouse::accumulateNeutralCapture(float pitchAcc, float rollAcc, const Se
     smoothedMouseY = 0.0f;
     residualMouseX = 0.0f;
     residualMouseY = 0.0f;
-    lastUpdateTime = millis();
+    lastFrameUs = micros();
 
     Logger::getInstance().log("GyroMouse: Neutral capture completed (" +
                               String(neutralCaptureSamples) + " samples, variance: " +
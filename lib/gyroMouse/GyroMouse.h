@@ -48,7 +48,8 @@ private:
     float smoothedMouseY;
     float residualMouseX;
     float residualMouseY;
-    unsigned long lastUpdateTime;
+    uint32_t lastFrameUs;       // Timestamp of the last IMU frame used
+    uint32_t lastFrameSequence; // Snapshot sequence of that frame
 
     // Click stabilization
     float clickSlowdownFactor;
@@ -67,6 +68,7 @@ private:
     float applySmoothCurve(float value, float deadzone, float maxValue);
     float applyAccelerationCurve(float angularVelocity, float curveExponent);
     int8_t clampMouseValue(float pending, float& residual);
+    void resetNeutralAccumulators();
     void beginNeutralCapture();
     void accumulateNeutralCapture(float pitchAcc, float rollAcc, const SensorFrame& frame);
     void performAbsoluteCentering();
@@ -80,12 +82,8 @@ private:
     uint16_t neutralCaptureSamples;
     float neutralPitchAccum;
     float neutralRollAccum;
-    float gyroBiasAccumX;
-    float gyroBiasAccumY;
-    float gyroBiasAccumZ;
-    float gyroBiasSquaredAccumX;
-    float gyroBiasSquaredAccumY;
-    float gyroBiasSquaredAccumZ;
+    float gyroSum[3];        // stillness check only; bias comes from GyroBiasModel
+    float gyroSquaredSum[3];
 };
 
 #endif // GYROMOUSE_H
@@ -0,0 +1,70 @@
+/*
+ * ESP32 MacroPad Project
+ * Copyright (C) [2025] [Enrico Mori]
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "InputText.h"
+#include "Logger.h"
+
+String InputText::names[INPUT_TEXT_MAX];
+std::atomic<uint16_t> InputText::count{0};
+
+uint16_t InputText::find(const String &name)
+{
+    if (name.length() == 0)
+    {
+        return NONE;
+    }
+
+    uint16_t published = count.load(std::memory_order_acquire);
+    for (uint16_t i = 0; i < published; i++)
+    {
+        if (names[i] == name)
+        {
+            return i + 1;
+        }
+    }
+    return NONE;
+}
+
+uint16_t InputText::intern(const String &name)
+{
+    uint16_t id = find(name);
+    if (id != NONE || name.length() == 0)
+    {
+        return id;
+    }
+
+    uint16_t published = count.load(std::memory_order_relaxed);
+    if (published >= INPUT_TEXT_MAX)
+    {
+        Logger::getInstance().log("InputText: table full, dropping text " + name);
+        return NONE;
+    }
+
+    names[published] = name;
+    count.store(published + 1, std::memory_order_release);
+    return published + 1;
+}
+
+const char *InputText::lookup(uint16_t id)
+{
+    if (id == NONE || id > count.load(std::memory_order_acquire))
+    {
+        return "";
+    }
+    return names[id - 1].c_str();
+}
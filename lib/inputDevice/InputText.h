@@ -0,0 +1,41 @@
+#ifndef INPUT_TEXT_H
+#define INPUT_TEXT_H
+
+#include <Arduino.h>
+#include <atomic>
+
+#ifndef INPUT_TEXT_MAX
+    #define INPUT_TEXT_MAX 64 // Distinct event texts (gesture names) kept for the whole run
+#endif
+
+/**
+ * @brief Interned text payloads for InputEvent.
+ *
+ * Events carry a small id instead of a String so they stay POD and can
+ * travel through the lock-free event ring. Names are interned once and
+ * never removed: ids stay valid for the whole run. Id 0 means no text.
+ *
+ * Entries are append-only and published after they are written, so
+ * lookup() is safe from any context; intern() must be called from one
+ * producer at a time.
+ */
+class InputText
+{
+public:
+    static constexpr uint16_t NONE = 0;
+
+    // Id of name, adding it on first use; NONE for an empty name or a full table
+    static uint16_t intern(const String &name);
+
+    // Id of name if already interned, otherwise NONE
+    static uint16_t find(const String &name);
+
+    // Text of id, "" for NONE or an unknown id
+    static const char *lookup(uint16_t id);
+
+private:
+    static String names[INPUT_TEXT_MAX];
+    static std::atomic<uint16_t> count;
+};
+
+#endif // INPUT_TEXT_H
@@ -34,7 +34,7 @@ struct InputEvent {
     int value1{0};   // For key codes, rotation direction, etc.
     int value2{0};   // For additional data (e.g., acceleration values)
     bool state{false};  // Pressed/released, button state, etc.
-    String text;     // Optional textual payload (e.g., gesture name)
+    uint16_t textId{0}; // Interned textual payload (e.g., gesture name), see InputText
 };
 
 class InputDevice {
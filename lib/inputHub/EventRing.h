@@ -0,0 +1,91 @@
+#ifndef EVENT_RING_H
+#define EVENT_RING_H
+
+#include <Arduino.h>
+#include <atomic>
+
+/**
+ * @brief Fixed-capacity single-producer / single-consumer ring.
+ *
+ * One context pushes (scan loop, input task or ISR), one context pops.
+ * Head and tail are free-running counters: each side writes only its own
+ * index, so no lock is needed. T must be trivially copyable.
+ *
+ * Capacity must be a power of two.
+ */
+template <typename T, size_t Capacity>
+class EventRing
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "EventRing capacity must be a power of two");
+
+public:
+    // Producer side
+    bool push(const T &item)
+    {
+        uint32_t head = headIndex.load(std::memory_order_relaxed);
+        if (head - tailIndex.load(std::memory_order_acquire) >= Capacity)
+        {
+            return false;
+        }
+        items[head & (Capacity - 1)] = item;
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t freeSpace() const
+    {
+        return Capacity - size();
+    }
+
+    // Consumer side
+    bool peek(T &outItem) const
+    {
+        uint32_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail == headIndex.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        outItem = items[tail & (Capacity - 1)];
+        return true;
+    }
+
+    void skip()
+    {
+        uint32_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail != headIndex.load(std::memory_order_acquire))
+        {
+            tailIndex.store(tail + 1, std::memory_order_release);
+        }
+    }
+
+    bool pop(T &outItem)
+    {
+        if (!peek(outItem))
+        {
+            return false;
+        }
+        skip();
+        return true;
+    }
+
+    // Consumer side: drop everything published so far
+    void clear()
+    {
+        tailIndex.store(headIndex.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    // Either side; exact only when called from one of them
+    size_t size() const
+    {
+        return headIndex.load(std::memory_order_acquire) - tailIndex.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    T items[Capacity];
+    std::atomic<uint32_t> headIndex{0};
+    std::atomic<uint32_t> tailIndex{0};
+};
+
+#endif // EVENT_RING_H
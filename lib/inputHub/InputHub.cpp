@@ -7,8 +7,13 @@
 #include "IRSender.h"
 #include "IRStorage.h"
 #include "Logger.h"
+#include "LatencyTracer.h"
 #include "combinationManager.h"
 #include "GestureDevice.h"
+#include "LoopWake.h"
+#include "InputTrace.h"
+#include <algorithm>
+#include <limits.h>
 
 extern GestureRead gestureSensor;
 extern GestureAnalyze gestureAnalyzer;
@@ -138,50 +143,86 @@ void InputHub::scanDevices()
     scanKeypad();
     scanRotaryEncoder();
     scanGestures();
+    scanReplay();
 }
 
-bool InputHub::poll(InputEvent &outEvent)
+unsigned long InputHub::getNextWakeDelayMs(unsigned long pollPeriodMs) const
 {
-    if (eventQueue.empty())
+    unsigned long nearest = ULONG_MAX;
+    if (!eventQueue.empty() || clearRequested.load(std::memory_order_acquire))
     {
-        return false;
+        return 0;
     }
-    outEvent = eventQueue.front().event;
-    eventQueue.pop_front();
-    return true;
+    if (keypad && keypad->needsPolling())
+    {
+        nearest = pollPeriodMs;
+    }
+    if (rotaryEncoder)
+    {
+        nearest = std::min(nearest, rotaryEncoder->getNextPollDelayMs(pollPeriodMs));
+    }
+    if (gestureDevice && gestureCaptureEnabled && gestureDevice->getState() != GestureDevice::State::Idle)
+    {
+        nearest = std::min(nearest, pollPeriodMs);
+    }
+    nearest = std::min(nearest, InputTrace::getInstance().msUntilNextReplay(millis()));
+    return std::min(nearest, reactiveLighting.msUntilUpdate());
 }
 
-bool InputHub::poll(TimedEvent &outEvent)
+bool InputHub::poll(InputEvent &outEvent)
 {
-    if (eventQueue.empty())
+    applyClearRequest();
+    TimedEvent timedEvent;
+    if (!eventQueue.pop(timedEvent))
     {
         return false;
     }
-    outEvent = eventQueue.front();
-    eventQueue.pop_front();
+    outEvent = timedEvent.event;
     return true;
 }
 
+bool InputHub::poll(TimedEvent &outEvent)
+{
+    applyClearRequest();
+    return eventQueue.pop(outEvent);
+}
+
+bool InputHub::peek(TimedEvent &outEvent) const
+{
+    // Events a pending clear will drop are already gone for the consumer
+    return !clearRequested.load(std::memory_order_acquire) && eventQueue.peek(outEvent);
+}
+
+void InputHub::skip()
+{
+    applyClearRequest();
+    eventQueue.skip();
+}
+
 bool InputHub::pollFiltered(const std::function<bool(const InputEvent &)> &predicate, TimedEvent &outEvent)
 {
-    const size_t initialSize = eventQueue.size();
-    for (size_t i = 0; i < initialSize; ++i)
+    applyClearRequest();
+    TimedEvent head;
+    if (!eventQueue.peek(head) || !predicate(head.event))
     {
-        TimedEvent current = eventQueue.front();
-        eventQueue.pop_front();
-        if (predicate(current.event))
-        {
-            outEvent = current;
-            return true;
-        }
-        eventQueue.push_back(current);
+        return false;
     }
-    return false;
+    eventQueue.skip();
+    outEvent = head;
+    return true;
 }
 
 void InputHub::clearQueue()
 {
-    eventQueue.clear();
+    clearRequested.store(true, std::memory_order_release);
+}
+
+void InputHub::applyClearRequest()
+{
+    if (clearRequested.exchange(false, std::memory_order_acq_rel))
+    {
+        eventQueue.clear();
+    }
 }
 
 Keypad *InputHub::getKeypad()
@@ -223,7 +264,9 @@ bool InputHub::startGestureCapture(bool enableRecognition)
     }
     gestureDevice->setRecognitionEnabled(enableRecognition);
     gestureDevice->clearLastGesture();
-    return gestureDevice->startCapture();
+    bool started = gestureDevice->startCapture();
+    LoopWake::notify(LoopWake::WAKE_TASK); // Start polling the capture (tickless mode)
+    return started;
 }
 
 bool InputHub::stopGestureCapture()
@@ -232,7 +275,9 @@ bool InputHub::stopGestureCapture()
     {
         return false;
     }
-    return gestureDevice->stopCapture();
+    bool stopped = gestureDevice->stopCapture();
+    LoopWake::notify(LoopWake::WAKE_TASK); // Recognise without waiting for the idle timeout
+    return stopped;
 }
 
 bool InputHub::isGestureCapturing() const
@@ -268,14 +313,19 @@ void InputHub::clearLastGesture()
 
 void InputHub::enqueue(const InputEvent &event)
 {
-    if (eventQueue.size() >= MAX_QUEUE_SIZE)
+    TimedEvent timedEvent{event, millis()};
+    if (!eventQueue.push(timedEvent))
     {
-        Logger::getInstance().log("InputHub queue full, dropping event");
+        droppedEvents++;
+        Logger::getInstance().log("InputHub queue full, dropping event (" + String(droppedEvents) + " dropped)");
         return;
     }
+    InputTrace::getInstance().record(timedEvent);
 
-    TimedEvent timedEvent{event, millis()};
-    eventQueue.push_back(timedEvent);
+    if (event.type == InputEvent::EventType::KEY_PRESS && event.state)
+    {
+        LatencyTracer::getInstance().mark(LatencyTracer::STAGE_ENQUEUE);
+    }
 }
 
 void InputHub::scanKeypad()
@@ -285,7 +335,25 @@ void InputHub::scanKeypad()
         return;
     }
 
-    while (keypad->processInput())
+    if (!keypad->processInput())
+    {
+        return;
+    }
+
+    // A scan batch enters the queue whole, so chords are seen in the same tick
+    size_t batchSize = keypad->pendingEvents();
+    if (batchSize > eventQueue.freeSpace())
+    {
+        droppedEvents += batchSize;
+        Logger::getInstance().log("InputHub queue full, dropping key batch");
+        for (size_t i = 0; i < batchSize; i++)
+        {
+            keypad->getEvent();
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < batchSize; i++)
     {
         enqueue(keypad->getEvent());
     }
@@ -317,6 +385,21 @@ void InputHub::scanGestures()
     }
 }
 
+void InputHub::scanReplay()
+{
+    InputTrace &trace = InputTrace::getInstance();
+    InputEvent event;
+    unsigned long now = millis();
+    while (eventQueue.freeSpace() > 0 && trace.nextReplayEvent(now, event))
+    {
+        if (event.type == InputEvent::EventType::KEY_PRESS && event.state)
+        {
+            LatencyTracer::getInstance().begin(); // Replayed press: trace starts at injection
+        }
+        enqueue(event);
+    }
+}
+
 void InputHub::setReactiveLightingEnabled(bool enable)
 {
     reactiveLighting.enable(enable);
@@ -2,11 +2,12 @@
 #define INPUT_HUB_H
 
 #include <Arduino.h>
-#include <deque>
+#include <atomic>
 #include <memory>
 #include <functional>
 
 #include "inputDevice.h"
+#include "EventRing.h"
 #include "ReactiveLightingController.h"
 
 class ConfigurationManager;
@@ -26,6 +27,10 @@ struct ComboSettings;
  * polled from the main loop. Events are collected in the order they
  * are generated to guarantee a deterministic delivery to the
  * MacroManager.
+ *
+ * The queue is a fixed single-producer/single-consumer ring of POD
+ * events: scanDevices() (or an ISR / scanning task) is the only producer,
+ * the poll family the only consumer.
  */
 class InputHub
 {
@@ -52,6 +57,15 @@ public:
      */
     void scanDevices();
 
+    /**
+     * @brief Milliseconds until scanDevices() has work no interrupt will signal.
+     *
+     * pollPeriodMs while a device must be polled (keypad scanning or
+     * debouncing, polled encoder, gesture capture), ULONG_MAX when every
+     * device is idle on its interrupt.
+     */
+    unsigned long getNextWakeDelayMs(unsigned long pollPeriodMs) const;
+
     /**
      * @brief Retrieve the next queued event.
      *
@@ -69,15 +83,28 @@ public:
     bool poll(TimedEvent &outEvent);
 
     /**
-     * @brief Retrieve the next event that matches the predicate.
+     * @brief Look at the next queued event without removing it.
+     */
+    bool peek(TimedEvent &outEvent) const;
+
+    /**
+     * @brief Drop the next queued event.
+     */
+    void skip();
+
+    /**
+     * @brief Retrieve the next event only if it matches the predicate.
      *
-     * Non-matching events are rotated to the back of the queue,
-     * preserving their relative order.
+     * O(1): a non-matching event stays at the head of the queue; callers
+     * that want to discard it use skip().
      */
     bool pollFiltered(const std::function<bool(const InputEvent &)> &predicate, TimedEvent &outEvent);
 
     /**
      * @brief Remove any queued events.
+     *
+     * Safe from any task: only a flag is set here, the consumer drops the
+     * queued events on its next poll, so the ring keeps a single consumer.
      */
     void clearQueue();
 
@@ -111,14 +138,18 @@ public:
     bool isGestureCaptureEnabled() const;
 
 private:
-    static constexpr size_t MAX_QUEUE_SIZE = 32;
+    static constexpr size_t MAX_QUEUE_SIZE = 32; // Power of two, see EventRing
 
     void enqueue(const InputEvent &event);
+    void applyClearRequest(); // Consumer side of clearQueue()
     void scanKeypad();
     void scanRotaryEncoder();
     void scanGestures();
+    void scanReplay();
 
-    std::deque<TimedEvent> eventQueue;
+    EventRing<TimedEvent, MAX_QUEUE_SIZE> eventQueue;
+    std::atomic<bool> clearRequested{false};
+    uint32_t droppedEvents = 0;
     std::unique_ptr<Keypad> keypad;
     std::unique_ptr<RotaryEncoder> rotaryEncoder;
     std::unique_ptr<IRSensor> irSensor;
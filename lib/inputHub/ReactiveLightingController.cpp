@@ -1,6 +1,7 @@
 #include "ReactiveLightingController.h"
 
 #include <algorithm>
+#include <limits.h>
 #include <cmath>
 
 #include "Logger.h"
@@ -198,6 +199,16 @@ void ReactiveLightingController::update()
     state.editMode = false;
 }
 
+unsigned long ReactiveLightingController::msUntilUpdate() const
+{
+    if (!state.enabled || !state.ledReactiveActive)
+    {
+        return ULONG_MAX;
+    }
+    const unsigned long currentTime = millis();
+    return currentTime < state.ledReactiveTime ? state.ledReactiveTime - currentTime : 0;
+}
+
 void ReactiveLightingController::scheduleRestore(unsigned long delayMs)
 {
     if (!state.enabled || !state.hasReactiveColor)
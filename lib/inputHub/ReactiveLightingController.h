@@ -15,6 +15,7 @@ public:
 
     void handleInput(uint8_t keyIndex, bool isEncoder, int encoderDirection, uint16_t activeKeysMask);
     void update();
+    unsigned long msUntilUpdate() const; // ULONG_MAX when no restore is pending
 
     void updateColors(const ComboSettings &settings);
     void saveColors() const;
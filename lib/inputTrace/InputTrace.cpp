@@ -0,0 +1,435 @@
+/*
+ * ESP32 MacroPad Project
+ * Copyright (C) [2025] [Enrico Mori]
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "InputTrace.h"
+#include "InputText.h"
+#include "LatencyTracer.h"
+#include "LoopWake.h"
+#include "Logger.h"
+#include <LittleFS.h>
+#include <limits.h>
+
+namespace
+{
+    const uint8_t TRACE_MAGIC[4] = {'M', 'P', 'T', 'R'};
+    const uint8_t TRACE_VERSION = 1;
+    const uint8_t KIND_GAP = 0x7E;
+    const uint8_t KIND_TEXT = 0x7F;
+    const uint8_t KIND_STATE = 0x80;
+    const size_t RECORD_SIZE = 8;
+
+    int16_t clampInt16(int value)
+    {
+        return static_cast<int16_t>(constrain(value, INT16_MIN, INT16_MAX));
+    }
+}
+
+InputTrace &InputTrace::getInstance()
+{
+    static InputTrace instance;
+    return instance;
+}
+
+InputTrace::InputTrace() {}
+
+void InputTrace::startRecording()
+{
+    if (recording.load())
+    {
+        return;
+    }
+    if (replayActive.load())
+    {
+        // The replayed trace would be truncated by the new recording
+        Logger::getInstance().log("Input trace: cannot record while replaying");
+        return;
+    }
+    pendingCount = 0;
+    openPending.store(true);
+    recording.store(true);
+    Logger::getInstance().log("Input trace: recording to " + String(INPUT_TRACE_PATH));
+}
+
+void InputTrace::stopRecording()
+{
+    if (!recording.load())
+    {
+        return;
+    }
+    commitPending();
+    recording.store(false);
+    closePending.store(true);
+}
+
+void InputTrace::requestReplay()
+{
+    if (replayActive.load())
+    {
+        Logger::getInstance().log("Input trace: replay already running");
+        return;
+    }
+    if (recording.load())
+    {
+        Logger::getInstance().log("Input trace: stop recording before replaying");
+        return;
+    }
+    replayRequested.store(true);
+}
+
+void InputTrace::stopReplay()
+{
+    if (replayActive.load())
+    {
+        replayStopRequested.store(true);
+    }
+}
+
+void InputTrace::discardTrigger()
+{
+    pendingCount = 0;
+    ignoredKeys |= heldKeys;
+    ignoredButton = ignoredButton || buttonHeld;
+}
+
+bool InputTrace::trackHeld(const InputEvent &event)
+{
+    if (event.type == InputEvent::EventType::KEY_PRESS && event.value1 >= 0 && event.value1 < 32)
+    {
+        const uint32_t bit = 1UL << event.value1;
+        heldKeys = event.state ? heldKeys | bit : heldKeys & ~bit;
+        if (ignoredKeys & bit)
+        {
+            if (!event.state)
+            {
+                ignoredKeys &= ~bit;
+            }
+            return true;
+        }
+    }
+    else if (event.type == InputEvent::EventType::BUTTON)
+    {
+        buttonHeld = event.state;
+        if (ignoredButton)
+        {
+            ignoredButton = event.state;
+            return true;
+        }
+    }
+    return false;
+}
+
+void InputTrace::record(const InputHub::TimedEvent &event)
+{
+    // Held keys are tracked even when idle: the chord that starts a
+    // recording is still down when the command runs
+    const bool chordDone = heldKeys == 0 && !buttonHeld;
+    if (trackHeld(event.event) || !recording.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    if (chordDone || pendingCount == PENDING_CAPACITY)
+    {
+        commitPending();
+    }
+    pendingEvents[pendingCount++] = event;
+}
+
+void InputTrace::commitPending()
+{
+    for (size_t i = 0; i < pendingCount; i++)
+    {
+        if (!recordRing.push(pendingEvents[i]))
+        {
+            droppedRecords++; // Background task fell behind
+        }
+    }
+    pendingCount = 0;
+}
+
+void InputTrace::service()
+{
+    if (openPending.exchange(false))
+    {
+        openRecording();
+    }
+    if (fileOpen)
+    {
+        flushRecording();
+    }
+    if (closePending.exchange(false))
+    {
+        closeRecording();
+    }
+    if (replayRequested.exchange(false))
+    {
+        loadReplay();
+    }
+}
+
+void InputTrace::openRecording()
+{
+    if (fileOpen)
+    {
+        closeRecording();
+    }
+
+    traceFile = LittleFS.open(INPUT_TRACE_PATH, "w");
+    if (!traceFile)
+    {
+        Logger::getInstance().log("Input trace: cannot open " + String(INPUT_TRACE_PATH));
+        recording.store(false);
+        return;
+    }
+
+    uint8_t header[8] = {TRACE_MAGIC[0], TRACE_MAGIC[1], TRACE_MAGIC[2], TRACE_MAGIC[3], TRACE_VERSION, 0, 0, 0};
+    traceFile.write(header, sizeof(header));
+    fileOpen = true;
+    writeLength = 0;
+    recordedCount = 0;
+    droppedRecords = 0;
+    writtenTextIds = 0;
+    lastRecordTime = 0;
+}
+
+void InputTrace::appendBytes(const uint8_t *data, size_t length)
+{
+    while (length > 0)
+    {
+        if (writeLength == sizeof(writeBuffer))
+        {
+            traceFile.write(writeBuffer, writeLength);
+            writeLength = 0;
+        }
+        size_t chunk = std::min(length, sizeof(writeBuffer) - writeLength);
+        memcpy(writeBuffer + writeLength, data, chunk);
+        writeLength += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+void InputTrace::writeRecord(uint16_t deltaMs, uint8_t kind, uint8_t textId, int16_t value1, int16_t value2)
+{
+    uint8_t record[RECORD_SIZE] = {
+        static_cast<uint8_t>(deltaMs & 0xFF), static_cast<uint8_t>(deltaMs >> 8),
+        kind, textId,
+        static_cast<uint8_t>(value1 & 0xFF), static_cast<uint8_t>((value1 >> 8) & 0xFF),
+        static_cast<uint8_t>(value2 & 0xFF), static_cast<uint8_t>((value2 >> 8) & 0xFF)};
+    appendBytes(record, sizeof(record));
+}
+
+void InputTrace::flushRecording()
+{
+    InputHub::TimedEvent timed;
+    while (recordRing.pop(timed))
+    {
+        const InputEvent &event = timed.event;
+
+        // Define a text the first time an event uses it
+        uint8_t textId = 0;
+        if (event.textId != InputText::NONE && event.textId <= 64)
+        {
+            textId = event.textId;
+            uint64_t bit = 1ULL << (textId - 1);
+            if (!(writtenTextIds & bit))
+            {
+                const char *name = InputText::lookup(event.textId);
+                size_t length = std::min<size_t>(strlen(name), 255);
+                writeRecord(0, KIND_TEXT, textId, static_cast<int16_t>(length), 0);
+                appendBytes(reinterpret_cast<const uint8_t *>(name), length);
+                writtenTextIds |= bit;
+            }
+        }
+
+        unsigned long delta = recordedCount == 0 ? 0 : timed.timestamp - lastRecordTime;
+        while (delta > 0xFFFF)
+        {
+            writeRecord(0xFFFF, KIND_GAP, 0, 0, 0);
+            delta -= 0xFFFF;
+        }
+
+        uint8_t kind = static_cast<uint8_t>(event.type) | (event.state ? KIND_STATE : 0);
+        writeRecord(static_cast<uint16_t>(delta), kind, textId, clampInt16(event.value1), clampInt16(event.value2));
+        lastRecordTime = timed.timestamp;
+        recordedCount++;
+    }
+
+    if (writeLength > 0)
+    {
+        traceFile.write(writeBuffer, writeLength);
+        writeLength = 0;
+    }
+}
+
+void InputTrace::closeRecording()
+{
+    if (!fileOpen)
+    {
+        return;
+    }
+    flushRecording();
+    traceFile.close();
+    fileOpen = false;
+    Logger::getInstance().log("Input trace: saved " + String(recordedCount) + " events (" +
+                              String(droppedRecords) + " dropped)");
+}
+
+void InputTrace::loadReplay()
+{
+    if (replayActive.load())
+    {
+        return;
+    }
+
+    File file = LittleFS.open(INPUT_TRACE_PATH, "r");
+    if (!file)
+    {
+        Logger::getInstance().log("Input trace: no trace at " + String(INPUT_TRACE_PATH));
+        return;
+    }
+
+    uint8_t header[8];
+    if (file.read(header, sizeof(header)) != sizeof(header) ||
+        memcmp(header, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 || header[4] != TRACE_VERSION)
+    {
+        Logger::getInstance().log("Input trace: unsupported trace file");
+        file.close();
+        return;
+    }
+
+    replayEvents.clear();
+    replayTexts.clear();
+    uint32_t offsetMs = 0;
+    uint8_t record[RECORD_SIZE];
+    while (file.read(record, sizeof(record)) == sizeof(record))
+    {
+        uint16_t deltaMs = record[0] | (record[1] << 8);
+        uint8_t kind = record[2];
+        uint8_t textId = record[3];
+        int16_t value1 = static_cast<int16_t>(record[4] | (record[5] << 8));
+        int16_t value2 = static_cast<int16_t>(record[6] | (record[7] << 8));
+        offsetMs += deltaMs;
+
+        if (kind == KIND_GAP)
+        {
+            continue;
+        }
+        if (kind == KIND_TEXT)
+        {
+            char name[256];
+            size_t length = static_cast<uint16_t>(value1) & 0xFF;
+            if (textId == 0 || file.read(reinterpret_cast<uint8_t *>(name), length) != length)
+            {
+                break;
+            }
+            name[length] = '\0';
+            if (replayTexts.size() < textId)
+            {
+                replayTexts.resize(textId);
+            }
+            replayTexts[textId - 1] = name;
+            continue;
+        }
+        if (replayEvents.size() >= INPUT_TRACE_MAX_REPLAY)
+        {
+            Logger::getInstance().log("Input trace: replay truncated to " + String(INPUT_TRACE_MAX_REPLAY) + " events");
+            break;
+        }
+
+        ReplayEvent replay;
+        replay.offsetMs = offsetMs;
+        replay.event.type = static_cast<InputEvent::EventType>(kind & ~KIND_STATE);
+        replay.event.state = (kind & KIND_STATE) != 0;
+        replay.event.value1 = value1;
+        replay.event.value2 = value2;
+        replay.traceTextId = textId;
+        replayEvents.push_back(replay);
+    }
+    file.close();
+
+    if (replayEvents.empty())
+    {
+        Logger::getInstance().log("Input trace: trace is empty");
+        return;
+    }
+
+    Logger::getInstance().log("Input trace: replaying " + String(replayEvents.size()) + " events over " +
+                              String(replayEvents.back().offsetMs) + " ms");
+    replayIndex = 0;
+    replayStarted = false;
+    replayStopRequested.store(false);
+    LatencyTracer::getInstance().reset();
+    replayActive.store(true, std::memory_order_release);
+    LoopWake::notify(LoopWake::WAKE_TASK);
+}
+
+bool InputTrace::nextReplayEvent(unsigned long now, InputEvent &outEvent)
+{
+    if (!replayActive.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+    if (replayStopRequested.exchange(false) || replayIndex >= replayEvents.size())
+    {
+        finishReplay(now);
+        return false;
+    }
+    if (!replayStarted)
+    {
+        replayStart = now;
+        replayStarted = true;
+    }
+
+    const ReplayEvent &next = replayEvents[replayIndex];
+    if (now - replayStart < next.offsetMs)
+    {
+        return false;
+    }
+
+    outEvent = next.event;
+    if (next.traceTextId != 0 && next.traceTextId <= replayTexts.size())
+    {
+        outEvent.textId = InputText::intern(replayTexts[next.traceTextId - 1]);
+    }
+    replayIndex++;
+    return true;
+}
+
+unsigned long InputTrace::msUntilNextReplay(unsigned long now) const
+{
+    if (!replayActive.load(std::memory_order_acquire))
+    {
+        return ULONG_MAX;
+    }
+    if (!replayStarted || replayIndex >= replayEvents.size())
+    {
+        return 0;
+    }
+    unsigned long elapsed = now - replayStart;
+    uint32_t offsetMs = replayEvents[replayIndex].offsetMs;
+    return elapsed >= offsetMs ? 0 : offsetMs - elapsed;
+}
+
+void InputTrace::finishReplay(unsigned long now)
+{
+    Logger::getInstance().log("Input trace: replay of " + String(replayIndex) + " events finished in " +
+                              String(replayStarted ? now - replayStart : 0) + " ms");
+    LatencyTracer::getInstance().dump();
+    replayActive.store(false, std::memory_order_release);
+}
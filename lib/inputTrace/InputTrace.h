@@ -0,0 +1,121 @@
+#ifndef INPUT_TRACE_H
+#define INPUT_TRACE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <atomic>
+#include <vector>
+#include "InputHub.h"
+#include "EventRing.h"
+
+#ifndef INPUT_TRACE_PATH
+    #define INPUT_TRACE_PATH "/input_trace.bin"
+#endif
+
+#ifndef INPUT_TRACE_MAX_REPLAY
+    #define INPUT_TRACE_MAX_REPLAY 1024 // Events loaded for one replay (8 bytes each)
+#endif
+
+/**
+ * @brief Record the InputHub event stream to LittleFS and play it back.
+ *
+ * Recording: InputHub::enqueue copies every TimedEvent into a RAM ring;
+ * the background task writes it to INPUT_TRACE_PATH in service(), so the
+ * input task never touches the filesystem. Events are held back until
+ * every key is up again, so the chord that runs TRACE_RECORD or
+ * TRACE_REPLAY can be dropped by discardTrigger() and never reaches the
+ * trace: replaying it would stop the replay or restart the recording.
+ *
+ * Replay: service() loads the trace, then InputHub::scanDevices injects
+ * each event into the queue at its original offset from the start of the
+ * replay. MacroManager sees the same events in the same order, which
+ * makes combo-ordering problems reproducible and lets LATENCY_INFO
+ * measure the macro engine on a known input.
+ *
+ * File format (little endian): "MPTR", version byte, 3 reserved bytes,
+ * then 8-byte records:
+ *   uint16 deltaMs  since the previous record
+ *   uint8  kind     event type, bit 7 = state; 0x7E gap, 0x7F text
+ *   uint8  textId   trace-local text id, 0 = none
+ *   int16  value1, int16 value2
+ * A text record (kind 0x7F) defines textId; value1 is the name length
+ * and the name bytes follow. Gaps over 65535 ms use gap records.
+ */
+class InputTrace
+{
+public:
+    static InputTrace &getInstance();
+
+    // Input task (commands)
+    void startRecording();
+    void stopRecording();
+    void requestReplay();
+    void stopReplay();
+    void discardTrigger(); // Drop the held-back chord that ran the command and its releases
+    bool isRecording() const { return recording.load(); }
+    bool isReplaying() const { return replayActive.load(); }
+
+    // Input task, from InputHub
+    void record(const InputHub::TimedEvent &event);
+    bool nextReplayEvent(unsigned long now, InputEvent &outEvent);
+    unsigned long msUntilNextReplay(unsigned long now) const; // ULONG_MAX when not replaying
+
+    // Background task: file writes and replay loading
+    void service();
+
+private:
+    InputTrace();
+
+    struct ReplayEvent
+    {
+        uint32_t offsetMs;
+        InputEvent event;
+        uint8_t traceTextId;
+    };
+
+    void openRecording();
+    void flushRecording();
+    void closeRecording();
+    void loadReplay();
+    void writeRecord(uint16_t deltaMs, uint8_t kind, uint8_t textId, int16_t value1, int16_t value2);
+    void appendBytes(const uint8_t *data, size_t length);
+    void finishReplay(unsigned long now);
+    bool trackHeld(const InputEvent &event); // True when the event belongs to a discarded trigger
+    void commitPending();
+
+    static const size_t PENDING_CAPACITY = 16;
+
+    // Recording
+    std::atomic<bool> recording{false};
+    std::atomic<bool> openPending{false};
+    std::atomic<bool> closePending{false};
+    EventRing<InputHub::TimedEvent, 64> recordRing;
+    uint32_t droppedRecords = 0;
+    File traceFile;
+    bool fileOpen = false;
+    unsigned long lastRecordTime = 0;
+    uint32_t recordedCount = 0;
+    uint64_t writtenTextIds = 0; // Interned ids already defined in the file
+    uint8_t writeBuffer[256];
+    size_t writeLength = 0;
+
+    // Input task: chord being typed, and keys whose events are not recorded
+    InputHub::TimedEvent pendingEvents[PENDING_CAPACITY];
+    size_t pendingCount = 0;
+    uint32_t heldKeys = 0;
+    bool buttonHeld = false;
+    uint32_t ignoredKeys = 0;
+    bool ignoredButton = false;
+
+    // Replay: filled by the background task, consumed by the input task
+    std::atomic<bool> replayRequested{false};
+    std::atomic<bool> replayActive{false};
+    std::atomic<bool> replayStopRequested{false};
+    std::vector<ReplayEvent> replayEvents;
+    std::vector<String> replayTexts; // Index = trace text id - 1
+    size_t replayIndex = 0;
+    unsigned long replayStart = 0;
+    bool replayStarted = false;
+};
+
+#endif // INPUT_TRACE_H
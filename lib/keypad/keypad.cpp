@@ -18,96 +18,259 @@
 
 
 #include "keypad.h"
+#include "ComboIndex.h"
+#include "LatencyTracer.h"
+#include "LoopWake.h"
+#include "Logger.h"
+#include <esp_timer.h>
+#include <soc/gpio_reg.h>
+#include <soc/soc.h>
+
+// A key past the combo key mask would be scanned but could never match a combo
+static_assert(KEYPAD_MAX_KEYS == ComboIndex::MAX_KEYS, "KEYPAD_MAX_KEYS must match ComboIndex::MAX_KEYS");
 
 Keypad::Keypad(const KeypadConfig* config) : config(config) {
-    // Initialize key state tracking arrays
-    keyStates = new bool*[config->rows];
-    lastKeyStates = new bool*[config->rows];
-    lastKeyTime = new unsigned long*[config->rows];
-    
-    for (byte r = 0; r < config->rows; r++) {
-        keyStates[r] = new bool[config->cols]();
-        lastKeyStates[r] = new bool[config->cols]();
-        lastKeyTime[r] = new unsigned long[config->cols]();
+    keyCount = config->rows * config->cols;
+    if (keyCount > KEYPAD_MAX_KEYS) {
+        Logger::getInstance().log("Keypad: only the first " + String(KEYPAD_MAX_KEYS) + " keys are scanned");
+        keyCount = KEYPAD_MAX_KEYS;
     }
 }
 
 Keypad::~Keypad() {
-    // Clean up dynamically allocated arrays
-    for (byte r = 0; r < config->rows; r++) {
-        delete[] keyStates[r];
-        delete[] lastKeyStates[r];
-        delete[] lastKeyTime[r];
-    }
-    delete[] keyStates;
-    delete[] lastKeyStates;
-    delete[] lastKeyTime;
+    if (interruptsAttached) {
+        for (byte pin : *sensePins) {
+            detachInterrupt(pin);
+        }
+    }
 }
 
 void Keypad::setup() {
     if (!config->invertDirection) {
-        // Configure columns as outputs and rows as inputs
-        for (byte c = 0; c < config->cols; c++) {
-            pinMode(config->colPins[c], OUTPUT);
-            digitalWrite(config->colPins[c], HIGH);
-        }
-        for (byte r = 0; r < config->rows; r++) {
-            pinMode(config->rowPins[r], INPUT_PULLUP);
-        }
+        drivePins = &config->colPins;
+        sensePins = &config->rowPins;
     } else {
-        // Configure rows as outputs and columns as inputs
-        for (byte r = 0; r < config->rows; r++) {
-            pinMode(config->rowPins[r], OUTPUT);
-            digitalWrite(config->rowPins[r], HIGH);
+        drivePins = &config->rowPins;
+        sensePins = &config->colPins;
+    }
+
+    // Drive lines as outputs, sense lines as inputs with pull-up
+    for (byte pin : *drivePins) {
+        pinMode(pin, OUTPUT);
+        digitalWrite(pin, HIGH);
+    }
+    for (byte pin : *sensePins) {
+        pinMode(pin, INPUT_PULLUP);
+    }
+
+    if (config->interruptScan) {
+        for (byte pin : *sensePins) {
+            attachInterruptArg(pin, onSenseEdge, this, FALLING);
         }
-        for (byte c = 0; c < config->cols; c++) {
-            pinMode(config->colPins[c], INPUT_PULLUP);
+        interruptsAttached = true;
+        enterIdle();
+    } else {
+        scanning = true; // Poll the matrix on every call
+    }
+}
+
+void IRAM_ATTR Keypad::onSenseEdge(void* arg) {
+    Keypad* keypad = static_cast<Keypad*>(arg);
+    if (!keypad->edgePending) {
+        keypad->edgeTimeUs = esp_timer_get_time();
+        keypad->edgePending = true;
+    }
+    // While scanning the scan itself pulls sense lines low: only an idle matrix wakes the loop
+    if (!keypad->scanning) {
+        LoopWake::notifyFromISR(LoopWake::WAKE_KEYPAD);
+    }
+}
+
+inline void Keypad::writePin(byte pin, bool level) {
+    if (pin < 32) {
+        REG_WRITE(level ? GPIO_OUT_W1TS_REG : GPIO_OUT_W1TC_REG, 1UL << pin);
+    } else {
+        REG_WRITE(level ? GPIO_OUT1_W1TS_REG : GPIO_OUT1_W1TC_REG, 1UL << (pin - 32));
+    }
+}
+
+// GPIO 0-31 in the low word, 32-39 in the high word
+inline uint64_t Keypad::readInputs() {
+    return static_cast<uint64_t>(REG_READ(GPIO_IN_REG)) |
+           (static_cast<uint64_t>(REG_READ(GPIO_IN1_REG)) << 32);
+}
+
+void Keypad::enterIdle() {
+    scanning = false;
+    edgePending = false;
+
+    // Every drive line low: any press pulls its sense line low and fires the interrupt
+    for (byte pin : *drivePins) {
+        writePin(pin, LOW);
+    }
+    delayMicroseconds(KEYPAD_SETTLE_US);
+
+    // A key pressed before the lines went low may not produce an edge
+    uint64_t inputs = readInputs();
+    for (byte pin : *sensePins) {
+        if (!(inputs & (1ULL << pin))) {
+            edgeTimeUs = esp_timer_get_time();
+            edgePending = true;
+            break;
         }
     }
 }
 
+void Keypad::leaveIdle() {
+    for (byte pin : *drivePins) {
+        writePin(pin, HIGH);
+    }
+    scanning = true;
+}
+
 bool Keypad::processInput() {
-    for (byte r = 0; r < config->rows; r++) {
-        for (byte c = 0; c < config->cols; c++) {
-            bool currentState;
-            
-            // Read key state based on diode direction
-            if (!config->invertDirection) {
-                digitalWrite(config->colPins[c], LOW);
-                currentState = (digitalRead(config->rowPins[r]) == LOW);
-                digitalWrite(config->colPins[c], HIGH);
-            } else {
-                digitalWrite(config->rowPins[r], LOW);
-                currentState = (digitalRead(config->colPins[c]) == LOW);
-                digitalWrite(config->rowPins[r], HIGH);
+    if (batchChanged) {
+        return true; // Previous scan still has transitions to hand out
+    }
+
+    if (!scanning) {
+        if (!edgePending) {
+            return false; // Idle: nothing touched the matrix
+        }
+        leaveIdle();
+        pressStartUs = edgeTimeUs;
+    }
+    edgePending = false;
+
+    scanMatrix();
+    if (!batchChanged && !matrixBusy && interruptsAttached) {
+        enterIdle();
+    }
+    return batchChanged != 0;
+}
+
+// Sample every key once; bit set = key closed
+uint32_t Keypad::readMatrix() {
+    byte driveCount = drivePins->size();
+    byte senseCount = sensePins->size();
+    uint32_t raw = 0;
+
+    for (byte d = 0; d < driveCount; d++) {
+        byte drivePin = (*drivePins)[d];
+        writePin(drivePin, LOW);
+        delayMicroseconds(KEYPAD_SETTLE_US);
+        uint64_t inputs = readInputs(); // All sense lines in one read
+        writePin(drivePin, HIGH);
+
+        for (byte s = 0; s < senseCount; s++) {
+            if (inputs & (1ULL << (*sensePins)[s])) {
+                continue; // Pulled up: open
+            }
+            byte r = config->invertDirection ? d : s;
+            byte c = config->invertDirection ? s : d;
+            byte key = r * config->cols + c;
+            if (r < config->rows && c < config->cols && key < keyCount) {
+                raw |= (1UL << key);
+            }
+        }
+    }
+    return raw;
+}
+
+// Apply the configured debounce to a raw sample; returns the keys that changed
+uint32_t Keypad::debounce(uint32_t raw) {
+    uint16_t now = static_cast<uint16_t>(millis());
+    uint32_t rawChanged = raw ^ rawState;
+    rawState = raw;
+
+    uint32_t accepted = 0;
+    for (byte key = 0; key < keyCount; key++) {
+        uint32_t bit = 1UL << key;
+        bool level = raw & bit;
+        bool reported = debouncedState & bit;
+        uint16_t elapsed = now - changeTime[key];
+
+        switch (config->debounceMode) {
+        case KeyDebounceMode::EAGER:
+            // changeTime = last accepted change
+            if (level != reported && elapsed > config->debounceMs) {
+                changeTime[key] = now;
+                accepted |= bit;
+            }
+            break;
+
+        case KeyDebounceMode::DEFER:
+            // changeTime = last raw change
+            if (rawChanged & bit) {
+                changeTime[key] = now;
+                elapsed = 0;
+            }
+            if (level != reported && elapsed >= config->debounceMs) {
+                accepted |= bit;
             }
+            break;
 
-            // Debounce check
-            if (currentState != lastKeyStates[r][c] && 
-                (millis() - lastKeyTime[r][c]) > KEY_DEBOUNCE_TIME) {
-                
-                lastKeyTime[r][c] = millis();
-                lastKeyStates[r][c] = currentState;
-                
-                if (currentState != keyStates[r][c]) {
-                    keyStates[r][c] = currentState;
-                    
-                    // Store key event
-                    currentEvent.type = InputEvent::EventType::KEY_PRESS;
-                    currentEvent.value1 = r * config->cols + c; // Unique key code
-                    currentEvent.value2 = config->keys[r][c];   // Key character
-                    currentEvent.state = currentState;
-                    currentEvent.text = "";
-                    hasEvent = true;
-                    return true;
-                }
+        case KeyDebounceMode::ASYMMETRIC:
+            if (rawChanged & bit) {
+                changeTime[key] = now;
+                elapsed = 0;
             }
+            if (level && !reported) {
+                accepted |= bit; // Press at once
+            } else if (!level && reported && elapsed >= config->debounceMs) {
+                accepted |= bit; // Release once stable
+            }
+            break;
+
+        case KeyDebounceMode::INTEGRATOR:
+            if (level && integrator[key] < config->debounceSamples) {
+                integrator[key]++;
+            } else if (!level && integrator[key] > 0) {
+                integrator[key]--;
+            }
+            if ((integrator[key] == config->debounceSamples && !reported) ||
+                (integrator[key] == 0 && reported)) {
+                accepted |= bit;
+            }
+            break;
+        }
+    }
+
+    debouncedState ^= accepted;
+
+    // Keep scanning while a key is down or a change is still settling
+    matrixBusy = debouncedState != 0 || raw != debouncedState;
+    if (config->debounceMode == KeyDebounceMode::INTEGRATOR) {
+        for (byte key = 0; key < keyCount && !matrixBusy; key++) {
+            matrixBusy = integrator[key] != 0;
         }
     }
-    return false;
+
+    return accepted;
+}
+
+void Keypad::scanMatrix() {
+    batchChanged = debounce(readMatrix());
+
+    if (batchChanged & debouncedState) {
+        LatencyTracer::getInstance().begin(pressStartUs);
+        pressStartUs = 0;
+    }
 }
 
 InputEvent Keypad::getEvent() {
-    hasEvent = false;
-    return currentEvent;
+    InputEvent event;
+    if (!batchChanged) {
+        return event;
+    }
+
+    byte key = __builtin_ctz(batchChanged);
+    batchChanged &= batchChanged - 1;
+
+    byte cols = config->cols;
+    event.type = InputEvent::EventType::KEY_PRESS;
+    event.value1 = key;                                // Unique key code
+    event.value2 = config->keys[key / cols][key % cols]; // Key character
+    event.state = (debouncedState >> key) & 1;
+    return event;
 }
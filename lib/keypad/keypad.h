@@ -24,24 +24,70 @@
 #include "inputDevice.h"
 #include "configManager.h"
 
+#ifndef KEYPAD_SETTLE_US
+    #define KEYPAD_SETTLE_US 3 // Sense lines settle time after driving a line low
+#endif
+
+#define KEYPAD_MAX_KEYS 16 // Keys a combo can address (ComboIndex::MAX_KEYS); one bit each in the state words
+
 class Keypad : public InputDevice {
 private:
-    InputEvent currentEvent;
-    bool hasEvent = false;
     const KeypadConfig* config;
-    
-    // Key state tracking
-    bool** keyStates;
-    bool** lastKeyStates;
-    unsigned long** lastKeyTime;
-    static const unsigned long KEY_DEBOUNCE_TIME = 10;
+    byte keyCount;
+
+    // Bit-packed key state, bit = row * cols + col
+    uint32_t rawState = 0;       // Last sampled level
+    uint32_t debouncedState = 0; // Level reported to the rest of the firmware
+    uint16_t changeTime[KEYPAD_MAX_KEYS] = {}; // millis() low bits, meaning depends on the debounce mode
+    uint8_t integrator[KEYPAD_MAX_KEYS] = {};  // KeyDebounceMode::INTEGRATOR
+
+    // Transitions found by the last scan, handed out one per getEvent()
+    uint32_t batchChanged = 0;
+
+    // Drive lines are pulled low one at a time; sense lines are read together
+    // with a single GPIO input register read. Columns drive and rows sense,
+    // or the other way round when invertDirection is set.
+    const std::vector<byte>* drivePins;
+    const std::vector<byte>* sensePins;
+
+    // Idle: every drive line low and an interrupt on the sense lines, so a
+    // press is noticed without scanning. Active scan runs only while a key is
+    // down or debouncing.
+    volatile bool edgePending = false;
+    volatile int64_t edgeTimeUs = 0;
+    volatile bool scanning = false;
+    bool interruptsAttached = false;
+    bool matrixBusy = false;   // A key is down or debouncing
+    int64_t pressStartUs = 0;  // Edge time of the press that woke the scan
+
+    static void IRAM_ATTR onSenseEdge(void* arg);
+    void enterIdle();
+    void leaveIdle();
+    uint32_t readMatrix();
+    void scanMatrix();
+    uint32_t debounce(uint32_t raw);
+    static inline void writePin(byte pin, bool level);
+    static inline uint64_t readInputs();
 
 public:
     Keypad(const KeypadConfig* config);
     ~Keypad();
     void setup() override;
+
+    /**
+     * @brief Scan the whole matrix once and queue every debounced transition.
+     *
+     * Returns true while transitions of the last scan are waiting; each
+     * getEvent() hands out the next one, lowest key index first.
+     */
     bool processInput() override;
     InputEvent getEvent() override;
+
+    // Transitions still waiting in the current batch
+    uint8_t pendingEvents() const { return __builtin_popcount(batchChanged); }
+
+    // False while idle on the sense interrupt: nothing to scan until an edge
+    bool needsPolling() const { return scanning || batchChanged || edgePending; }
 };
 
 #endif
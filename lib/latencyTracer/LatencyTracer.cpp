@@ -0,0 +1,190 @@
+/*
+ * ESP32 MacroPad Project
+ * Copyright (C) [2025] [Enrico Mori]
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "LatencyTracer.h"
+#include <Logger.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/portmacro.h>
+#include <algorithm>
+
+namespace
+{
+    // Traces are written by the main loop and read by the web server task
+    portMUX_TYPE g_traceRingMux = portMUX_INITIALIZER_UNLOCKED;
+}
+
+LatencyTracer &LatencyTracer::getInstance()
+{
+    static LatencyTracer instance;
+    return instance;
+}
+
+LatencyTracer::LatencyTracer()
+    : currentStart(0),
+      traceOpen(false),
+      ringHead(0),
+      ringCount(0)
+{
+}
+
+void LatencyTracer::begin(int64_t startUs)
+{
+    if (traceOpen)
+    {
+        commit(); // Previous press never reached the HID stage
+    }
+
+    // The keypad passes the time of the GPIO edge that woke its scan
+    currentStart = startUs ? startUs : esp_timer_get_time();
+    for (uint8_t stage = 0; stage < STAGE_COUNT; stage++)
+    {
+        current.offsetUs[stage] = NOT_REACHED;
+    }
+    current.offsetUs[STAGE_SCAN] = 0;
+    traceOpen = true;
+}
+
+void LatencyTracer::mark(Stage stage)
+{
+    if (!traceOpen || current.offsetUs[stage] != NOT_REACHED)
+    {
+        return;
+    }
+    current.offsetUs[stage] = static_cast<uint32_t>(esp_timer_get_time() - currentStart);
+}
+
+void LatencyTracer::end()
+{
+    if (!traceOpen)
+    {
+        return;
+    }
+    mark(STAGE_HID);
+    commit();
+}
+
+void LatencyTracer::commit()
+{
+    portENTER_CRITICAL(&g_traceRingMux);
+    ring[ringHead] = current;
+    ringHead = (ringHead + 1) % LATENCY_TRACE_CAPACITY;
+    if (ringCount < LATENCY_TRACE_CAPACITY)
+    {
+        ringCount++;
+    }
+    portEXIT_CRITICAL(&g_traceRingMux);
+
+    traceOpen = false;
+}
+
+void LatencyTracer::reset()
+{
+    portENTER_CRITICAL(&g_traceRingMux);
+    ringHead = 0;
+    ringCount = 0;
+    portEXIT_CRITICAL(&g_traceRingMux);
+
+    traceOpen = false;
+}
+
+LatencyTracer::Percentiles LatencyTracer::getPercentiles(Stage stage) const
+{
+    uint32_t samples[LATENCY_TRACE_CAPACITY];
+    size_t sampleCount = 0;
+
+    portENTER_CRITICAL(&g_traceRingMux);
+    for (size_t i = 0; i < ringCount; i++)
+    {
+        uint32_t offset = ring[i].offsetUs[stage];
+        if (offset != NOT_REACHED)
+        {
+            samples[sampleCount++] = offset;
+        }
+    }
+    portEXIT_CRITICAL(&g_traceRingMux);
+
+    Percentiles result = {0, 0, 0, 0, static_cast<uint16_t>(sampleCount)};
+    if (sampleCount == 0)
+    {
+        return result;
+    }
+
+    std::sort(samples, samples + sampleCount);
+
+    // Nearest-rank percentiles
+    auto rank = [sampleCount](uint32_t percent) -> size_t {
+        size_t index = (percent * sampleCount + 99) / 100;
+        return index > 0 ? index - 1 : 0;
+    };
+    result.p50 = samples[rank(50)];
+    result.p95 = samples[rank(95)];
+    result.p99 = samples[rank(99)];
+    result.max = samples[sampleCount - 1];
+    return result;
+}
+
+const char *LatencyTracer::stageName(Stage stage)
+{
+    switch (stage)
+    {
+    case STAGE_SCAN:
+        return "scan";
+    case STAGE_ENQUEUE:
+        return "enqueue";
+    case STAGE_DISPATCH:
+        return "dispatch";
+    case STAGE_COMMAND:
+        return "command";
+    case STAGE_BLE:
+        return "ble";
+    case STAGE_HID:
+        return "hid";
+    default:
+        return "?";
+    }
+}
+
+void LatencyTracer::toJson(JsonObject obj) const
+{
+    for (uint8_t stage = STAGE_ENQUEUE; stage < STAGE_COUNT; stage++)
+    {
+        Percentiles p = getPercentiles(static_cast<Stage>(stage));
+        JsonObject stageObj = obj.createNestedObject(stageName(static_cast<Stage>(stage)));
+        stageObj["p50_us"] = p.p50;
+        stageObj["p95_us"] = p.p95;
+        stageObj["p99_us"] = p.p99;
+        stageObj["max_us"] = p.max;
+        stageObj["n"] = p.samples;
+    }
+}
+
+void LatencyTracer::dump() const
+{
+    Logger::getInstance().log("Key latency from scan (us), last " + String(LATENCY_TRACE_CAPACITY) + " presses:");
+    for (uint8_t stage = STAGE_ENQUEUE; stage < STAGE_COUNT; stage++)
+    {
+        Percentiles p = getPercentiles(static_cast<Stage>(stage));
+        Logger::getInstance().log("  " + String(stageName(static_cast<Stage>(stage))) +
+                                  ": p50=" + String(p.p50) +
+                                  " p95=" + String(p.p95) +
+                                  " p99=" + String(p.p99) +
+                                  " max=" + String(p.max) +
+                                  " n=" + String(p.samples));
+    }
+}
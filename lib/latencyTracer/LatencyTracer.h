@@ -0,0 +1,83 @@
+#ifndef LATENCY_TRACER_H
+#define LATENCY_TRACER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#ifndef LATENCY_TRACE_CAPACITY
+    #define LATENCY_TRACE_CAPACITY 64 // Key presses kept for the percentiles
+#endif
+
+/**
+ * @brief End-to-end latency of key presses, from matrix scan to HID report.
+ *
+ * Keypad::processInput opens a trace when it detects a press; each stage
+ * of the pipeline marks the time (esp_timer_get_time) at which the press
+ * reached it, and BLEController closes the trace once the HID report has
+ * been sent. Closed traces go to a preallocated ring; percentiles are
+ * computed on demand for /status.json and the LATENCY_INFO command.
+ *
+ * Only one press is traced at a time: a new press closes the previous
+ * trace even if it never reached the HID stage (e.g. non-BLE commands),
+ * so the stages it did reach still count.
+ */
+class LatencyTracer
+{
+public:
+    enum Stage : uint8_t
+    {
+        STAGE_SCAN,     // GPIO edge or Keypad::processInput detection
+        STAGE_ENQUEUE,  // InputHub::enqueue
+        STAGE_DISPATCH, // MacroManager::handleInputEvent
+        STAGE_COMMAND,  // CommandFactory returned the command to press
+        STAGE_BLE,      // BLEController::execute started
+        STAGE_HID,      // Keyboard/Mouse calls returned
+        STAGE_COUNT
+    };
+
+    struct Percentiles
+    {
+        uint32_t p50;
+        uint32_t p95;
+        uint32_t p99;
+        uint32_t max;
+        uint16_t samples;
+    };
+
+    static LatencyTracer &getInstance();
+
+    void begin(int64_t startUs = 0); // Open a trace for a new key press (0: now)
+    void mark(Stage stage);    // First time the open trace reaches stage
+    void end();                // HID report sent: close the open trace
+    void reset();
+
+    // Microseconds from the scan to stage over the traces in the ring
+    Percentiles getPercentiles(Stage stage) const;
+
+    void toJson(JsonObject obj) const;
+    void dump() const; // Log a summary (serial when enabled)
+
+    static const char *stageName(Stage stage);
+
+private:
+    LatencyTracer();
+
+    static constexpr uint32_t NOT_REACHED = 0xFFFFFFFF;
+
+    struct Trace
+    {
+        uint32_t offsetUs[STAGE_COUNT]; // From STAGE_SCAN, NOT_REACHED when skipped
+    };
+
+    void commit();
+
+    Trace current;
+    int64_t currentStart;
+    bool traceOpen;
+
+    Trace ring[LATENCY_TRACE_CAPACITY];
+    size_t ringHead;
+    size_t ringCount;
+};
+
+#endif // LATENCY_TRACER_H
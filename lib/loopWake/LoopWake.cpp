@@ -0,0 +1,170 @@
+/*
+ * ESP32 MacroPad Project
+ * Copyright (C) [2025] [Enrico Mori]
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "LoopWake.h"
+#include <Logger.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/portmacro.h>
+
+#define LOOP_WAKE_WINDOW_MS 1000
+
+namespace
+{
+    // Counters are updated by the input and background tasks
+    portMUX_TYPE g_wakeCountMux = portMUX_INITIALIZER_UNLOCKED;
+}
+
+TaskHandle_t LoopWake::waitingTask = nullptr;
+
+LoopWake &LoopWake::getInstance()
+{
+    static LoopWake instance;
+    return instance;
+}
+
+LoopWake::LoopWake()
+    : tickless(false),
+      windowStart(0)
+{
+    for (uint8_t cause = 0; cause < WAKE_CAUSE_COUNT; cause++)
+    {
+        total[cause] = 0;
+        windowStartCount[cause] = 0;
+        rate[cause] = 0;
+    }
+}
+
+void LoopWake::begin(TaskHandle_t task, bool ticklessMode)
+{
+    waitingTask = task;
+    tickless = ticklessMode;
+    windowStart = millis();
+}
+
+void IRAM_ATTR LoopWake::notifyFromISR(Cause cause)
+{
+    if (!waitingTask)
+    {
+        return;
+    }
+    BaseType_t higherPriorityWoken = pdFALSE;
+    xTaskNotifyFromISR(waitingTask, 1UL << cause, eSetBits, &higherPriorityWoken);
+    if (higherPriorityWoken)
+    {
+        portYIELD_FROM_ISR();
+    }
+}
+
+void LoopWake::notify(Cause cause)
+{
+    if (waitingTask)
+    {
+        xTaskNotify(waitingTask, 1UL << cause, eSetBits);
+    }
+}
+
+uint32_t LoopWake::wait(uint32_t timeoutMs)
+{
+    uint32_t bits = 0;
+    if (xTaskNotifyWait(0, 0xFFFFFFFF, &bits, pdMS_TO_TICKS(timeoutMs)) != pdTRUE || bits == 0)
+    {
+        bits = 1UL << WAKE_TIMER;
+    }
+
+    unsigned long now = millis();
+    portENTER_CRITICAL(&g_wakeCountMux);
+    for (uint8_t cause = 0; cause < WAKE_CAUSE_COUNT; cause++)
+    {
+        if (bits & (1UL << cause))
+        {
+            total[cause]++;
+        }
+    }
+    rollWindow(now);
+    portEXIT_CRITICAL(&g_wakeCountMux);
+    return bits;
+}
+
+void LoopWake::count(Cause cause)
+{
+    unsigned long now = millis();
+    portENTER_CRITICAL(&g_wakeCountMux);
+    total[cause]++;
+    rollWindow(now);
+    portEXIT_CRITICAL(&g_wakeCountMux);
+}
+
+void LoopWake::rollWindow(unsigned long now)
+{
+    unsigned long elapsed = now - windowStart;
+    if (elapsed < LOOP_WAKE_WINDOW_MS)
+    {
+        return;
+    }
+
+    for (uint8_t cause = 0; cause < WAKE_CAUSE_COUNT; cause++)
+    {
+        rate[cause] = ((total[cause] - windowStartCount[cause]) * 1000UL) / elapsed;
+        windowStartCount[cause] = total[cause];
+    }
+    windowStart = now;
+}
+
+const char *LoopWake::causeName(Cause cause)
+{
+    switch (cause)
+    {
+    case WAKE_KEYPAD:
+        return "keypad";
+    case WAKE_ENCODER:
+        return "encoder";
+    case WAKE_IMU:
+        return "imu";
+    case WAKE_TASK:
+        return "task";
+    case WAKE_TIMER:
+        return "timer";
+    case WAKE_SCHEDULER:
+        return "scheduler";
+    default:
+        return "?";
+    }
+}
+
+void LoopWake::toJson(JsonObject obj) const
+{
+    obj["tickless"] = tickless;
+    uint32_t sum = 0;
+    for (uint8_t cause = 0; cause < WAKE_CAUSE_COUNT; cause++)
+    {
+        obj[causeName(static_cast<Cause>(cause))] = rate[cause];
+        sum += rate[cause];
+    }
+    obj["total"] = sum;
+}
+
+void LoopWake::dump() const
+{
+    Logger::getInstance().log(String("Loop wakeups per second (") + (tickless ? "tickless" : "periodic") + "):");
+    for (uint8_t cause = 0; cause < WAKE_CAUSE_COUNT; cause++)
+    {
+        Logger::getInstance().log("  " + String(causeName(static_cast<Cause>(cause))) +
+                                  ": " + String(rate[cause]) + "/s (" + String(total[cause]) + " total)");
+    }
+}
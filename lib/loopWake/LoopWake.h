@@ -0,0 +1,79 @@
+#ifndef LOOP_WAKE_H
+#define LOOP_WAKE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#ifndef LOOP_WAKE_MAX_IDLE_MS
+    #define LOOP_WAKE_MAX_IDLE_MS 1000 // Longest tickless sleep with no deadline pending
+#endif
+
+/**
+ * @brief Wakeups of the input task in tickless mode.
+ *
+ * Instead of running every 5 ms, mainLoopTask blocks on its task
+ * notification until an ISR (keypad edge, encoder edge, IMU data ready),
+ * another task, or the nearest deadline of the input subsystems wakes it.
+ * Each source sets its own notification bit, so the loop knows why it
+ * woke; wakeups are counted per cause and reported as a rate per second
+ * in /status.json and by WAKE_INFO.
+ *
+ * Notifying is harmless when tickless mode is off: the periodic loop
+ * never waits on the notification and the bits are simply overwritten.
+ */
+class LoopWake
+{
+public:
+    enum Cause : uint8_t
+    {
+        WAKE_KEYPAD,    // Keypad sense line interrupt
+        WAKE_ENCODER,   // Encoder rotation or button interrupt
+        WAKE_IMU,       // Accelerometer data ready
+        WAKE_TASK,      // Another task handed work to the input task
+        WAKE_TIMER,     // Input task deadline (timeline, debounce, polling)
+        WAKE_SCHEDULER, // Background task woke for a scheduler deadline
+        WAKE_CAUSE_COUNT
+    };
+
+    static LoopWake &getInstance();
+
+    void begin(TaskHandle_t task, bool tickless); // Called by the task that waits
+    bool isTickless() const { return tickless; }
+
+    // Static so ISRs reach them without going through getInstance()
+    static void IRAM_ATTR notifyFromISR(Cause cause);
+    static void notify(Cause cause);
+
+    /**
+     * @brief Block the input task until notified or timeoutMs elapses.
+     *
+     * @return Bitmask of the causes (1 << Cause); WAKE_TIMER on timeout.
+     */
+    uint32_t wait(uint32_t timeoutMs);
+
+    // Count a wakeup that did not go through wait() (background task)
+    void count(Cause cause);
+
+    // Wakeups per second over the last full window
+    uint32_t getRate(Cause cause) const { return rate[cause]; }
+
+    void toJson(JsonObject obj) const;
+    void dump() const; // Log a summary (serial when enabled)
+
+    static const char *causeName(Cause cause);
+
+private:
+    LoopWake();
+
+    void rollWindow(unsigned long now);
+
+    static TaskHandle_t waitingTask;
+    bool tickless;
+
+    uint32_t total[WAKE_CAUSE_COUNT];
+    uint32_t windowStartCount[WAKE_CAUSE_COUNT];
+    uint32_t rate[WAKE_CAUSE_COUNT];
+    unsigned long windowStart;
+};
+
+#endif // LOOP_WAKE_H
@@ -0,0 +1,361 @@
+/*
+ * ESP32 MacroPad Project
+ * Copyright (C) [2025] [Enrico Mori]
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ComboIndex.h"
+#include <string.h>
+
+ComboIndex::ComboIndex()
+    : count(0),
+      slotMask(0)
+{
+    memset(labelToIndex, -1, sizeof(labelToIndex));
+    memset(indexToLabel, 0, sizeof(indexToLabel));
+}
+
+void ComboIndex::clear()
+{
+    slots.clear();
+    chordKeys.clear();
+    count = 0;
+    slotMask = 0;
+}
+
+uint64_t ComboIndex::appendToOrder(uint64_t order, uint8_t position, uint8_t keyIndex)
+{
+    return order | (static_cast<uint64_t>(keyIndex & 0x0F) << (position * 4));
+}
+
+uint64_t ComboIndex::orderFromMask(uint16_t mask)
+{
+    uint64_t order = 0;
+    uint8_t position = 0;
+    for (uint8_t key = 0; key < MAX_KEYS; key++)
+    {
+        if (mask & (1 << key))
+        {
+            order = appendToOrder(order, position++, key);
+        }
+    }
+    return order;
+}
+
+ComboIndex::Key ComboIndex::subset(const Key &key, uint16_t mask)
+{
+    Key result = {static_cast<uint16_t>(key.mask & mask), key.trigger, 0};
+    uint8_t keyCount = __builtin_popcount(key.mask);
+    uint8_t position = 0;
+    for (uint8_t i = 0; i < keyCount; i++)
+    {
+        uint8_t keyIndex = (key.order >> (i * 4)) & 0x0F;
+        if (result.mask & (1 << keyIndex))
+        {
+            result.order = appendToOrder(result.order, position++, keyIndex);
+        }
+    }
+    return result;
+}
+
+uint32_t ComboIndex::hashKey(const Key &key)
+{
+    uint64_t h = key.order * 0x9E3779B97F4A7C15ULL;
+    h ^= (static_cast<uint64_t>(key.mask) << 8) | key.trigger;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    return static_cast<uint32_t>(h >> 32);
+}
+
+bool ComboIndex::sameKey(const Key &a, const Key &b)
+{
+    return a.mask == b.mask && a.trigger == b.trigger && a.order == b.order;
+}
+
+// Parse "1+2,CW" into a key; returns false for anything that is not a key/encoder combination
+bool ComboIndex::parse(const std::string &comboName, Key &outKey) const
+{
+    outKey.mask = 0;
+    outKey.trigger = TRIGGER_NONE;
+    outKey.order = 0;
+
+    std::string keysPart = comboName;
+    size_t comma = comboName.find(',');
+    size_t colon = comboName.find(':');
+    if (colon != std::string::npos)
+    {
+        // Tap-dance entry: a single key followed by ":TAP", ":HOLD", ":DTAP" or ":TAPHOLD"
+        if (colon != 1 || comma != std::string::npos)
+        {
+            return false;
+        }
+        std::string triggerPart = comboName.substr(colon + 1);
+        if (triggerPart == "TAP")
+            outKey.trigger = TRIGGER_TAP;
+        else if (triggerPart == "HOLD")
+            outKey.trigger = TRIGGER_HOLD;
+        else if (triggerPart == "DTAP")
+            outKey.trigger = TRIGGER_DTAP;
+        else if (triggerPart == "TAPHOLD")
+            outKey.trigger = TRIGGER_TAPHOLD;
+        else
+            return false;
+        keysPart = comboName.substr(0, colon);
+    }
+    else if (comma != std::string::npos)
+    {
+        keysPart = comboName.substr(0, comma);
+        std::string triggerPart = comboName.substr(comma + 1);
+        if (keysPart.empty())
+        {
+            return false; // ",CW" is never produced at runtime
+        }
+        if (triggerPart == "BUTTON")
+            outKey.trigger = TRIGGER_BUTTON;
+        else if (triggerPart == "CW")
+            outKey.trigger = TRIGGER_CW;
+        else if (triggerPart == "CCW")
+            outKey.trigger = TRIGGER_CCW;
+        else
+            return false;
+    }
+    else if (comboName == "BUTTON")
+    {
+        outKey.trigger = TRIGGER_BUTTON;
+        return true;
+    }
+    else if (comboName == "CW")
+    {
+        outKey.trigger = TRIGGER_CW;
+        return true;
+    }
+    else if (comboName == "CCW")
+    {
+        outKey.trigger = TRIGGER_CCW;
+        return true;
+    }
+
+    // Keys are single-character labels separated by '+'
+    uint8_t position = 0;
+    size_t i = 0;
+    while (i < keysPart.length())
+    {
+        size_t plus = keysPart.find('+', i);
+        size_t tokenEnd = (plus == std::string::npos) ? keysPart.length() : plus;
+        if (tokenEnd - i != 1)
+        {
+            return false;
+        }
+
+        int8_t keyIndex = labelToIndex[static_cast<uint8_t>(keysPart[i])];
+        if (keyIndex < 0 || (outKey.mask & (1 << keyIndex)))
+        {
+            return false;
+        }
+        outKey.mask |= (1 << keyIndex);
+        outKey.order = appendToOrder(outKey.order, position++, keyIndex);
+
+        if (plus == std::string::npos)
+        {
+            break;
+        }
+        i = plus + 1;
+        if (i == keysPart.length())
+        {
+            return false; // Trailing '+'
+        }
+    }
+
+    return outKey.mask != 0;
+}
+
+void ComboIndex::build(const std::map<std::string, std::vector<std::string>> &combos, const KeypadConfig &keypadConfig)
+{
+    clear();
+
+    memset(labelToIndex, -1, sizeof(labelToIndex));
+    memset(indexToLabel, 0, sizeof(indexToLabel));
+    for (uint8_t row = 0; row < keypadConfig.rows && row < keypadConfig.keys.size(); row++)
+    {
+        for (uint8_t col = 0; col < keypadConfig.cols && col < keypadConfig.keys[row].size(); col++)
+        {
+            uint8_t keyIndex = row * keypadConfig.cols + col;
+            char label = keypadConfig.keys[row][col];
+            if (keyIndex >= MAX_KEYS || label == '\0')
+            {
+                continue;
+            }
+            indexToLabel[keyIndex] = label;
+            if (labelToIndex[static_cast<uint8_t>(label)] < 0)
+            {
+                labelToIndex[static_cast<uint8_t>(label)] = keyIndex;
+            }
+        }
+    }
+
+    // Keep the load factor at or below 50% so probe chains stay short
+    size_t capacity = 8;
+    while (capacity < combos.size() * 2)
+    {
+        capacity <<= 1;
+    }
+    Entry empty = {{0, TRIGGER_NONE, 0}, nullptr, nullptr};
+    slots.assign(capacity, empty);
+    slotMask = capacity - 1;
+
+    for (const auto &combo : combos)
+    {
+        Key key;
+        if (!parse(combo.first, key))
+        {
+            continue;
+        }
+
+        uint32_t slot = hashKey(key) & slotMask;
+        while (slots[slot].name != nullptr && !sameKey(slots[slot].key, key))
+        {
+            slot = (slot + 1) & slotMask;
+        }
+        if (slots[slot].name == nullptr)
+        {
+            count++;
+            if (key.trigger == TRIGGER_NONE || key.trigger == TRIGGER_BUTTON)
+            {
+                chordKeys.push_back(key);
+            }
+        }
+        slots[slot].key = key;
+        slots[slot].name = &combo.first;
+        slots[slot].actions = &combo.second;
+    }
+}
+
+const ComboIndex::Entry *ComboIndex::find(const Key &key) const
+{
+    if (slots.empty())
+    {
+        return nullptr;
+    }
+
+    uint32_t slot = hashKey(key) & slotMask;
+    while (slots[slot].name != nullptr)
+    {
+        if (sameKey(slots[slot].key, key))
+        {
+            return &slots[slot];
+        }
+        slot = (slot + 1) & slotMask;
+    }
+    return nullptr;
+}
+
+const ComboIndex::Entry *ComboIndex::findKey(uint8_t keyIndex, uint8_t trigger) const
+{
+    if (keyIndex >= MAX_KEYS)
+    {
+        return nullptr;
+    }
+    Key key = {static_cast<uint16_t>(1 << keyIndex), trigger, keyIndex};
+    return find(key);
+}
+
+bool ComboIndex::hasSuperset(const Key &key) const
+{
+    for (const Key &candidate : chordKeys)
+    {
+        // Candidate must contain every pending key
+        if ((candidate.mask & key.mask) != key.mask)
+        {
+            continue;
+        }
+
+        bool moreKeys = candidate.mask != key.mask;
+        if (key.trigger == TRIGGER_BUTTON)
+        {
+            // Button already held: only more keys together with the button can follow
+            if (candidate.trigger == TRIGGER_BUTTON && moreKeys)
+            {
+                return true;
+            }
+        }
+        else if (moreKeys || candidate.trigger == TRIGGER_BUTTON)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t ComboIndex::describe(const Key &key, char *buffer, size_t bufferSize) const
+{
+    if (bufferSize == 0)
+    {
+        return 0;
+    }
+
+    size_t len = 0;
+    uint8_t keyCount = __builtin_popcount(key.mask);
+    for (uint8_t position = 0; position < keyCount && len + 2 < bufferSize; position++)
+    {
+        uint8_t keyIndex = (key.order >> (position * 4)) & 0x0F;
+        if (position > 0)
+        {
+            buffer[len++] = '+';
+        }
+        buffer[len++] = indexToLabel[keyIndex] ? indexToLabel[keyIndex] : '?';
+    }
+
+    const char *trigger = nullptr;
+    switch (key.trigger)
+    {
+    case TRIGGER_BUTTON:
+        trigger = "BUTTON";
+        break;
+    case TRIGGER_CW:
+        trigger = "CW";
+        break;
+    case TRIGGER_CCW:
+        trigger = "CCW";
+        break;
+    case TRIGGER_TAP:
+        trigger = "TAP";
+        break;
+    case TRIGGER_HOLD:
+        trigger = "HOLD";
+        break;
+    case TRIGGER_DTAP:
+        trigger = "DTAP";
+        break;
+    case TRIGGER_TAPHOLD:
+        trigger = "TAPHOLD";
+        break;
+    default:
+        break;
+    }
+
+    if (trigger)
+    {
+        if (len > 0 && len + 1 < bufferSize)
+        {
+            buffer[len++] = key.trigger >= TRIGGER_TAP ? ':' : ',';
+        }
+        while (*trigger && len + 1 < bufferSize)
+        {
+            buffer[len++] = *trigger++;
+        }
+    }
+
+    buffer[len] = '\0';
+    return len;
+}
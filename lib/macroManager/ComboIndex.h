@@ -0,0 +1,102 @@
+#ifndef COMBO_INDEX_H
+#define COMBO_INDEX_H
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "configTypes.h"
+
+/**
+ * @brief Pre-compiled lookup table for key/encoder combinations.
+ *
+ * Combination strings such as "1+2,CW" are parsed once when a combo set
+ * is loaded and stored in an open-addressing hash table keyed by the
+ * pressed-keys bitmask, the trigger (encoder/button) and the exact order
+ * of the keys as written. Lookups on the key-event path are O(1) and do
+ * not allocate.
+ *
+ * Entries that are not key combinations (gesture names, G_ID:n, ...) are
+ * not compiled and must still be resolved through the string map.
+ */
+class ComboIndex
+{
+public:
+    static constexpr uint8_t MAX_KEYS = 16;
+
+    enum Trigger : uint8_t
+    {
+        TRIGGER_NONE = 0,
+        TRIGGER_BUTTON,
+        TRIGGER_CW,
+        TRIGGER_CCW,
+        TRIGGER_TAP,     // "1:TAP"
+        TRIGGER_HOLD,    // "1:HOLD"
+        TRIGGER_DTAP,    // "1:DTAP"
+        TRIGGER_TAPHOLD  // "1:TAPHOLD", tap then hold
+    };
+
+    struct Key
+    {
+        uint16_t mask;
+        uint8_t trigger;
+        uint64_t order; // Key indices packed 4 bits each, first pressed in the low nibble
+    };
+
+    struct Entry
+    {
+        Key key;
+        const std::string *name;
+        const std::vector<std::string> *actions;
+    };
+
+    ComboIndex();
+
+    /**
+     * @brief Compile the combinations of the current set.
+     *
+     * The map must outlive the index: entries point to its keys and values.
+     */
+    void build(const std::map<std::string, std::vector<std::string>> &combos, const KeypadConfig &keypadConfig);
+    void clear();
+
+    const Entry *find(const Key &key) const;
+    size_t size() const { return count; }
+
+    // Entry of a single key with the given trigger, or nullptr
+    const Entry *findKey(uint8_t keyIndex, uint8_t trigger) const;
+
+    /**
+     * @brief Whether a longer key/button combination could still start from key.
+     *
+     * When false the pending combination is unambiguous and can fire without
+     * waiting combo_delay. Encoder combos never count: they fire on rotation.
+     */
+    bool hasSuperset(const Key &key) const;
+
+    // Order code of the keys in mask, sorted by key index
+    static uint64_t orderFromMask(uint16_t mask);
+    static uint64_t appendToOrder(uint64_t order, uint8_t position, uint8_t keyIndex);
+
+    // Same key restricted to the keys in mask, keeping their relative order
+    static Key subset(const Key &key, uint16_t mask);
+
+    /**
+     * @brief Render a key as a combination string ("1+2,CW") for logging.
+     */
+    size_t describe(const Key &key, char *buffer, size_t bufferSize) const;
+
+private:
+    bool parse(const std::string &comboName, Key &outKey) const;
+    static uint32_t hashKey(const Key &key);
+    static bool sameKey(const Key &a, const Key &b);
+
+    std::vector<Entry> slots; // Empty slots have name == nullptr
+    std::vector<Key> chordKeys; // Compact copy of key/button entries for superset scans
+    size_t count;
+    uint32_t slotMask;
+    int8_t labelToIndex[256];
+    char indexToLabel[MAX_KEYS];
+};
+
+#endif // COMBO_INDEX_H
@@ -0,0 +1,69 @@
+#ifndef MACRO_TIMELINE_H
+#define MACRO_TIMELINE_H
+
+#include <Arduino.h>
+#include <string>
+
+#ifndef MACRO_TIMELINE_CAPACITY
+    #define MACRO_TIMELINE_CAPACITY 32 // Max steps of a single chained macro
+#endif
+
+/**
+ * @brief Fixed-capacity ring of timed macro steps.
+ *
+ * Each step either presses an action and holds it for delayMs, or (with a
+ * null action) is a pure gap produced by DELAY_n. MacroManager drains the
+ * ring from update() so a playing macro never blocks the main loop.
+ */
+class MacroTimeline
+{
+public:
+    struct Step
+    {
+        const std::string *action; // nullptr for a DELAY_ gap
+        uint32_t delayMs;          // Time before the next step starts
+    };
+
+    MacroTimeline() : head(0), count(0) {}
+
+    void clear()
+    {
+        head = 0;
+        count = 0;
+    }
+
+    bool push(const std::string *action, uint32_t delayMs)
+    {
+        if (count >= MACRO_TIMELINE_CAPACITY)
+        {
+            return false;
+        }
+        Step &step = steps[(head + count) % MACRO_TIMELINE_CAPACITY];
+        step.action = action;
+        step.delayMs = delayMs;
+        count++;
+        return true;
+    }
+
+    bool pop(Step &outStep)
+    {
+        if (count == 0)
+        {
+            return false;
+        }
+        outStep = steps[head];
+        head = (head + 1) % MACRO_TIMELINE_CAPACITY;
+        count--;
+        return true;
+    }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+
+private:
+    Step steps[MACRO_TIMELINE_CAPACITY];
+    size_t head;
+    size_t count;
+};
+
+#endif // MACRO_TIMELINE_H
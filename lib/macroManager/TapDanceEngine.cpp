@@ -0,0 +1,356 @@
+/*
+ * ESP32 MacroPad Project
+ * Copyright (C) [2025] [Enrico Mori]
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TapDanceEngine.h"
+#include <string.h>
+#include <algorithm>
+#include <limits.h>
+
+TapDanceEngine::TapDanceEngine()
+    : tapDanceMask(0),
+      tappingTerm(200),
+      outHead(0),
+      outCount(0),
+      bufferedCount(0)
+{
+    memset(capabilities, 0, sizeof(capabilities));
+    reset();
+}
+
+void TapDanceEngine::configure(const ComboIndex &index, unsigned long tappingTermMs)
+{
+    tappingTerm = tappingTermMs;
+    tapDanceMask = 0;
+
+    for (uint8_t key = 0; key < ComboIndex::MAX_KEYS; key++)
+    {
+        uint8_t caps = 0;
+        if (index.findKey(key, ComboIndex::TRIGGER_TAP))
+            caps |= CAN_TAP;
+        if (index.findKey(key, ComboIndex::TRIGGER_HOLD))
+            caps |= CAN_HOLD;
+        if (index.findKey(key, ComboIndex::TRIGGER_DTAP))
+            caps |= CAN_DTAP;
+        if (index.findKey(key, ComboIndex::TRIGGER_TAPHOLD))
+            caps |= CAN_TAPHOLD;
+
+        capabilities[key] = caps;
+        if (caps)
+        {
+            tapDanceMask |= (1 << key);
+        }
+    }
+
+    reset();
+}
+
+void TapDanceEngine::reset()
+{
+    memset(states, 0, sizeof(states));
+    outHead = 0;
+    outCount = 0;
+    bufferedCount = 0;
+}
+
+bool TapDanceEngine::poll(Output &out)
+{
+    if (outCount == 0)
+    {
+        return false;
+    }
+    out = outputs[outHead];
+    outHead = (outHead + 1) % TAP_DANCE_QUEUE_SIZE;
+    outCount--;
+    return true;
+}
+
+void TapDanceEngine::emit(uint8_t key, uint8_t trigger, uint8_t kind)
+{
+    if (outCount >= TAP_DANCE_QUEUE_SIZE)
+    {
+        return; // MacroManager drains after every event, cannot happen in practice
+    }
+    Output &out = outputs[(outHead + outCount) % TAP_DANCE_QUEUE_SIZE];
+    out.key = key;
+    out.trigger = trigger;
+    out.kind = kind;
+    outCount++;
+}
+
+bool TapDanceEngine::anyUndecided() const
+{
+    for (uint8_t key = 0; key < ComboIndex::MAX_KEYS; key++)
+    {
+        if (states[key].phase == FIRST_DOWN || states[key].phase == SECOND_DOWN)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TapDanceEngine::buffer(uint8_t key, bool pressed)
+{
+    if (bufferedCount >= ComboIndex::MAX_KEYS)
+    {
+        // Too many keys behind an undecided one: settle everything now
+        forceResolveAll();
+        flushBuffered();
+    }
+    buffered[bufferedCount].key = key;
+    buffered[bufferedCount].pressed = pressed;
+    bufferedCount++;
+}
+
+void TapDanceEngine::flushBuffered()
+{
+    for (uint8_t i = 0; i < bufferedCount; i++)
+    {
+        emit(buffered[i].key, ComboIndex::TRIGGER_NONE, buffered[i].pressed ? OUT_PRESS : OUT_RELEASE);
+    }
+    bufferedCount = 0;
+}
+
+// Held past the tapping term or interrupted: HOLD (or TAPHOLD on the second press)
+void TapDanceEngine::resolveAsHold(uint8_t key)
+{
+    KeyState &state = states[key];
+    uint8_t caps = capabilities[key];
+    uint8_t trigger;
+
+    if (state.phase == SECOND_DOWN)
+    {
+        trigger = ComboIndex::TRIGGER_TAPHOLD;
+    }
+    else if (caps & CAN_HOLD)
+    {
+        trigger = ComboIndex::TRIGGER_HOLD;
+    }
+    else
+    {
+        trigger = ComboIndex::TRIGGER_TAP; // No HOLD entry: a long press is a held tap
+    }
+
+    state.phase = ACTIVE;
+    state.activeTrigger = trigger;
+    state.interruptMask = 0;
+    emit(key, trigger, OUT_PRESS);
+}
+
+void TapDanceEngine::resolveTapNow(uint8_t key)
+{
+    states[key].phase = IDLE;
+    emit(key, ComboIndex::TRIGGER_TAP, OUT_TAP);
+}
+
+void TapDanceEngine::forceResolveAll()
+{
+    for (uint8_t key = 0; key < ComboIndex::MAX_KEYS; key++)
+    {
+        if (states[key].phase == FIRST_DOWN || states[key].phase == SECOND_DOWN)
+        {
+            resolveAsHold(key);
+        }
+    }
+}
+
+void TapDanceEngine::handleKey(uint8_t key, bool pressed, unsigned long now)
+{
+    if (key >= ComboIndex::MAX_KEYS)
+    {
+        return;
+    }
+
+    uint16_t keyBit = 1 << key;
+
+    if (pressed)
+    {
+        for (uint8_t other = 0; other < ComboIndex::MAX_KEYS; other++)
+        {
+            if (other == key)
+            {
+                continue;
+            }
+            if (states[other].phase == FIRST_UP)
+            {
+                resolveTapNow(other);
+            }
+            else if (states[other].phase == FIRST_DOWN || states[other].phase == SECOND_DOWN)
+            {
+                states[other].interruptMask |= keyBit;
+            }
+        }
+    }
+    else
+    {
+        // Permissive hold: a key pressed and released inside an undecided hold
+        for (uint8_t other = 0; other < ComboIndex::MAX_KEYS; other++)
+        {
+            if (other != key && (states[other].interruptMask & keyBit) &&
+                (states[other].phase == FIRST_DOWN || states[other].phase == SECOND_DOWN))
+            {
+                resolveAsHold(other);
+            }
+        }
+    }
+
+    if (tapDanceMask & keyBit)
+    {
+        handleTapDanceKey(key, pressed, now);
+    }
+    else if (bufferedCount > 0 || anyUndecided())
+    {
+        buffer(key, pressed);
+    }
+    else
+    {
+        emit(key, ComboIndex::TRIGGER_NONE, pressed ? OUT_PRESS : OUT_RELEASE);
+    }
+
+    if (bufferedCount > 0 && !anyUndecided())
+    {
+        flushBuffered();
+    }
+}
+
+void TapDanceEngine::handleTapDanceKey(uint8_t key, bool pressed, unsigned long now)
+{
+    KeyState &state = states[key];
+    uint8_t caps = capabilities[key];
+
+    if (pressed)
+    {
+        switch (state.phase)
+        {
+        case IDLE:
+            state.phase = FIRST_DOWN;
+            state.since = now;
+            state.interruptMask = 0;
+            break;
+
+        case FIRST_UP:
+            if (caps & CAN_TAPHOLD)
+            {
+                state.phase = SECOND_DOWN;
+                state.since = now;
+                state.interruptMask = 0;
+            }
+            else
+            {
+                // Nothing else can follow a second press: double tap right away
+                state.phase = ACTIVE;
+                state.activeTrigger = ComboIndex::TRIGGER_DTAP;
+                emit(key, ComboIndex::TRIGGER_DTAP, OUT_PRESS);
+            }
+            break;
+
+        default:
+            break; // Repeated press while already down
+        }
+        return;
+    }
+
+    switch (state.phase)
+    {
+    case FIRST_DOWN:
+        if (caps & (CAN_DTAP | CAN_TAPHOLD))
+        {
+            state.phase = FIRST_UP;
+            state.since = now;
+        }
+        else
+        {
+            resolveTapNow(key);
+        }
+        break;
+
+    case SECOND_DOWN:
+        state.phase = IDLE;
+        if (caps & CAN_DTAP)
+        {
+            emit(key, ComboIndex::TRIGGER_DTAP, OUT_TAP);
+        }
+        else
+        {
+            // Only TAPHOLD is defined: two quick taps are two taps
+            emit(key, ComboIndex::TRIGGER_TAP, OUT_TAP);
+            emit(key, ComboIndex::TRIGGER_TAP, OUT_TAP);
+        }
+        break;
+
+    case ACTIVE:
+        state.phase = IDLE;
+        emit(key, state.activeTrigger, OUT_RELEASE);
+        break;
+
+    default:
+        break;
+    }
+}
+
+unsigned long TapDanceEngine::msUntilDeadline(unsigned long now) const
+{
+    unsigned long nearest = ULONG_MAX;
+    if (!tapDanceMask)
+    {
+        return nearest;
+    }
+
+    for (uint8_t key = 0; key < ComboIndex::MAX_KEYS; key++)
+    {
+        const KeyState &state = states[key];
+        if (state.phase == IDLE || state.phase == ACTIVE)
+        {
+            continue;
+        }
+        unsigned long elapsed = now - state.since;
+        nearest = std::min(nearest, elapsed >= tappingTerm ? 0UL : tappingTerm - elapsed);
+    }
+    return nearest;
+}
+
+void TapDanceEngine::update(unsigned long now)
+{
+    if (!tapDanceMask)
+    {
+        return;
+    }
+
+    for (uint8_t key = 0; key < ComboIndex::MAX_KEYS; key++)
+    {
+        KeyState &state = states[key];
+        if (state.phase == IDLE || state.phase == ACTIVE || now - state.since < tappingTerm)
+        {
+            continue;
+        }
+
+        if (state.phase == FIRST_UP)
+        {
+            resolveTapNow(key); // No second tap within the tapping term
+        }
+        else
+        {
+            resolveAsHold(key);
+        }
+    }
+
+    if (bufferedCount > 0 && !anyUndecided())
+    {
+        flushBuffered();
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef TAP_DANCE_ENGINE_H
+#define TAP_DANCE_ENGINE_H
+
+#include <Arduino.h>
+#include "ComboIndex.h"
+
+#ifndef TAP_DANCE_QUEUE_SIZE
+    #define TAP_DANCE_QUEUE_SIZE 32 // Decisions and buffered key events waiting for MacroManager
+#endif
+
+/**
+ * @brief Per-key tap / hold / double-tap state machines.
+ *
+ * Keys that have "n:TAP", "n:HOLD", "n:DTAP" or "n:TAPHOLD" combinations are
+ * resolved here instead of going through the chord logic. Every other key
+ * event is passed through unchanged, but while a tap-dance key is still
+ * undecided it is buffered so the resolved action always comes first
+ * (e.g. a HOLD modifier is applied before the key typed under it).
+ *
+ * Decisions are taken at the earliest possible moment:
+ * - a release resolves TAP at once when the key has no DTAP/TAPHOLD entry;
+ * - a second press resolves DTAP at once when the key has no TAPHOLD entry;
+ * - another key pressed and released inside the hold resolves HOLD
+ *   (permissive hold) without waiting for the tapping term.
+ *
+ * All state is fixed-size; nothing is allocated after construction.
+ */
+class TapDanceEngine
+{
+public:
+    enum Capability : uint8_t
+    {
+        CAN_TAP = 1 << 0,
+        CAN_HOLD = 1 << 1,
+        CAN_DTAP = 1 << 2,
+        CAN_TAPHOLD = 1 << 3
+    };
+
+    enum OutputKind : uint8_t
+    {
+        OUT_PRESS,
+        OUT_RELEASE,
+        OUT_TAP // Press and release straight away
+    };
+
+    struct Output
+    {
+        uint8_t key;
+        uint8_t trigger; // ComboIndex::TRIGGER_NONE for passed-through key events
+        uint8_t kind;
+    };
+
+    TapDanceEngine();
+
+    void configure(const ComboIndex &index, unsigned long tappingTermMs);
+    void reset();
+    bool isActive() const { return tapDanceMask != 0; }
+    bool isTapDanceKey(uint8_t key) const { return key < ComboIndex::MAX_KEYS && (tapDanceMask & (1 << key)); }
+
+    void handleKey(uint8_t key, bool pressed, unsigned long now);
+    void update(unsigned long now);
+
+    // Milliseconds until update() can resolve a key by the tapping term, ULONG_MAX if none
+    unsigned long msUntilDeadline(unsigned long now) const;
+    bool poll(Output &out);
+
+private:
+    enum Phase : uint8_t
+    {
+        IDLE,
+        FIRST_DOWN,  // Pressed once, tap or hold not decided yet
+        FIRST_UP,    // Tapped once, waiting for a possible second tap
+        SECOND_DOWN, // Pressed again, double tap or tap-then-hold not decided yet
+        ACTIVE       // Decided, trigger held until the key goes up
+    };
+
+    struct KeyState
+    {
+        uint8_t phase;
+        uint8_t activeTrigger;
+        uint16_t interruptMask; // Keys pressed after this one while undecided
+        unsigned long since;
+    };
+
+    void handleTapDanceKey(uint8_t key, bool pressed, unsigned long now);
+    void resolveAsHold(uint8_t key);
+    void resolveTapNow(uint8_t key);
+    bool anyUndecided() const;
+    void flushBuffered();
+    void forceResolveAll();
+    void emit(uint8_t key, uint8_t trigger, uint8_t kind);
+    void buffer(uint8_t key, bool pressed);
+
+    KeyState states[ComboIndex::MAX_KEYS];
+    uint8_t capabilities[ComboIndex::MAX_KEYS];
+    uint16_t tapDanceMask;
+    unsigned long tappingTerm;
+
+    Output outputs[TAP_DANCE_QUEUE_SIZE];
+    uint8_t outHead;
+    uint8_t outCount;
+
+    struct BufferedKey
+    {
+        uint8_t key;
+        bool pressed;
+    };
+    BufferedKey buffered[ComboIndex::MAX_KEYS];
+    uint8_t bufferedCount;
+};
+
+#endif // TAP_DANCE_ENGINE_H
@@ -32,6 +32,10 @@
 #include "specialAction.h"
 #include "CommandFactory.h"
 #include "Command.h"
+#include "LatencyTracer.h"
+#include "InputText.h"
+#include <algorithm>
+#include <limits.h>
 
 // Bitmask helper functions
 inline void setKeyState(uint16_t &mask, uint8_t key, bool state)
@@ -67,8 +71,7 @@ MacroManager::MacroManager()
       pendingCombination(""),
       newKeyPressed(false),
       encoderReleaseScheduled(false),
-      useKeyPressOrder(false), // Di default usa il metodo originale
-      processingCommandQueue(false)
+      useKeyPressOrder(false) // Di default usa il metodo originale
 {
     lastActionTime = millis();
 }
@@ -93,6 +96,8 @@ void MacroManager::begin(
     this->commandFactory = commandFactory;
     this->keypadConfig = keypadConfig;
     this->wifiConfig = wifiConfig;
+
+    keyPressOrder.reserve(ComboIndex::MAX_KEYS);
 }
 
 // Parse a composite action string and extract commands enclosed in <>
@@ -170,229 +175,429 @@ std::vector<std::string> MacroManager::parseChainedCommands(const std::string &c
     return commands;
 }
 
-// New method to handle command queuing
-void MacroManager::enqueueCommands(const std::string &compositeAction)
+static bool isChainedAction(const std::string &action)
 {
-    // Parse the composite action into individual commands
-    std::vector<std::string> commands = parseChainedCommands(compositeAction);
+    return action.find('<') != std::string::npos && action.find('>') != std::string::npos;
+}
 
-    // If there's only one command and it doesn't use <> syntax, use normal execution
-    if (commands.size() == 1 && compositeAction.find('<') == std::string::npos)
+// Play a combo's actions on the timeline when they describe a sequence.
+// Returns false when the actions must be pressed directly.
+bool MacroManager::startTimeline(const std::vector<std::string> &actions)
+{
+    for (const std::string &action : actions)
     {
-        pressAction(commands[0]);
-        lastExecutedAction = commands[0];
-        return;
+        if (isChainedAction(action))
+        {
+            enqueueCommands(action);
+            return true;
+        }
     }
 
-    // Otherwise, queue all commands for sequential execution
-    // First, clear any existing queue
-    commandQueue.clear();
-    // Then add all new commands
-    commandQueue = commands;
-    processingCommandQueue = true;
-    nextCommandTime = millis();
+    // Arrays with DELAY_ entries are sequences as well (see SYNTAX_GUIDE); a lone
+    // DELAY_n too, since the timeline is the only place a delay is played
+    for (const std::string &action : actions)
+    {
+        if (action.rfind("DELAY_", 0) == 0)
+        {
+            enqueueSteps(actions);
+            return true;
+        }
+    }
 
-    // We set this flag to prevent other actions, but our queue commands will still run
-    is_action_locked = true;
+    return false;
+}
 
-    Logger::getInstance().log("Enqueued " + String(commands.size()) + " commands for sequential execution");
+void MacroManager::enqueueCommands(const std::string &compositeAction)
+{
+    auto it = chainedCommands.find(compositeAction);
+    if (it == chainedCommands.end())
+    {
+        // Not seen at load time (should not happen for combo actions)
+        it = chainedCommands.insert(std::make_pair(compositeAction, parseChainedCommands(compositeAction))).first;
+    }
+    enqueueSteps(it->second);
 }
 
-// Process the command queue in the update method
-void MacroManager::processCommandQueue()
+void MacroManager::enqueueSteps(const std::vector<std::string> &commands)
 {
-    unsigned long currentTime = millis();
+    // A new macro replaces the one that is playing
+    stopTimeline();
 
-    // If we're not processing a queue or it's not time for the next command yet, return
-    if (!processingCommandQueue || currentTime < nextCommandTime)
+    for (const std::string &command : commands)
+    {
+        bool queued;
+        if (command.rfind("DELAY_", 0) == 0)
+        {
+            // DELAY_n is a timed gap, not a blocking command
+            queued = timeline.push(nullptr, static_cast<uint32_t>(std::max(0, atoi(command.c_str() + 6))));
+        }
+        else
+        {
+            queued = timeline.push(&command, COMMAND_DELAY);
+        }
+
+        if (!queued)
+        {
+            Logger::getInstance().log("Macro too long, truncated at " + String(MACRO_TIMELINE_CAPACITY) + " steps");
+            break;
+        }
+    }
+
+    timelineActive = true;
+    nextTimelineTime = millis();
+
+    Logger::getInstance().log("Enqueued " + String(timeline.size()) + " commands for sequential execution");
+}
+
+// Advance the timeline; called from update() so it never blocks key scanning
+void MacroManager::processTimeline()
+{
+    if (!timelineActive)
     {
         return;
     }
 
-    // If the queue is empty, we're done
-    if (commandQueue.empty())
+    unsigned long currentTime = millis();
+    if ((long)(currentTime - nextTimelineTime) < 0)
     {
-        processingCommandQueue = false;
-        is_action_locked = false;
         return;
     }
 
-    // Get the next command from the queue
-    std::string command = commandQueue.front();
-    commandQueue.erase(commandQueue.begin());
+    // Release the command held by the previous step
+    if (timelineHeldCommand)
+    {
+        Command *held = timelineHeldCommand;
+        timelineHeldCommand = nullptr;
+        held->release();
+    }
 
-    // Handle the special marker for ending the queue
-    if (command == "__RELEASE_LAST__")
+    MacroTimeline::Step step;
+    if (!timeline.pop(step))
     {
-        // Ensure we clean up properly
-        if (!lastExecutedAction.empty())
-        {
-            releaseAction(lastExecutedAction);
-            lastExecutedAction.clear();
-        }
-        processingCommandQueue = false;
-        is_action_locked = false;
+        timelineActive = false;
         return;
     }
 
-    // Execute the command
-    Logger::getInstance().log("Executing queued command: " + String(command.c_str()));
+    nextTimelineTime = currentTime + step.delayMs;
 
-    // Release any previous action first
-    if (!lastExecutedAction.empty())
+    if (step.action)
     {
-        releaseAction(lastExecutedAction);
-        lastExecutedAction.clear();
+        Command *command = commandFactory->acquire(*step.action);
+        if (command)
+        {
+            timelineHeldCommand = command;
+            command->press(); // May stop the timeline (e.g. clearActiveKeys)
+        }
+        else
+        {
+            Logger::getInstance().log("MacroManager: No command found for queued action: " + String(step.action->c_str()));
+        }
     }
+}
 
-    // Press the new action
-    pressAction(command);
-    lastExecutedAction = command;
+void MacroManager::stopTimeline()
+{
+    timeline.clear();
+    timelineActive = false;
 
-    // If this was the last command, we'll release it after a delay
-    if (commandQueue.empty())
+    if (timelineHeldCommand)
     {
-        commandQueue.push_back("__RELEASE_LAST__"); // Special marker for release only
+        Command *held = timelineHeldCommand;
+        timelineHeldCommand = nullptr;
+        held->release();
     }
-
-    // Schedule the next command
-    nextCommandTime = currentTime + COMMAND_DELAY;
 }
 
-void MacroManager::pressAction(const std::string &action)
+Command* MacroManager::pressAction(const std::string &action)
 {
-    // Allow commands from the queue to execute even when actions are locked
-    if (is_action_locked && !(action == "RESET_ALL") && !processingCommandQueue)
+    if (is_action_locked && !(action == "RESET_ALL"))
     {
         Logger::getInstance().log("Action locked, skipping action: " + String(action.c_str()));
         // pendingCombination.clear(); // Clear the pending status
-        return;
+        return nullptr;
     }
 
-    // Try to create a command from the factory first
-    auto command = commandFactory->create(action);
+    // Commands are pooled by the factory, so pressing never allocates
+    Command* command = commandFactory->acquire(action);
     if (command) {
-        Logger::getInstance().log("MacroManager: Pressing command for action: " + String(action.c_str()));
-        _lastExecutedCommand = std::move(command);
-        _lastExecutedCommand->press();
-        return; // Action handled by command pattern
+        LatencyTracer::getInstance().mark(LatencyTracer::STAGE_COMMAND);
+        command->press();
+        return command; // Action handled by command pattern
     }
 
     Logger::getInstance().log("MacroManager: No command found for action: " + String(action.c_str()) + ". Executing legacy action.");
+    return nullptr;
 }
 
-void MacroManager::releaseAction(const std::string &action)
+// Press a combo's actions into a free slot; the slot is released by its owner
+// (key/button release, encoder pulse end, gesture timeout), not by other combos
+void MacroManager::pressSlot(uint8_t source, uint16_t keyMask, bool withButton, const std::vector<std::string> &actions)
 {
-    // Skip if it's our special marker
-    if (action == "__RELEASE_LAST__")
+    ActionSlot *slot = nullptr;
+    for (ActionSlot &candidate : actionSlots)
+    {
+        if (!candidate.used)
+        {
+            slot = &candidate;
+            break;
+        }
+    }
+    if (!slot)
     {
-        processingCommandQueue = false;
-        is_action_locked = false;
+        // Releasing a held action here would drop keys the user is still holding
+        Logger::getInstance().log("MacroManager: " + String(MAX_ACTION_SLOTS) +
+                                  " actions already held, combo ignored");
         return;
     }
 
-    // If a command was stored from pressAction, release it
-    if (_lastExecutedCommand) {
-        Logger::getInstance().log("MacroManager: Releasing command for action: " + String(action.c_str()));
-        _lastExecutedCommand->release();
-        _lastExecutedCommand.reset(); // Release ownership
-        return; // Action handled by command pattern
-    }
+    slot->used = true;
+    slot->source = source;
+    slot->withButton = withButton;
+    slot->keyMask = keyMask;
+    slot->commandCount = 0;
 
-    String logMessage = "Released action: " + String(action.c_str());
+    for (const std::string &action : actions)
+    {
+        Command *command = pressAction(action);
+        if (!slot->used)
+        {
+            // The command cleared every held action (e.g. RESET_ALL)
+            if (command)
+            {
+                command->release();
+            }
+            return;
+        }
+        if (!command)
+        {
+            continue;
+        }
+        if (slot->commandCount < MAX_SLOT_COMMANDS)
+        {
+            slot->commands[slot->commandCount++] = command;
+        }
+        else
+        {
+            command->release(); // No room to hold it: send it as a pulse
+        }
+    }
+}
 
-    // If action is locked but this is part of our command queue, let it proceed
-    if (is_action_locked && !(action == "EXECUTE_GESTURE" || processingCommandQueue))
+void MacroManager::releaseSlot(ActionSlot &slot)
+{
+    if (!slot.used)
     {
-        Logger::getInstance().log("Action locked, skipping action: insideRealeaseactionvoid " + String(action.c_str()));
         return;
     }
+    // Free the slot first: a release may re-enter clearActiveKeys
+    slot.used = false;
+    uint8_t commandCount = slot.commandCount;
+    slot.commandCount = 0;
+    for (uint8_t i = 0; i < commandCount; i++)
+    {
+        slot.commands[i]->release();
+    }
+}
 
-    Logger::getInstance().log(logMessage);
-    return;
+void MacroManager::releaseSlots(uint8_t source)
+{
+    for (ActionSlot &slot : actionSlots)
+    {
+        if (slot.used && slot.source == source)
+        {
+            releaseSlot(slot);
+        }
+    }
 }
 
-// Aggiornare handleInputEvent per registrare l'ordine di pressione
-void MacroManager::handleInputEvent(const InputEvent &event)
+void MacroManager::releaseSlotsWithKeys(uint16_t keyMask)
 {
-    switch (event.type)
+    for (ActionSlot &slot : actionSlots)
     {
-    case InputEvent::EventType::KEY_PRESS:
-        // Salva lo stato precedente prima dell'aggiornamento
-        previousKeysMask = activeKeysMask;
-        wasPartOfCombo = false;
+        if (slot.used && (slot.keyMask & keyMask))
+        {
+            releaseSlot(slot);
+        }
+    }
+}
 
-        // Se è un rilascio di tasto che fa parte di una combinazione attiva
-        if (!event.state && !lastExecutedAction.empty() && getKeyState(activeKeysMask, event.value1))
+void MacroManager::releaseButtonSlots()
+{
+    for (ActionSlot &slot : actionSlots)
+    {
+        if (slot.used && slot.withButton)
         {
-            wasPartOfCombo = true;
+            releaseSlot(slot);
         }
+    }
+}
 
-        // Aggiorna lo stato del tasto
-        setKeyState(activeKeysMask, event.value1, event.state);
+void MacroManager::releaseAllSlots()
+{
+    for (ActionSlot &slot : actionSlots)
+    {
+        releaseSlot(slot);
+    }
+}
 
-        if (event.state)
+// Keys that currently hold a key-combination action
+uint16_t MacroManager::heldKeysMask() const
+{
+    uint16_t mask = 0;
+    for (const ActionSlot &slot : actionSlots)
+    {
+        if (slot.used && slot.source == SLOT_KEYS)
         {
-            // Handle reactive lighting for key press
-            inputHub->handleReactiveLighting(event.value1, false, 0, activeKeysMask);
+            mask |= slot.keyMask;
+        }
+    }
+    return mask;
+}
+
+// Chord handling of a single key event (after tap-dance resolution)
+void MacroManager::handleKeyEvent(uint8_t key, bool pressed)
+{
+    // Salva lo stato precedente prima dell'aggiornamento
+    previousKeysMask = activeKeysMask;
+
+    // Aggiorna lo stato del tasto
+    setKeyState(activeKeysMask, key, pressed);
+
+    if (pressed)
+    {
+        // Handle reactive lighting for key press
+        inputHub->handleReactiveLighting(key, false, 0, activeKeysMask);
 
-            // Quando un tasto viene premuto, aggiungilo alla lista dell'ordine di pressione
-            if (useKeyPressOrder)
+        // Quando un tasto viene premuto, aggiungilo alla lista dell'ordine di pressione
+        if (useKeyPressOrder)
+        {
+            // Rimuovi prima il tasto se già presente (in caso di ripetizione)
+            for (auto it = keyPressOrder.begin(); it != keyPressOrder.end();)
             {
-                // Rimuovi prima il tasto se già presente (in caso di ripetizione)
-                for (auto it = keyPressOrder.begin(); it != keyPressOrder.end();)
+                if (it->keyIndex == key)
                 {
-                    if (it->keyIndex == event.value1)
-                    {
-                        it = keyPressOrder.erase(it);
-                    }
-                    else
-                    {
-                        ++it;
-                    }
+                    it = keyPressOrder.erase(it);
+                }
+                else
+                {
+                    ++it;
                 }
-
-                // Aggiungi il nuovo tasto premuto
-                KeyPressInfo newPress;
-                newPress.keyIndex = static_cast<uint8_t>(event.value1);
-                newPress.timestamp = millis();
-                keyPressOrder.push_back(newPress);
             }
 
-            // Resto del codice originale
-            lastKeyPressTime = millis();
-            pendingCombination = getCurrentCombination();
-            pendingGestureFallback.clear();
-            lastCombinationTime = millis();
-            newKeyPressed = true;
+            // Aggiungi il nuovo tasto premuto
+            KeyPressInfo newPress;
+            newPress.keyIndex = key;
+            newPress.timestamp = millis();
+            keyPressOrder.push_back(newPress);
         }
-        else
+
+        // Resto del codice originale
+        lastKeyPressTime = millis();
+        pendingKeyCombo = getCurrentCombination(lastAction);
+        hasPendingKeyCombo = true;
+        pendingFiresEarly = !comboIndex.hasSuperset(pendingKeyCombo);
+        pendingCombination.clear();
+        pendingGestureFallback.clear();
+        lastCombinationTime = millis();
+        newKeyPressed = true;
+    }
+    else
+    {
+        // Quando un tasto viene rilasciato, rimuovilo dalla lista
+        if (useKeyPressOrder)
         {
-            // Quando un tasto viene rilasciato, rimuovilo dalla lista
-            if (useKeyPressOrder)
+            for (auto it = keyPressOrder.begin(); it != keyPressOrder.end();)
             {
-                for (auto it = keyPressOrder.begin(); it != keyPressOrder.end();)
+                if (it->keyIndex == key)
                 {
-                    if (it->keyIndex == event.value1)
-                    {
-                        it = keyPressOrder.erase(it);
-                    }
-                    else
-                    {
-                        ++it;
-                    }
+                    it = keyPressOrder.erase(it);
+                }
+                else
+                {
+                    ++it;
                 }
             }
+        }
+
+        // Rilascia solo le azioni delle combo che contengono questo tasto
+        releaseSlotsWithKeys(1 << key);
+    }
+}
 
-            if (wasPartOfCombo)
+void MacroManager::drainTapDance()
+{
+    TapDanceEngine::Output output;
+    while (tapDance.poll(output))
+    {
+        if (output.trigger == ComboIndex::TRIGGER_NONE)
+        {
+            handleKeyEvent(output.key, output.kind == TapDanceEngine::OUT_PRESS);
+        }
+        else
+        {
+            executeTapDance(output);
+        }
+    }
+}
+
+void MacroManager::executeTapDance(const TapDanceEngine::Output &output)
+{
+    uint16_t keyBit = 1 << output.key;
+
+    // A tap-dance key holds at most one slot
+    releaseSlotsWithKeys(keyBit);
+    if (output.kind == TapDanceEngine::OUT_RELEASE)
+    {
+        return;
+    }
+
+    const ComboIndex::Entry *entry = comboIndex.findKey(output.key, output.trigger);
+    if (!entry && output.trigger == ComboIndex::TRIGGER_TAP)
+    {
+        entry = comboIndex.findKey(output.key, ComboIndex::TRIGGER_NONE); // Plain "1" is the tap action
+    }
+
+    if (!entry)
+    {
+        char missingKey[16];
+        ComboIndex::Key key = {keyBit, output.trigger, output.key};
+        comboIndex.describe(key, missingKey, sizeof(missingKey));
+        Logger::getInstance().log(String("combinazione non impostata") + String(missingKey));
+        return;
+    }
+
+    executeCombinationActions(*entry->name, *entry->actions, SLOT_TAP_DANCE, keyBit, false);
+
+    if (output.kind == TapDanceEngine::OUT_TAP)
+    {
+        releaseSlotsWithKeys(keyBit);
+    }
+}
+
+// Aggiornare handleInputEvent per registrare l'ordine di pressione
+void MacroManager::handleInputEvent(const InputEvent &event)
+{
+    switch (event.type)
+    {
+    case InputEvent::EventType::KEY_PRESS:
+        if (event.state)
+        {
+            LatencyTracer::getInstance().mark(LatencyTracer::STAGE_DISPATCH);
+        }
+
+        if (tapDance.isActive())
+        {
+            // Tap-dance keys light up on the physical press, not on the decision
+            if (event.state && tapDance.isTapDanceKey(event.value1))
             {
-                // Codice originale per il rilascio di combo
-                if (!lastExecutedAction.empty())
-                {
-                    releaseAction(lastExecutedAction);
-                    lastExecutedAction.clear();
-                }
+                inputHub->handleReactiveLighting(event.value1, false, 0, activeKeysMask);
             }
+            tapDance.handleKey(event.value1, event.state, millis());
+            drainTapDance();
+        }
+        else
+        {
+            handleKeyEvent(event.value1, event.state);
         }
         break;
 
@@ -403,72 +608,32 @@ void MacroManager::handleInputEvent(const InputEvent &event)
             // Handle reactive lighting for encoder rotation
             inputHub->handleReactiveLighting(0, true, event.value1, activeKeysMask);
 
-            // Determina la direzione
-            std::string encoderAction = (event.value1 > 0) ? "CW" : "CCW";
-            std::string fullCombo = "";
-
-            // Costruisci la combinazione con l'encoder e i tasti attuali
-            if (activeKeysMask != 0)
-            {
-                // Ci sono tasti premuti, costruisci la combo "tasti+encoder"
-                std::string keysCombo = getCurrentKeyCombination(); // Solo i tasti
-                if (!keysCombo.empty())
-                {
-                    fullCombo = keysCombo + "," + encoderAction;
-                }
-                else
-                {
-                    fullCombo = encoderAction;
-                }
-            }
-            else
-            {
-                // Solo encoder
-                fullCombo = encoderAction;
-            }
+            // Combinazione "tasti,encoder" (o solo encoder se nessun tasto è premuto)
+            ComboIndex::Key fullCombo = getCurrentCombination(event.value1 > 0 ? ComboIndex::TRIGGER_CW : ComboIndex::TRIGGER_CCW);
+            const ComboIndex::Entry *entry = comboIndex.find(fullCombo);
 
-            Logger::getInstance().log("Encoder pulse: " + String(encoderAction.c_str()) + " combo: " + String(fullCombo.c_str()));
+            char comboName[64];
+            comboIndex.describe(fullCombo, comboName, sizeof(comboName));
+            Logger::getInstance().log("Encoder pulse: " + String(event.value1 > 0 ? "CW" : "CCW") + " combo: " + String(comboName));
 
             // Save the activation combo for IR commands
-            currentActivationCombo = fullCombo;
+            currentActivationCombo = entry ? entry->name : nullptr;
 
-            // Rilascia l'azione precedente se esiste
-            if (!lastExecutedAction.empty())
-            {
-                releaseAction(lastExecutedAction);
-                lastExecutedAction.clear();
-            }
+            // Rilascia l'impulso precedente e le azioni dei tasti che fanno parte della combo
+            releaseSlots(SLOT_ENCODER);
+            releaseSlotsWithKeys(fullCombo.mask);
 
             // Controlla se questa combo esiste
-            if (combinations.find(fullCombo) != combinations.end())
+            if (entry)
             {
-                // Check if any action contains <> syntax
-                bool hasChainedCommands = false;
-                for (const std::string &action : combinations[fullCombo])
+                // Sequences play on the timeline, otherwise execute normally
+                if (!startTimeline(*entry->actions))
                 {
-                    if (action.find('<') != std::string::npos && action.find('>') != std::string::npos)
-                    {
-                        hasChainedCommands = true;
-                        enqueueCommands(action);
-                        break;
-                    }
-                }
+                    pressSlot(SLOT_ENCODER, 0, false, *entry->actions);
 
-                // If no chained commands, execute normally
-                if (!hasChainedCommands)
-                {
-                    // Esegui l'azione
-                    for (const std::string &action : combinations[fullCombo])
-                    {
-                        pressAction(action);
-                        lastExecutedAction = action;
-
-                        // Rilascia immediatamente dopo per garantire un impulso completo
-                        // Ritardiamo leggermente il rilascio per dare tempo all'azione di essere eseguita
-                        encoderReleaseScheduled = true;
-                        encoderReleaseTime = millis() + encoder_pulse_duration;
-                        encoderPendingAction = action;
-                    }
+                    // Rilascia dopo encoder_pulse_duration per garantire un impulso completo
+                    encoderReleaseScheduled = true;
+                    encoderReleaseTime = millis() + encoder_pulse_duration;
                 }
             }
         }
@@ -480,35 +645,30 @@ void MacroManager::handleInputEvent(const InputEvent &event)
             // Handle reactive lighting for encoder button
             inputHub->handleReactiveLighting(0, true, 0, activeKeysMask);
 
-            lastAction = "BUTTON";
-            pendingCombination = getCurrentCombination();
+            lastAction = ComboIndex::TRIGGER_BUTTON;
+            pendingKeyCombo = getCurrentCombination(lastAction);
+            hasPendingKeyCombo = true;
+            pendingFiresEarly = !comboIndex.hasSuperset(pendingKeyCombo);
+            pendingCombination.clear();
             pendingGestureFallback.clear();
             lastCombinationTime = millis();
             newKeyPressed = true; // Flag that a new input was registered
         }
         else
         {
-            lastAction.clear();
+            lastAction = ComboIndex::TRIGGER_NONE;
 
             // Se rilasciamo un pulsante che faceva parte di una combo, rilascia l'azione
-            if (!lastExecutedAction.empty())
-            {
-                releaseAction(lastExecutedAction);
-                lastExecutedAction.clear();
-                Logger::getInstance().log("Released combo on button release");
-            }
+            releaseButtonSlots();
         }
         break;
 
     case InputEvent::EventType::MOTION:
         if (event.state && event.value1 >= 0)
         {
-            std::string gestureKey;
-            if (event.text.length() > 0)
-            {
-                gestureKey = event.text.c_str();
-            }
+            std::string gestureKey = InputText::lookup(event.textId);
 
+            hasPendingKeyCombo = false;
             pendingGestureFallback.clear();
             if (event.value1 >= 0)
             {
@@ -532,7 +692,7 @@ void MacroManager::handleInputEvent(const InputEvent &event)
             String logMessage = "Gesture event recognized: ";
             if (!gestureKey.empty())
             {
-                logMessage += event.text;
+                logMessage += gestureKey.c_str();
                 if (event.value1 >= 0)
                 {
                     logMessage += " (G_ID:";
@@ -554,166 +714,32 @@ void MacroManager::handleInputEvent(const InputEvent &event)
     }
 }
 
-// Metodo per ottenere la combinazione basata sull'ordine di pressione
-std::string MacroManager::getOrderAwareCombination()
+// Costruisce la chiave della combinazione corrente (tasti + trigger) senza allocare
+ComboIndex::Key MacroManager::getCurrentCombination(uint8_t trigger) const
 {
-    char buffer[64]; // Pre-allocate buffer
-    char *ptr = buffer;
-    bool first = true;
-
-    // Itera attraverso i tasti nell'ordine in cui sono stati premuti
-    for (const auto &keyInfo : keyPressOrder)
-    {
-        uint8_t key = keyInfo.keyIndex;
-        if (!first)
-        {
-            *ptr++ = '+';
-        }
-
-        // Get key label from keypad configuration
-        uint8_t row = key / keypadConfig->cols;
-        uint8_t col = key % keypadConfig->cols;
-        char keyLabel = this->keypadConfig->keys[row][col];
-        if (keyLabel != '\0')
-        {
-            *ptr++ = keyLabel;
-        }
-        first = false;
-    }
+    ComboIndex::Key key;
+    key.trigger = trigger;
 
-    // Add last action if present
-    if (!lastAction.empty())
-    {
-        if (!first)
-        {
-            *ptr++ = ',';
-        }
-        const char *actionPtr = lastAction.c_str();
-        while (*actionPtr)
-        {
-            *ptr++ = *actionPtr++;
-        }
-    }
-
-    *ptr = '\0'; // Null-terminate the string
-    return std::string(buffer);
-}
-
-// Modifica getCurrentCombination per scegliere il metodo appropriato
-std::string MacroManager::getCurrentCombination()
-{
     if (useKeyPressOrder)
     {
-        return getOrderAwareCombination();
-    }
-    else
-    {
-        // Implementazione originale
-        char buffer[64]; // Pre-allocate buffer for combination
-        char *ptr = buffer;
-        bool first = true;
-
-        // Add active keys using bitmask
-        uint8_t totalKeys = keypadConfig->rows * keypadConfig->cols;
-        for (uint8_t key = 0; key < totalKeys; key++)
-        {
-            if (getKeyState(activeKeysMask, key))
-            {
-                if (!first)
-                {
-                    *ptr++ = '+';
-                }
-                // Get key label from keypad configuration
-                uint8_t row = key / keypadConfig->cols;
-                uint8_t col = key % keypadConfig->cols;
-                char keyLabel = this->keypadConfig->keys[row][col];
-                if (keyLabel != '\0')
-                {
-                    *ptr++ = keyLabel;
-                }
-                first = false;
-            }
-        }
-
-        // Add last action if present
-        if (!lastAction.empty())
-        {
-            if (!first)
-            {
-                *ptr++ = ',';
-            }
-            const char *actionPtr = lastAction.c_str();
-            while (*actionPtr)
-            {
-                *ptr++ = *actionPtr++;
-            }
-        }
-
-        *ptr = '\0'; // Null-terminate the string
-        return std::string(buffer);
-    }
-}
-
-// Metodo simile per getCurrentKeyCombination
-std::string MacroManager::getCurrentKeyCombination()
-{
-    if (useKeyPressOrder)
-    {
-        char buffer[64];
-        char *ptr = buffer;
-        bool first = true;
-
+        // Usa l'ordine in cui i tasti sono stati premuti
+        key.mask = 0;
+        key.order = 0;
+        uint8_t position = 0;
         for (const auto &keyInfo : keyPressOrder)
         {
-            uint8_t key = keyInfo.keyIndex;
-            if (!first)
-            {
-                *ptr++ = '+';
-            }
-
-            uint8_t row = key / keypadConfig->cols;
-            uint8_t col = key % keypadConfig->cols;
-            char keyLabel = this->keypadConfig->keys[row][col];
-            if (keyLabel != '\0')
-            {
-                *ptr++ = keyLabel;
-            }
-            first = false;
+            key.mask |= (1 << keyInfo.keyIndex);
+            key.order = ComboIndex::appendToOrder(key.order, position++, keyInfo.keyIndex);
         }
-
-        *ptr = '\0';
-        return std::string(buffer);
     }
     else
     {
-        // Implementazione originale
-        char buffer[64];
-        char *ptr = buffer;
-        bool first = true;
-
-        uint8_t totalKeys = keypadConfig->rows * keypadConfig->cols;
-        for (uint8_t key = 0; key < totalKeys; key++)
-        {
-            if (getKeyState(activeKeysMask, key))
-            {
-                if (!first)
-                {
-                    *ptr++ = '+';
-                }
-                uint8_t row = key / keypadConfig->cols;
-                uint8_t col = key % keypadConfig->cols;
-                char keyLabel = this->keypadConfig->keys[row][col];
-                if (keyLabel != '\0')
-                {
-                    *ptr++ = keyLabel;
-                }
-                first = false;
-            }
-        }
-
-        *ptr = '\0';
-        return std::string(buffer);
+        // Implementazione originale: tasti in ordine di indice
+        key.mask = activeKeysMask;
+        key.order = ComboIndex::orderFromMask(activeKeysMask);
     }
+
+    return key;
 }
 
 // Aggiungi metodo per modificare l'impostazione di ordinamento
@@ -751,60 +777,105 @@ bool MacroManager::executeCombinationActions(const std::string &comboKey)
         return false;
     }
 
-    currentActivationCombo = comboKey;
-
-    if (!lastExecutedAction.empty())
-    {
-        releaseAction(lastExecutedAction);
-        lastExecutedAction.clear();
-    }
+    // A new gesture replaces the previous one
+    releaseSlots(SLOT_GESTURE);
+    executeCombinationActions(it->first, it->second, SLOT_GESTURE, 0, false);
+    return true;
+}
 
-    bool hasChainedCommands = false;
-    for (const std::string &action : it->second)
-    {
-        if (action.find('<') != std::string::npos && action.find('>') != std::string::npos)
-        {
-            hasChainedCommands = true;
-            enqueueCommands(action);
-            break;
-        }
-    }
+void MacroManager::executeCombinationActions(const std::string &comboName, const std::vector<std::string> &actions,
+                                             uint8_t source, uint16_t keyMask, bool withButton)
+{
+    currentActivationCombo = &comboName;
 
-    if (!hasChainedCommands)
+    if (!startTimeline(actions))
     {
-        for (const std::string &action : it->second)
-        {
-            pressAction(action);
-            lastExecutedAction = action;
-        }
+        pressSlot(source, keyMask, withButton, actions);
     }
-
-    return true;
 }
 
 void MacroManager::processKeyCombination()
 {
-    if (newKeyPressed && (!pendingCombination.empty() || !pendingGestureFallback.empty()))
+    if (newKeyPressed && (hasPendingKeyCombo || !pendingCombination.empty() || !pendingGestureFallback.empty()))
     {
-        bool executed = executeCombinationActions(pendingCombination);
+        bool executed = false;
 
-        if (!executed && !pendingGestureFallback.empty())
+        if (hasPendingKeyCombo)
+        {
+            bool withButton = pendingKeyCombo.trigger == ComboIndex::TRIGGER_BUTTON;
+            const ComboIndex::Entry *entry = comboIndex.find(pendingKeyCombo);
+            if (entry)
+            {
+                // The longer combo replaces the actions of the keys it contains
+                releaseSlotsWithKeys(pendingKeyCombo.mask);
+                if (withButton)
+                {
+                    releaseButtonSlots();
+                }
+                executeCombinationActions(*entry->name, *entry->actions, SLOT_KEYS, pendingKeyCombo.mask, withButton);
+                executed = true;
+            }
+            else
+            {
+                // Rolled keys: combo of the keys that are not already holding an action
+                uint16_t freshMask = pendingKeyCombo.mask & ~heldKeysMask();
+                if (freshMask && freshMask != pendingKeyCombo.mask)
+                {
+                    ComboIndex::Key freshKey = ComboIndex::subset(pendingKeyCombo, freshMask);
+                    entry = comboIndex.find(freshKey);
+                    if (entry)
+                    {
+                        executeCombinationActions(*entry->name, *entry->actions, SLOT_KEYS, freshMask, withButton);
+                        executed = true;
+                    }
+                }
+            }
+        }
+        else
         {
-            executed = executeCombinationActions(pendingGestureFallback);
+            executed = executeCombinationActions(pendingCombination);
+
+            if (!executed && !pendingGestureFallback.empty())
+            {
+                executed = executeCombinationActions(pendingGestureFallback);
+            }
+        }
+
+        if (executed && hasPendingKeyCombo)
+        {
+            // Keys (or button) released before the combo fired: send it as a pulse
+            uint16_t releasedKeys = pendingKeyCombo.mask & ~activeKeysMask;
+            if (releasedKeys)
+            {
+                releaseSlotsWithKeys(releasedKeys);
+            }
+            if (pendingKeyCombo.trigger == ComboIndex::TRIGGER_BUTTON && lastAction != ComboIndex::TRIGGER_BUTTON)
+            {
+                releaseButtonSlots();
+            }
         }
 
         if (!executed)
         {
-            if (!lastExecutedAction.empty())
+            if (hasPendingKeyCombo)
             {
-                releaseAction(lastExecutedAction);
-                lastExecutedAction.clear();
+                releaseSlotsWithKeys(pendingKeyCombo.mask);
             }
 
-            std::string missingKey = !pendingCombination.empty() ? pendingCombination : pendingGestureFallback;
-            Logger::getInstance().log(String("combinazione non impostata") + String(missingKey.c_str()));
+            char missingKey[64];
+            if (hasPendingKeyCombo)
+            {
+                comboIndex.describe(pendingKeyCombo, missingKey, sizeof(missingKey));
+            }
+            else
+            {
+                const std::string &name = !pendingCombination.empty() ? pendingCombination : pendingGestureFallback;
+                strlcpy(missingKey, name.c_str(), sizeof(missingKey));
+            }
+            Logger::getInstance().log(String("combinazione non impostata") + String(missingKey));
         }
 
+        hasPendingKeyCombo = false;
         pendingCombination.clear();
         pendingGestureFallback.clear();
         newKeyPressed = false;
@@ -816,27 +887,23 @@ void MacroManager::clearActiveKeys()
 {
     activeKeysMask = 0;
     previousKeysMask = 0;
+    hasPendingKeyCombo = false;
     pendingCombination.clear();
     pendingGestureFallback.clear();
     newKeyPressed = false;
     keyPressOrder.clear(); // Pulisci anche l'ordine di pressione
 
-    // Reset command queue if it was in progress
-    if (processingCommandQueue)
-    {
-        commandQueue.clear();
-        processingCommandQueue = false;
-        is_action_locked = false;
-    }
+    // Stop a macro that is still playing
+    stopTimeline();
 
-    // Se c'è un'azione attiva, rilasciala
-    if (!lastExecutedAction.empty())
-    {
-        releaseAction(lastExecutedAction);
-        lastExecutedAction.clear();
-    }
+    // Rilascia tutte le azioni attive
+    releaseAllSlots();
+    encoderReleaseScheduled = false;
+
+    // Forget undecided tap-dance keys
+    tapDance.reset();
 
-    lastAction.clear();
+    lastAction = ComboIndex::TRIGGER_NONE;
 }
 
 bool MacroManager::reloadCombinationsFromManager(JsonObject newCombos)
@@ -844,7 +911,15 @@ bool MacroManager::reloadCombinationsFromManager(JsonObject newCombos)
     // Clear all active states first
     clearActiveKeys();
 
+    if (comboManager)
+    {
+        loadedComboPrefix = comboManager->getCurrentPrefix().c_str();
+        loadedComboSetNumber = comboManager->getCurrentSet();
+    }
+
     // Clear existing combinations map to free memory
+    currentActivationCombo = nullptr;
+    comboIndex.clear();
     combinations.clear();
 
     // Reload combinations from the new JsonObject
@@ -864,10 +939,64 @@ bool MacroManager::reloadCombinationsFromManager(JsonObject newCombos)
         combinations[std::string(combo.key().c_str())] = actions;
     }
 
-    Logger::getInstance().log("Reloaded " + String(combinations.size()) + " combinations into macroManager");
+    compileCombinations();
+
+    Logger::getInstance().log("Reloaded " + String(combinations.size()) + " combinations into macroManager (" +
+                              String(comboIndex.size()) + " compiled)");
     return combinations.size() > 0;
 }
 
+void MacroManager::compileCombinations()
+{
+    if (keypadConfig)
+    {
+        comboIndex.build(combinations, *keypadConfig);
+        tapDance.configure(comboIndex, keypadConfig->tappingTerm);
+    }
+
+    // Pre-compile the HID programs and pre-build the commands so key presses
+    // never parse "S_B:" strings or allocate Command objects
+    stopTimeline(); // Held commands and steps point into the pools cleared below
+    releaseAllSlots();
+    chainedCommands.clear();
+    if (bleController)
+    {
+        bleController->clearPrograms();
+    }
+    if (commandFactory)
+    {
+        commandFactory->clearPool();
+    }
+
+    for (const auto &combo : combinations)
+    {
+        for (const std::string &action : combo.second)
+        {
+            std::vector<std::string> commands = parseChainedCommands(action);
+            if (isChainedAction(action))
+            {
+                chainedCommands[action] = commands;
+            }
+
+            for (const std::string &command : commands)
+            {
+                if (command.rfind("DELAY_", 0) == 0)
+                {
+                    continue; // A timeline gap, not a command
+                }
+                if (commandFactory)
+                {
+                    commandFactory->acquire(command); // BleCommand compiles its HID program here
+                }
+                else if (bleController && command.rfind("S_B:", 0) == 0)
+                {
+                    bleController->getProgram(command);
+                }
+            }
+        }
+    }
+}
+
 bool MacroManager::hasPendingComboSwitch()
 {
     return pendingComboSwitchFlag;
@@ -905,9 +1034,8 @@ bool MacroManager::isGyroModeActive() const
 
 void MacroManager::saveCurrentComboForGyro()
 {
-    String currentPrefix = comboManager->getCurrentPrefix();
-    savedComboPrefix = std::string(currentPrefix.c_str());
-    savedComboSetNumber = comboManager->getCurrentSet();
+    savedComboPrefix = loadedComboPrefix;
+    savedComboSetNumber = loadedComboSetNumber;
     hasSavedCombo = true;
 }
 
@@ -935,24 +1063,29 @@ void MacroManager::setActionLocked(bool locked)
 
 const std::string& MacroManager::getCurrentActivationCombo() const
 {
-    return currentActivationCombo;
+    static const std::string none;
+    return currentActivationCombo ? *currentActivationCombo : none;
 }
 
 void MacroManager::update()
 {
     unsigned long currentTime = millis();
 
-    // Process command queue if active
-    if (processingCommandQueue)
+    // Advance a playing macro; key combinations keep being processed meanwhile
+    processTimeline();
+
+    // Tap-dance keys decided by the tapping term
+    if (tapDance.isActive())
     {
-        processCommandQueue();
-        return; // Skip other processing while queue is active
+        tapDance.update(currentTime);
+        drainTapDance();
     }
 
-    // Process pending combination if the combo_delay has passed and a new key was pressed
+    // Process pending combination if the combo_delay has passed and a new key was pressed,
+    // or right away when no longer combination can start with the pressed keys
     if (newKeyPressed &&
-        (!pendingCombination.empty() || !pendingGestureFallback.empty()) &&
-        (currentTime - lastCombinationTime >= combo_delay))
+        (hasPendingKeyCombo || !pendingCombination.empty() || !pendingGestureFallback.empty()) &&
+        ((hasPendingKeyCombo && pendingFiresEarly) || currentTime - lastCombinationTime >= combo_delay))
     {
         processKeyCombination();
     }
@@ -970,13 +1103,7 @@ void MacroManager::update()
     // Gestione del rilascio programmato dell'encoder
     if (encoderReleaseScheduled && currentTime >= encoderReleaseTime)
     {
-        if (!encoderPendingAction.empty())
-        {
-            releaseAction(encoderPendingAction);
-            // Logger::getInstance().log("Auto-releasing encoder action: " + String(encoderPendingAction.c_str()));
-            encoderPendingAction.clear();
-            lastExecutedAction.clear();
-        }
+        releaseSlots(SLOT_ENCODER);
         encoderReleaseScheduled = false;
     }
 
@@ -985,11 +1112,41 @@ void MacroManager::update()
     // Logger::getInstance().processBuffer();
 }
 
-void MacroManager::releaseGestureActions()
+unsigned long MacroManager::getNextWakeDelayMs() const
 {
-    if (!lastExecutedAction.empty())
+    unsigned long currentTime = millis();
+    unsigned long nearest = ULONG_MAX;
+    auto until = [&](unsigned long deadline) {
+        long remaining = (long)(deadline - currentTime);
+        nearest = std::min(nearest, remaining > 0 ? (unsigned long)remaining : 0UL);
+    };
+
+    if (timelineActive)
+    {
+        until(nextTimelineTime);
+    }
+
+    nearest = std::min(nearest, tapDance.msUntilDeadline(currentTime));
+
+    if (newKeyPressed && (hasPendingKeyCombo || !pendingCombination.empty() || !pendingGestureFallback.empty()))
     {
-        releaseAction(lastExecutedAction);
-        lastExecutedAction.clear();
+        until((hasPendingKeyCombo && pendingFiresEarly) ? currentTime : lastCombinationTime + combo_delay);
     }
+
+    if (gestureExecuted)
+    {
+        until(gestureExecutionTime + GESTURE_HOLD_TIME + 1);
+    }
+
+    if (encoderReleaseScheduled)
+    {
+        until(encoderReleaseTime);
+    }
+
+    return nearest;
+}
+
+void MacroManager::releaseGestureActions()
+{
+    releaseSlots(SLOT_GESTURE);
 }
@@ -10,6 +10,9 @@
 #include <ArduinoJson.h>
 #include "inputDevice.h"
 #include "configTypes.h"
+#include "ComboIndex.h"
+#include "MacroTimeline.h"
+#include "TapDanceEngine.h"
 
 // Forward declarations for dependency injection
 class WIFIManager;
@@ -22,7 +25,14 @@ class CommandFactory;
 class Command;
 
 #define GESTURE_HOLD_TIME 200 // Tempo di mantenimento della gesture in ms
-#define COMMAND_DELAY 200 // Delay between chained commands in ms
+#define COMMAND_DELAY 200 // Hold time of each chained command in ms
+
+#ifndef MAX_ACTION_SLOTS
+    #define MAX_ACTION_SLOTS 8 // Combo actions held at the same time; more are ignored until one is released
+#endif
+#ifndef MAX_SLOT_COMMANDS
+    #define MAX_SLOT_COMMANDS 4 // Commands held by a single combo
+#endif
 
 class MacroManager
 {
@@ -40,6 +50,10 @@ public:
         const WifiConfig* wifiConfig);
     void handleInputEvent(const InputEvent &event);
     void update();
+
+    // Milliseconds until update() has time-driven work (timeline, combo_delay,
+    // tap-dance, releases), ULONG_MAX when it only reacts to input
+    unsigned long getNextWakeDelayMs() const;
     void clearActiveKeys();
     void setUseKeyPressOrder(bool useOrder);
     bool getUseKeyPressOrder() const { return useKeyPressOrder; }
@@ -69,6 +83,7 @@ public:
 
     // Configurazione delle combinazioni
     std::map<std::string, std::vector<std::string>> combinations;
+    void compileCombinations(); // Rebuild comboIndex after editing combinations
     unsigned long combo_delay = 50; // Default delay in ms
     unsigned long encoder_pulse_duration = 150; // Durata dell'impulso dell'encoder in ms
 
@@ -84,8 +99,32 @@ private:
     const KeypadConfig* keypadConfig;
     const WifiConfig* wifiConfig;
 
-    // Command execution state
-    std::unique_ptr<Command> _lastExecutedCommand;
+    // Actions held at the same time, each owned by the keys/trigger that fired it,
+    // so overlapping combos press and release independently
+    enum SlotSource : uint8_t
+    {
+        SLOT_KEYS,      // Key combination, optionally with the encoder button
+        SLOT_ENCODER,   // Encoder pulse, released after encoder_pulse_duration
+        SLOT_GESTURE,   // Gesture, released after GESTURE_HOLD_TIME
+        SLOT_TAP_DANCE  // Tap-dance decision, released with its key
+    };
+    struct ActionSlot
+    {
+        bool used;
+        uint8_t source;
+        bool withButton;  // Released when the encoder button goes up
+        uint16_t keyMask; // Released when any of these keys goes up
+        uint8_t commandCount;
+        Command* commands[MAX_SLOT_COMMANDS]; // Pooled by CommandFactory, not owned
+    };
+    ActionSlot actionSlots[MAX_ACTION_SLOTS] = {};
+    void pressSlot(uint8_t source, uint16_t keyMask, bool withButton, const std::vector<std::string> &actions);
+    void releaseSlot(ActionSlot &slot);
+    void releaseSlots(uint8_t source);
+    void releaseSlotsWithKeys(uint16_t keyMask);
+    void releaseButtonSlots();
+    void releaseAllSlots();
+    uint16_t heldKeysMask() const;
 
     // Struttura per tenere traccia dell'ordine di pressione dei tasti
     struct KeyPressInfo {
@@ -103,34 +142,46 @@ private:
     unsigned long rotationReleaseTime;
     unsigned long lastActionTime;
     unsigned long encoderReleaseTime; // Tempo per il rilascio dell'encoder
-    std::string pendingCombination;
+    ComboIndex comboIndex;       // Compiled key/encoder combinations
+    ComboIndex::Key pendingKeyCombo;
+    bool hasPendingKeyCombo = false;
+    bool pendingFiresEarly = false; // No longer combo can follow: skip combo_delay
+    std::string pendingCombination; // Gesture combinations are still resolved by name
     std::string pendingGestureFallback;
-    std::string lastAction;
-    std::string lastExecutedAction;
-    std::string currentActivationCombo; // Combo che ha attivato l'azione corrente
-    std::string encoderPendingAction; // Azione dell'encoder in attesa di rilascio
+    uint8_t lastAction = ComboIndex::TRIGGER_NONE; // BUTTON while the encoder button is held
+    const std::string *currentActivationCombo = nullptr; // Combo che ha attivato l'azione corrente
     bool is_action_locked = false;
     bool gestureExecuted = false;
-    bool wasPartOfCombo = false;
     bool newKeyPressed = false; // Flag to track when a new key is pressed
     bool encoderReleaseScheduled = false; // Flag per indicare il rilascio programmato dell'encoder
     unsigned long gestureExecutionTime = 0;
 
-    // Command chaining functionality
-    std::vector<std::string> commandQueue;
-    unsigned long nextCommandTime;
-    bool processingCommandQueue = false;
+    // Command chaining functionality: <...> chains and arrays with DELAY_
+    // steps play on a non-blocking timeline drained by update()
+    MacroTimeline timeline;
+    std::map<std::string, std::vector<std::string>> chainedCommands; // Parsed once per combo set
+    Command* timelineHeldCommand = nullptr;
+    unsigned long nextTimelineTime = 0;
+    bool timelineActive = false;
     std::vector<std::string> parseChainedCommands(const std::string &compositeAction);
-    void processCommandQueue();
+    void processTimeline();
+    void stopTimeline();
+    bool startTimeline(const std::vector<std::string> &actions);
     void enqueueCommands(const std::string &compositeAction);
+    void enqueueSteps(const std::vector<std::string> &commands);
+
+    // Tap / hold / double-tap keys ("1:HOLD", "1:DTAP", ...)
+    TapDanceEngine tapDance;
+    void handleKeyEvent(uint8_t key, bool pressed);
+    void drainTapDance();
+    void executeTapDance(const TapDanceEngine::Output &output);
 
-    void pressAction(const std::string &action);
-    void releaseAction(const std::string &action);
-    std::string getCurrentCombination();
-    std::string getOrderAwareCombination();
-    std::string getCurrentKeyCombination(); // Get only key combination without encoder/button actions
+    Command* pressAction(const std::string &action);
+    ComboIndex::Key getCurrentCombination(uint8_t trigger) const;
     void processKeyCombination();
-    bool executeCombinationActions(const std::string &comboKey);
+    bool executeCombinationActions(const std::string &comboKey); // Gestures
+    void executeCombinationActions(const std::string &comboName, const std::vector<std::string> &actions,
+                                   uint8_t source, uint16_t keyMask, bool withButton);
     void releaseGestureActions();
 
     // Pending combo switch request
@@ -143,6 +194,11 @@ private:
     bool hasSavedCombo = false;
     std::string savedComboPrefix;
     int savedComboSetNumber = 0;
+
+    // Set whose combinations are loaded, copied from comboManager on reload: the
+    // background task rewrites comboManager while the input task runs
+    std::string loadedComboPrefix;
+    int loadedComboSetNumber = 0;
 };
 
 #endif // MACRO_MANAGER_H
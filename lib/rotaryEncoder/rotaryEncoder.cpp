@@ -18,11 +18,20 @@
 
 
 #include "rotaryEncoder.h"
+#include "Logger.h"
+#include "LoopWake.h"
+#include <driver/pcnt.h>
+#include <soc/gpio_reg.h>
+#include <soc/soc.h>
+#include <limits.h>
+
+#define ENCODER_PCNT_UNIT PCNT_UNIT_0
 
 // State transition table for encoder direction detection
 // Rows: lastState, Columns: currentState
 // Values: -1 = CCW, 0 = invalid/no change, 1 = CW
-const int8_t RotaryEncoder::stateTransitionTable[4][4] = {
+// Kept in DRAM: the ISR backend reads it from interrupt context
+DRAM_ATTR const int8_t RotaryEncoder::stateTransitionTable[4][4] = {
     { 0,  1, -1,  0}, // Last state 00
     {-1,  0,  0,  1}, // Last state 01
     { 1,  0,  0, -1}, // Last state 10
@@ -31,6 +40,19 @@ const int8_t RotaryEncoder::stateTransitionTable[4][4] = {
 
 RotaryEncoder::RotaryEncoder(const EncoderConfig* config) : config(config) {}
 
+RotaryEncoder::~RotaryEncoder() {
+    if (backend == EncoderBackend::ISR) {
+        detachInterrupt(config->pinA);
+        detachInterrupt(config->pinB);
+    } else if (backend == EncoderBackend::PCNT) {
+        pcnt_counter_pause(ENCODER_PCNT_UNIT);
+        detachInterrupt(config->pinA);
+    }
+    if (wakeInterruptsAttached) {
+        detachInterrupt(config->buttonPin);
+    }
+}
+
 void RotaryEncoder::setup() {
     // Configure pins with explicit pullup resistors
     pinMode(config->pinA, INPUT_PULLUP);
@@ -39,6 +61,94 @@ void RotaryEncoder::setup() {
     
     // Get initial state
     lastState = (digitalRead(config->pinA) << 1) | digitalRead(config->pinB);
+
+    backend = config->backend;
+    if (backend == EncoderBackend::PCNT && !setupPcnt()) {
+        Logger::getInstance().log("Encoder: PCNT setup failed, falling back to polling");
+        backend = EncoderBackend::POLL;
+    } else if (backend == EncoderBackend::ISR) {
+        setupIsr();
+    }
+
+    // Hardware backends count without the loop: only wake it (tickless mode).
+    // The polled backend has to be scanned anyway.
+    if (backend != EncoderBackend::POLL) {
+        if (backend == EncoderBackend::PCNT) {
+            attachInterruptArg(config->pinA, onWakeEdge, this, CHANGE);
+        }
+        attachInterruptArg(config->buttonPin, onWakeEdge, this, CHANGE);
+        wakeInterruptsAttached = true;
+    }
+}
+
+// Full x4 quadrature on one unit: channel 0 counts A edges, channel 1 B edges,
+// each using the other pin to pick the direction. Same sign as stateTransitionTable.
+bool RotaryEncoder::setupPcnt() {
+    pcnt_config_t pcntConfig = {};
+    pcntConfig.unit = ENCODER_PCNT_UNIT;
+    pcntConfig.counter_h_lim = ENCODER_PCNT_LIMIT;
+    pcntConfig.counter_l_lim = -ENCODER_PCNT_LIMIT;
+
+    pcntConfig.channel = PCNT_CHANNEL_0;
+    pcntConfig.pulse_gpio_num = config->pinA;
+    pcntConfig.ctrl_gpio_num = config->pinB;
+    pcntConfig.pos_mode = PCNT_COUNT_INC;   // A rising with B high: CW
+    pcntConfig.neg_mode = PCNT_COUNT_DEC;   // A falling with B high: CCW
+    pcntConfig.hctrl_mode = PCNT_MODE_KEEP;
+    pcntConfig.lctrl_mode = PCNT_MODE_REVERSE;
+    if (pcnt_unit_config(&pcntConfig) != ESP_OK) {
+        return false;
+    }
+
+    pcntConfig.channel = PCNT_CHANNEL_1;
+    pcntConfig.pulse_gpio_num = config->pinB;
+    pcntConfig.ctrl_gpio_num = config->pinA;
+    pcntConfig.pos_mode = PCNT_COUNT_DEC;   // B rising with A high: CCW
+    pcntConfig.neg_mode = PCNT_COUNT_INC;   // B falling with A high: CW
+    if (pcnt_unit_config(&pcntConfig) != ESP_OK) {
+        return false;
+    }
+
+    // Filter length in APB cycles (80 MHz, 12.5 ns each), 10 bit register
+    uint32_t filterCycles = (static_cast<uint32_t>(config->glitchFilterNs) * 2) / 25;
+    if (filterCycles > 0) {
+        pcnt_set_filter_value(ENCODER_PCNT_UNIT, std::min<uint32_t>(filterCycles, 1023));
+        pcnt_filter_enable(ENCODER_PCNT_UNIT);
+    }
+
+    pcnt_counter_pause(ENCODER_PCNT_UNIT);
+    pcnt_counter_clear(ENCODER_PCNT_UNIT);
+    pcnt_counter_resume(ENCODER_PCNT_UNIT);
+    lastPcntCount = 0;
+    return true;
+}
+
+void RotaryEncoder::setupIsr() {
+    isrState = lastState;
+    isrCount = 0;
+    lastIsrCount = 0;
+    attachInterruptArg(config->pinA, onEncoderEdge, this, CHANGE);
+    attachInterruptArg(config->pinB, onEncoderEdge, this, CHANGE);
+}
+
+void IRAM_ATTR RotaryEncoder::onEncoderEdge(void* arg) {
+    RotaryEncoder* encoder = static_cast<RotaryEncoder*>(arg);
+    byte pinA = encoder->config->pinA;
+    byte pinB = encoder->config->pinB;
+    uint32_t low = REG_READ(GPIO_IN_REG);
+    uint32_t high = REG_READ(GPIO_IN1_REG);
+    uint8_t a = (pinA < 32) ? (low >> pinA) & 1 : (high >> (pinA - 32)) & 1;
+    uint8_t b = (pinB < 32) ? (low >> pinB) & 1 : (high >> (pinB - 32)) & 1;
+    uint8_t state = (a << 1) | b;
+
+    // Invalid jumps (both pins changed) count as zero, like a bounce
+    encoder->isrCount += stateTransitionTable[encoder->isrState][state];
+    encoder->isrState = state;
+    LoopWake::notifyFromISR(LoopWake::WAKE_ENCODER);
+}
+
+void IRAM_ATTR RotaryEncoder::onWakeEdge(void* arg) {
+    LoopWake::notifyFromISR(LoopWake::WAKE_ENCODER);
 }
 
 bool RotaryEncoder::readEncoder(int& direction) {
@@ -78,33 +188,112 @@ bool RotaryEncoder::readEncoder(int& direction) {
     return false;
 }
 
+// Whole detents since the last call, signed; the remainder waits for more transitions
+int RotaryEncoder::countsToDetents(int32_t counts) {
+    pendingCounts += counts;
+    int detents = pendingCounts / ENCODER_COUNTS_PER_DETENT;
+    pendingCounts -= detents * ENCODER_COUNTS_PER_DETENT;
+    return detents;
+}
+
+int RotaryEncoder::readDetents() {
+    switch (backend) {
+    case EncoderBackend::PCNT: {
+        int16_t count = 0;
+        pcnt_get_counter_value(ENCODER_PCNT_UNIT, &count);
+        // The counter wraps to 0 at either limit, so it is the position modulo the limit
+        int32_t delta = static_cast<int32_t>(count) - lastPcntCount;
+        if (delta > ENCODER_PCNT_LIMIT / 2) {
+            delta -= ENCODER_PCNT_LIMIT;
+        } else if (delta < -ENCODER_PCNT_LIMIT / 2) {
+            delta += ENCODER_PCNT_LIMIT;
+        }
+        lastPcntCount = count;
+        return countsToDetents(delta);
+    }
+    case EncoderBackend::ISR: {
+        int32_t count = isrCount;
+        int32_t delta = count - lastIsrCount;
+        lastIsrCount = count;
+        return countsToDetents(delta);
+    }
+    default: {
+        int direction = 0;
+        return readEncoder(direction) ? direction : 0;
+    }
+    }
+}
+
+// Scale detents by the acceleration curve at the current spin speed
+int RotaryEncoder::accelerate(int detents, unsigned long now) {
+    int direction = detents > 0 ? 1 : -1;
+    unsigned long elapsed = now - lastDetentTime;
+    lastDetentTime = now;
+
+    if (config->accelMaxMultiplier <= 1) {
+        return detents;
+    }
+
+    // Reversing or resuming after a pause starts again from one step per detent
+    if (elapsed > ENCODER_ACCEL_RESET_MS || direction != lastDirection) {
+        speed = 0;
+        stepRemainder = 0;
+    } else {
+        float instant = abs(detents) * 1000.0f / std::max<unsigned long>(elapsed, 1);
+        speed += (instant - speed) * 0.5f;
+    }
+    lastDirection = direction;
+
+    float multiplier = 1.0f;
+    if (speed > config->accelMinSpeed) {
+        float ramp = 1.0f;
+        if (config->accelMaxSpeed > config->accelMinSpeed) {
+            ramp = (speed - config->accelMinSpeed) / (config->accelMaxSpeed - config->accelMinSpeed);
+            ramp = std::min(ramp, 1.0f);
+        }
+        multiplier += (config->accelMaxMultiplier - 1) * ramp;
+    }
+
+    float steps = abs(detents) * multiplier + stepRemainder;
+    int wholeSteps = static_cast<int>(steps);
+    stepRemainder = steps - wholeSteps;
+    return direction * wholeSteps;
+}
+
 bool RotaryEncoder::processInput() {
-    bool hasNewEvent = false;
     unsigned long currentTime = millis();
-    
-    // Handle release timing
-    if (waitingForRelease && (currentTime - lastRotationTime >= 50)) {
-        currentEvent.type = InputEvent::EventType::ROTATION;
-        currentEvent.value1 = 0;
-        currentEvent.value2 = encoderValue;
-        currentEvent.state = false;
-        currentEvent.text = "";
-        waitingForRelease = false;
-        hasNewEvent = true;
-    }
-    
+
     // Handle encoder rotation
-    int direction = 0;
-    if (readEncoder(direction)) {
+    int detents = readDetents();
+    if (detents != 0) {
+        int steps = accelerate(detents, currentTime);
+        if ((steps > 0) != (pendingSteps > 0)) {
+            pendingSteps = 0; // Reversal drops steps not handed out yet
+        }
+        pendingSteps = constrain(pendingSteps + steps, -ENCODER_MAX_PENDING_STEPS, ENCODER_MAX_PENDING_STEPS);
+    }
+
+    if (pendingSteps != 0) {
+        int direction = pendingSteps > 0 ? 1 : -1;
+        pendingSteps -= direction;
         currentEvent.type = InputEvent::EventType::ROTATION;
         currentEvent.value1 = direction * config->stepValue;
         currentEvent.value2 = encoderValue + (direction * config->stepValue);
         currentEvent.state = true;
-        currentEvent.text = "";
         encoderValue += direction * config->stepValue;
         lastRotationTime = currentTime;
         waitingForRelease = true;
-        hasNewEvent = true;
+        return true;
+    }
+    
+    // Handle release timing
+    if (waitingForRelease && (currentTime - lastRotationTime >= 50)) {
+        currentEvent.type = InputEvent::EventType::ROTATION;
+        currentEvent.value1 = 0;
+        currentEvent.value2 = encoderValue;
+        currentEvent.state = false;
+        waitingForRelease = false;
+        return true;
     }
 
     // Handle encoder button
@@ -114,12 +303,25 @@ bool RotaryEncoder::processInput() {
         currentEvent.value1 = 0;
         currentEvent.value2 = 0;
         currentEvent.state = (reading == LOW);
-        currentEvent.text = "";
         lastButtonState = reading;
-        hasNewEvent = true;
+        return true;
     }
 
-    return hasNewEvent;
+    return false;
+}
+
+unsigned long RotaryEncoder::getNextPollDelayMs(unsigned long pollPeriodMs) const {
+    if (pendingSteps != 0) {
+        return 0;
+    }
+    if (backend == EncoderBackend::POLL) {
+        return pollPeriodMs;
+    }
+    if (waitingForRelease) {
+        unsigned long elapsed = millis() - lastRotationTime;
+        return elapsed >= 50 ? 0 : 50 - elapsed;
+    }
+    return ULONG_MAX;
 }
 
 InputEvent RotaryEncoder::getEvent() {
@@ -24,11 +24,23 @@
 #include "inputDevice.h"
 #include "configManager.h"
 
+#ifndef ENCODER_MAX_PENDING_STEPS
+    #define ENCODER_MAX_PENDING_STEPS 16 // Accelerated steps waiting to be handed out
+#endif
+
+#ifndef ENCODER_ACCEL_RESET_MS
+    #define ENCODER_ACCEL_RESET_MS 250 // A pause this long drops the speed estimate back to zero
+#endif
+
+#define ENCODER_COUNTS_PER_DETENT 4 // Quadrature transitions per click
+#define ENCODER_PCNT_LIMIT 32000    // PCNT wraps to 0 at +/- this value; multiple of 4
+
 class RotaryEncoder : public InputDevice {
 private:
     InputEvent currentEvent;
     bool hasEvent = false;
     const EncoderConfig* config;
+    EncoderBackend backend = EncoderBackend::POLL; // Backend actually running
     
     // Encoder state
     volatile int encoderValue = 0;
@@ -41,6 +53,21 @@ private:
     uint8_t rotaryCounter = 0;
     bool lastPinAState = false;
     bool lastPinBState = false;
+
+    // PCNT / ISR backends: transitions counted outside the loop, turned into
+    // detents here. The ISR is the only writer of isrCount.
+    volatile int32_t isrCount = 0;
+    volatile uint8_t isrState = 0;
+    int32_t lastIsrCount = 0;
+    int16_t lastPcntCount = 0;
+    int32_t pendingCounts = 0; // Transitions not yet making a whole detent
+
+    // Velocity estimate and acceleration
+    unsigned long lastDetentTime = 0;
+    float speed = 0;         // Detents per second, smoothed
+    float stepRemainder = 0; // Fractional steps carried to the next detent
+    int lastDirection = 0;
+    int pendingSteps = 0;    // Signed steps still to hand out, one ROTATION event each
     
     // Release timing
     unsigned long lastRotationTime = 0;
@@ -50,12 +77,37 @@ private:
     static const int8_t stateTransitionTable[4][4];
 
     bool readEncoder(int& direction);
+    bool setupPcnt();
+    void setupIsr();
+    static void IRAM_ATTR onEncoderEdge(void* arg);
+    static void IRAM_ATTR onWakeEdge(void* arg);
+    bool wakeInterruptsAttached = false;
+    int readDetents();
+    int countsToDetents(int32_t counts);
+    int accelerate(int detents, unsigned long now);
 
 public:
     RotaryEncoder(const EncoderConfig* config);
+    ~RotaryEncoder();
     void setup() override;
+
+    /**
+     * @brief Read the encoder and hand out at most one event per call.
+     *
+     * With acceleration a fast detent can be worth several steps; each step
+     * is its own ROTATION event so the bound action repeats.
+     */
     bool processInput() override;
     InputEvent getEvent() override;
+
+    /**
+     * @brief Milliseconds until processInput() has work without an interrupt.
+     *
+     * 0 while steps are queued, the time left before the release event,
+     * pollPeriodMs for the polled backend, ULONG_MAX otherwise: the PCNT
+     * and ISR backends wake the loop through LoopWake on every edge.
+     */
+    unsigned long getNextPollDelayMs(unsigned long pollPeriodMs) const;
     int getEncoderValue();
     void resetEncoderValue();
 };
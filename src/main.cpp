@@ -20,6 +20,7 @@
 #include <esp_system.h>
 #include <esp_err.h>
 #include <esp_log.h>
+#include <algorithm>
 
 #include <ArduinoJson.h>
 #include "Logger.h"
@@ -39,7 +40,14 @@
 #include "configWebServer.h"
 #include "EventScheduler.h"
 #include "SchedulerStorage.h"
+#include "SpecialActionRouter.h"
 #include "CommandFactory.h"
+#include "LoopWake.h"
+#include "InputTrace.h"
+#include "TemplateGestureRecognizer.h"
+#include "GestureClassifier.h"
+#include "GestureDataset.h"
+#include "GyroBiasModel.h"
 
 WIFIManager wifiManager; // Create an instance of WIFIManager
 
@@ -48,6 +56,8 @@ PowerManager powerManager;
 CombinationManager comboManager;
 GestureRead gestureSensor; // Definizione effettiva (deve rimanere UNICA)
 GestureAnalyze gestureAnalyzer(gestureSensor);
+TemplateGestureRecognizer gestureTemplates;
+GestureClassifier gestureClassifier;
 SpecialAction specialAction;
 BLEController bleController;
 // modificare blecontroller.start??
@@ -57,8 +67,59 @@ GyroMouse gyroMouse;
 EventScheduler eventScheduler;
 CommandFactory* commandFactory = nullptr;
 
-// Task function prototype
+#ifndef INPUT_TASK_PRIORITY
+    #define INPUT_TASK_PRIORITY 3 // Above the gesture task: scanning and HID never wait for it
+#endif
+#ifndef BACKGROUND_TASK_PRIORITY
+    #define BACKGROUND_TASK_PRIORITY 1
+#endif
+#ifndef INPUT_TASK_PERIOD_MS
+    #define INPUT_TASK_PERIOD_MS 5
+#endif
+#ifndef BACKGROUND_TASK_PERIOD_MS
+    #define BACKGROUND_TASK_PERIOD_MS 10 // Longest wait for a scheduler input event
+#endif
+#ifndef BACKGROUND_TASK_IDLE_MS
+    #define BACKGROUND_TASK_IDLE_MS 250 // Same, in tickless mode with no scheduler deadline closer
+#endif
+#define SCHEDULER_EVENT_QUEUE_SIZE 16
+
+// Combo switch requested by an action, loaded from LittleFS by the background task
+struct ComboSwitchRequest
+{
+    char prefix[32];
+    int setNumber;
+};
+
+// Input task -> background task
+QueueHandle_t schedulerEventQueue = nullptr; // InputEvent copies for EventScheduler
+QueueHandle_t comboSwitchQueue = nullptr;    // ComboSwitchRequest
+// Background task -> input task: new combo file loaded, apply it; and back: applied
+SemaphoreHandle_t combosLoaded = nullptr;
+SemaphoreHandle_t combosApplied = nullptr;
+volatile bool comboApplyResult = false;
+
+// Scheduler special action handed to the input task, which owns specialAction; the
+// caller waits, so the request only points at its own locals
+struct SchedulerActionRequest
+{
+    const String *actionId;
+    JsonVariantConst params;
+    String *message;
+    int *statusCode;
+    bool result;
+};
+SchedulerActionRequest schedulerAction;
+SemaphoreHandle_t schedulerActionLock = nullptr;  // One request at a time (background or web task)
+SemaphoreHandle_t schedulerActionReady = nullptr;
+SemaphoreHandle_t schedulerActionDone = nullptr;
+TaskHandle_t inputTaskHandle = nullptr;
+
+// Task function prototypes
 void mainLoopTask(void *parameter);
+void backgroundTask(void *parameter);
+static bool runSpecialActionOnInputTask(const String &actionId, JsonVariantConst params, String &message,
+                                        int &statusCode);
 
 void initConfig() {
     // Load configuration first
@@ -106,6 +167,7 @@ void initScheduler() {
     SchedulerConfig schedulerConfig = configManager.getSchedulerConfig();
     SchedulerStorage schedulerStorage;
     schedulerStorage.loadConfig(&schedulerConfig);
+    eventScheduler.setSpecialActionRunner(runSpecialActionOnInputTask);
     eventScheduler.begin(schedulerConfig);
 }
 
@@ -129,25 +191,8 @@ void initMacroManagerAndCombos() {
         &configManager.getKeypadConfig(),
         &configManager.getWifiConfig());
 
-    // Load combinations into macroManager
-    {
-        JsonObject combos = comboManager.getCombinations();
-        for (JsonPair combo : combos)
-        {
-            // Skip _settings entry as it's not a key combination
-            if (String(combo.key().c_str()) == "_settings")
-            {
-                continue;
-            }
-
-            std::vector<std::string> actions;
-            for (JsonVariant v : combo.value().as<JsonArray>())
-            {
-                actions.push_back(std::string(v.as<const char *>()));
-            }
-            macroManager.combinations[std::string(combo.key().c_str())] = actions;
-        }
-    }
+    // Load and compile combinations into macroManager
+    macroManager.reloadCombinationsFromManager(comboManager.getCombinations());
 
     // Internal loaded combinations
     Logger::getInstance().log("Loaded " + String(macroManager.combinations.size()) + " combinations");
@@ -174,6 +219,9 @@ void initPeripherals() {
         }
         Logger::getInstance().log(message);
 
+        // Bias model learned in earlier sessions, applied from the first sample
+        GyroBiasModel::getInstance().load();
+
         // Start the sensor
         if (!gestureSensor.begin(accelConfig))
         {
@@ -192,6 +240,12 @@ void initPeripherals() {
             }
 
             gestureAnalyzer.setSensorType(accelConfig.type);
+            gestureTemplates.load();
+            gestureAnalyzer.addRecognizer(&gestureTemplates);
+            if (gestureClassifier.load())
+            {
+                gestureAnalyzer.addRecognizer(&gestureClassifier);
+            }
             Logger::getInstance().log("Gesture analyzer is ready.");
 
             if (gyroMouse.begin(&gestureSensor, configManager.getGyroMouseConfig()))
@@ -210,16 +264,34 @@ void initPeripherals() {
 }
 
 void startMainLoopTask() {
-    // Create main loop task with sufficient stack size
+    schedulerEventQueue = xQueueCreate(SCHEDULER_EVENT_QUEUE_SIZE, sizeof(InputEvent));
+    comboSwitchQueue = xQueueCreate(2, sizeof(ComboSwitchRequest));
+    combosLoaded = xSemaphoreCreateBinary();
+    combosApplied = xSemaphoreCreateBinary();
+    schedulerActionLock = xSemaphoreCreateMutex();
+    schedulerActionReady = xSemaphoreCreateBinary();
+    schedulerActionDone = xSemaphoreCreateBinary();
+
+    // Input/HID task: only scans and dispatches, never touches LittleFS or the log output
     xTaskCreateUniversal(
         mainLoopTask,   // Task function
         "mainLoopTask", // Task name
         //  32768,          // 32KB stack size
         16384, // 16KB stack size
         NULL,  // Parameters
-        2,     // Priority (same as gesture task)
-        NULL,  // Task handle,
+        INPUT_TASK_PRIORITY,
+        &inputTaskHandle,
         CONFIG_ARDUINO_RUNNING_CORE);
+
+    // Scheduler, IR learning, combo file loading, sleep and log flushing on the other core
+    xTaskCreateUniversal(
+        backgroundTask,
+        "backgroundTask",
+        8192,
+        NULL,
+        BACKGROUND_TASK_PRIORITY,
+        NULL,
+        CONFIG_ARDUINO_RUNNING_CORE == 0 ? 1 : 0);
 }
 
 void initConnectivity() {
@@ -349,8 +421,8 @@ void setup()
         &comboManager
     );
 
-    initMacroManagerAndCombos();
     commandFactory->setMacroManager(&macroManager);
+    initMacroManagerAndCombos();
     initPeripherals();
     startMainLoopTask();
 
@@ -365,11 +437,138 @@ void setup()
     Logger::getInstance().log("Press keys or rotate encoder to test...");
 }
 
+// Input task side of a combo switch: hand the request to the background task
+static void forwardComboSwitch()
+{
+    if (!macroManager.hasPendingComboSwitch())
+    {
+        return;
+    }
+
+    std::string prefix;
+    int setNumber;
+    macroManager.getPendingComboSwitch(prefix, setNumber);
+    macroManager.clearPendingComboSwitch();
+
+    ComboSwitchRequest request = {};
+    strlcpy(request.prefix, prefix.c_str(), sizeof(request.prefix));
+    request.setNumber = setNumber;
+    if (xQueueSend(comboSwitchQueue, &request, 0) != pdTRUE)
+    {
+        Logger::getInstance().log("Combo switch already pending, request dropped");
+    }
+}
+
+// Input task side: swap in combinations the background task has loaded
+static void applyLoadedCombos()
+{
+    if (xSemaphoreTake(combosLoaded, 0) != pdTRUE)
+    {
+        return;
+    }
+
+    // The background task waits on combosApplied, so comboManager is not being written
+    JsonObject newCombos = comboManager.getCombinations();
+    comboApplyResult = macroManager.reloadCombinationsFromManager(newCombos);
+    if (comboApplyResult)
+    {
+        const ComboSettings &comboSettings = comboManager.getSettings();
+        // Load interactive lighting colors from combo settings
+        inputHub.updateReactiveLightingColors(comboSettings);
+
+        // A mode with its own LED color makes it the system color (with brightness scaling);
+        // without one the current color is kept, so switching modes stays consistent
+        if (specialAction.getCurrentLedMode() == SpecialAction::LedMode::NONE && comboSettings.hasLedColor())
+        {
+            specialAction.setSystemLedColor(comboSettings.ledR, comboSettings.ledG, comboSettings.ledB, true);
+        }
+    }
+    xSemaphoreGive(combosApplied);
+}
+
+// Scheduler side: run the action on the input task and wait for its result
+static bool runSpecialActionOnInputTask(const String &actionId, JsonVariantConst params, String &message,
+                                        int &statusCode)
+{
+    if (!inputTaskHandle || xTaskGetCurrentTaskHandle() == inputTaskHandle)
+    {
+        return handleSpecialActionRequest(actionId, params, message, statusCode);
+    }
+
+    xSemaphoreTake(schedulerActionLock, portMAX_DELAY);
+    schedulerAction = {&actionId, params, &message, &statusCode, false};
+    xSemaphoreGive(schedulerActionReady);
+    LoopWake::notify(LoopWake::WAKE_TASK);
+    xSemaphoreTake(schedulerActionDone, portMAX_DELAY);
+    const bool result = schedulerAction.result;
+    xSemaphoreGive(schedulerActionLock);
+    return result;
+}
+
+// Input task side of runSpecialActionOnInputTask
+static void runPendingSchedulerAction()
+{
+    if (xSemaphoreTake(schedulerActionReady, 0) != pdTRUE)
+    {
+        return;
+    }
+    schedulerAction.result = handleSpecialActionRequest(*schedulerAction.actionId, schedulerAction.params,
+                                                        *schedulerAction.message, *schedulerAction.statusCode);
+    xSemaphoreGive(schedulerActionDone);
+}
+
+// Background task side: read the combo file, then wait for the input task to apply it
+static void processComboSwitch()
+{
+    ComboSwitchRequest request;
+    if (xQueueReceive(comboSwitchQueue, &request, 0) != pdTRUE)
+    {
+        return;
+    }
+
+    Logger::getInstance().log("Processing combo switch: " + String(request.prefix) + "_" + String(request.setNumber));
+
+    // Reload combinations from the new file
+    if (!comboManager.reloadCombinations(request.setNumber, request.prefix))
+    {
+        Logger::getInstance().log("Failed to load " + String(request.prefix) + "_" + String(request.setNumber) + ".json");
+        return;
+    }
+
+    xSemaphoreGive(combosLoaded);
+    LoopWake::notify(LoopWake::WAKE_TASK);
+    xSemaphoreTake(combosApplied, portMAX_DELAY);
+
+    if (!comboApplyResult)
+    {
+        Logger::getInstance().log("Failed to reload combinations into macroManager");
+        return;
+    }
+
+    Logger::getInstance().log("Successfully switched to " + String(request.prefix) + "_" + String(request.setNumber));
+}
+
+// Tickless mode: how long the input task may sleep if no interrupt arrives
+static unsigned long nextInputWakeDelayMs()
+{
+    unsigned long delayMs = LOOP_WAKE_MAX_IDLE_MS;
+    delayMs = std::min(delayMs, inputHub.getNextWakeDelayMs(INPUT_TASK_PERIOD_MS));
+    delayMs = std::min(delayMs, macroManager.getNextWakeDelayMs());
+    if (gyroMouse.isRunning() && !gestureSensor.isDataReadyDriven())
+    {
+        delayMs = std::min<unsigned long>(delayMs, INPUT_TASK_PERIOD_MS); // No IMU interrupt: poll
+    }
+    if (macroManager.hasPendingComboSwitch())
+    {
+        delayMs = 0;
+    }
+    return delayMs;
+}
+
 void mainLoopTask(void *parameter)
 {
     // Definisci la frequenza desiderata in tick
-    // Prova con un intervallo iniziale, ad esempio 1ms
-    const TickType_t xFrequency = pdMS_TO_TICKS(5); // 1 ms = 1000 µs
+    const TickType_t xFrequency = pdMS_TO_TICKS(INPUT_TASK_PERIOD_MS);
     TickType_t xLastWakeTime;
 
     // Inizializza xLastWakeTime con il tempo corrente PRIMA di entrare nel loop
@@ -380,7 +579,19 @@ void mainLoopTask(void *parameter)
     const unsigned long logIntervalMillis = 5000; // Logga il massimo ogni 5 secondi
     unsigned long lastLogTime = millis();
 
-    Logger::getInstance().log("mainLoopTask started. Target interval: " + String(pdTICKS_TO_MS(xFrequency)) + " ms. Logging max execution time every " + String(logIntervalMillis) + " ms.");
+    const bool tickless = configManager.getSystemConfig().tickless_loop;
+    LoopWake &loopWake = LoopWake::getInstance();
+    loopWake.begin(xTaskGetCurrentTaskHandle(), tickless);
+    unsigned long lastBleCheck = 0;
+
+    if (tickless)
+    {
+        Logger::getInstance().log("mainLoopTask started in tickless mode. Polling interval when needed: " + String(pdTICKS_TO_MS(xFrequency)) + " ms.");
+    }
+    else
+    {
+        Logger::getInstance().log("mainLoopTask started. Target interval: " + String(pdTICKS_TO_MS(xFrequency)) + " ms. Logging max execution time every " + String(logIntervalMillis) + " ms.");
+    }
 
     for (;;)
     {
@@ -395,89 +606,26 @@ void mainLoopTask(void *parameter)
         {
             macroManager.handleInputEvent(nextEvent);
             powerManager.registerActivity();
-            eventScheduler.handleInputEvent(nextEvent);
+            // The scheduler only matches triggers: a full queue just loses the match
+            xQueueSend(schedulerEventQueue, &nextEvent, 0);
         }
 
-
-        // --- Operazioni potenzialmente più lunghe ---
-        bleController.checkConnection();
-        macroManager.update();          // Assicurati che non blocchi
-        gyroMouse.update();
-        eventScheduler.update();
-        checkIRScanBackground();        // Check per modalità scan IR da web UI
-
-        // Check for pending combo switch request (processed outside of action context to avoid stack issues)
-        if (macroManager.hasPendingComboSwitch())
-        {
-            std::string prefix;
-            int setNumber;
-            macroManager.getPendingComboSwitch(prefix, setNumber);
-            macroManager.clearPendingComboSwitch();
-
-            Logger::getInstance().log("Processing combo switch: " + String(prefix.c_str()) + "_" + String(setNumber));
-
-            // Reload combinations from the new file
-            if (comboManager.reloadCombinations(setNumber, prefix.c_str()))
-            {
-                // Get the new combinations and reload into macroManager
-                JsonObject newCombos = comboManager.getCombinations();
-                if (macroManager.reloadCombinationsFromManager(newCombos))
-                {
-                    Logger::getInstance().log("Successfully switched to " + String(prefix.c_str()) + "_" + String(setNumber) +
-                              " with " + String(macroManager.combinations.size()) + " combinations");
-
-                    // Load interactive lighting colors from combo settings
-                    const ComboSettings& comboSettings = comboManager.getSettings();
-                    inputHub.updateReactiveLightingColors(comboSettings);
-
-                    // Visual feedback and LED color management based on combo settings
-                    if (specialAction.getCurrentLedMode() == SpecialAction::LedMode::NONE)
-                    {
-                        if (comboSettings.hasLedColor())
-                        {
-                            // Mode has custom LED color - show brief flash then set as permanent
-                            // Use setSystemLedColor to apply brightness scaling and maintain brightness control
-                            specialAction.setSystemLedColor(comboSettings.ledR, comboSettings.ledG, comboSettings.ledB, false);
-                            vTaskDelay(pdMS_TO_TICKS(150));
-                            // Set the permanent LED color for this mode and save it
-                            specialAction.setSystemLedColor(comboSettings.ledR, comboSettings.ledG, comboSettings.ledB, true);
-                        }
-                        else
-                        {
-                            // Mode has no custom LED color - keep current LED color (no flash, no change)
-                            // This maintains consistency when switching between modes without LED settings
-                        }
-                    }
-                }
-                else
-                {
-                    Logger::getInstance().log("Failed to reload combinations into macroManager");
-                }
-            }
-            else
-            {
-                Logger::getInstance().log("Failed to load " + String(prefix.c_str()) + "_" + String(setNumber) + ".json");
-            }
-        }
-
-        // Controlla inattività per sleep mode
-        bool inactivityDetected = powerManager.checkInactivity();
-        if (inactivityDetected && eventScheduler.shouldPreventSleep())
+        // Tickless: only the subsystems with work run on each wakeup
+        if (!tickless || millis() - lastBleCheck >= LOOP_WAKE_MAX_IDLE_MS)
         {
-            inactivityDetected = false;
+            bleController.checkConnection();
+            lastBleCheck = millis();
         }
-
-        if (inactivityDetected)
+        macroManager.update();          // Assicurati che non blocchi
+        if (!tickless || gyroMouse.isRunning())
         {
-            Logger::getInstance().log("Inactivity detected, entering sleep mode...");
-            Logger::getInstance().processBuffer(); // Svuota prima di dormire
-            vTaskDelay(pdMS_TO_TICKS(50));         // Dai tempo al logger
-            powerManager.enterDeepSleep();
-            // Non ritorna da deep sleep qui
+            gyroMouse.update();
         }
 
-        // Invio log accumulati (può richiedere tempo se buffer pieno)
-        Logger::getInstance().processBuffer();
+        // Combo switch requested by an action: the file is read in the background task
+        forwardComboSwitch();
+        applyLoadedCombos();
+        runPendingSchedulerAction();
         // ----- FINE del tuo codice del loop -----
     /*
         // --- Fine Misurazione ---
@@ -504,9 +652,85 @@ void mainLoopTask(void *parameter)
            }
      */
 
-        // Attendi fino al prossimo momento di attivazione calcolato
-        // Questo cede il controllo allo scheduler fino al prossimo intervallo
-        vTaskDelayUntil(&xLastWakeTime, xFrequency);
+        if (tickless)
+        {
+            // Dorme fino a un interrupt (tastiera, encoder, IMU), a un altro task o alla prossima scadenza
+            loopWake.wait(nextInputWakeDelayMs());
+        }
+        else
+        {
+            // Attendi fino al prossimo momento di attivazione calcolato
+            // Questo cede il controllo allo scheduler fino al prossimo intervallo
+            loopWake.count(LoopWake::WAKE_TIMER);
+            vTaskDelayUntil(&xLastWakeTime, xFrequency);
+        }
+    }
+}
+
+void backgroundTask(void *parameter)
+{
+    Logger::getInstance().log("backgroundTask started on core " + String(xPortGetCoreID()));
+
+    const bool tickless = configManager.getSystemConfig().tickless_loop;
+
+    for (;;)
+    {
+        // Tickless: stretch the wait up to the next scheduler deadline, unless IR learning blinks the LED
+        uint32_t waitMs = BACKGROUND_TASK_PERIOD_MS;
+        bool schedulerDeadline = false;
+        if (tickless && !isIRScanActive())
+        {
+            waitMs = BACKGROUND_TASK_IDLE_MS;
+            uint64_t schedulerUs = eventScheduler.getNextWakeDelayUs();
+            if (schedulerUs > 0 && schedulerUs / 1000 < waitMs)
+            {
+                waitMs = schedulerUs / 1000;
+                schedulerDeadline = true;
+            }
+        }
+
+        // Sleeps here until an input event arrives or the wait expires
+        InputEvent event;
+        if (xQueueReceive(schedulerEventQueue, &event, pdMS_TO_TICKS(waitMs)) != pdTRUE)
+        {
+            if (schedulerDeadline)
+            {
+                LoopWake::getInstance().count(LoopWake::WAKE_SCHEDULER);
+            }
+        }
+        else
+        {
+            do
+            {
+                eventScheduler.handleInputEvent(event);
+            } while (xQueueReceive(schedulerEventQueue, &event, 0) == pdTRUE);
+        }
+
+        eventScheduler.update();
+        checkIRScanBackground();        // Check per modalità scan IR da web UI
+        processComboSwitch();
+        InputTrace::getInstance().service(); // Scrittura/caricamento trace input su LittleFS
+        GestureDataset::getInstance().service(); // Scrittura catture gesture etichettate
+        GyroBiasModel::getInstance().service(); // Salvataggio modello bias giroscopio
+
+        // Controlla inattività per sleep mode
+        bool inactivityDetected = powerManager.checkInactivity();
+        if (inactivityDetected && eventScheduler.shouldPreventSleep())
+        {
+            inactivityDetected = false;
+        }
+
+        if (inactivityDetected)
+        {
+            Logger::getInstance().log("Inactivity detected, entering sleep mode...");
+            Logger::getInstance().processBuffer(); // Svuota prima di dormire
+            vTaskDelay(pdMS_TO_TICKS(50));         // Dai tempo al logger
+            powerManager.enterDeepSleep();
+            // Non ritorna da deep sleep qui
+        }
+
+        // Invio log accumulati (può richiedere tempo se buffer pieno)
+        Logger::getInstance().processBuffer();
     }
 }
 
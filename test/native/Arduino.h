@@ -0,0 +1,236 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Host replacement for the Arduino core, used by the native test env.
+ * Only what the libraries under test need: String, a controllable
+ * millis() clock and a silent Serial.
+ */
+
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <algorithm>
+#include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "freertos/FreeRTOS.h"
+
+typedef uint8_t byte;
+typedef int gpio_num_t;
+
+#define HEX 16
+#define DEC 10
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define INPUT_PULLDOWN 3
+#define RISING 1
+#define FALLING 2
+#define CHANGE 3
+#define IRAM_ATTR
+#define DRAM_ATTR
+
+#ifndef PI
+    #define PI 3.1415926535897932384626433832795
+#endif
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+class String : public std::string
+{
+public:
+    String() {}
+    String(const char *text) : std::string(text ? text : "") {}
+    String(const std::string &text) : std::string(text) {}
+    explicit String(char c) : std::string(1, c) {}
+    String(int value, int base = DEC) { assign(formatInteger(value, base)); }
+    String(unsigned int value, int base = DEC) { assign(formatInteger(value, base)); }
+    String(long value, int base = DEC) { assign(formatInteger(value, base)); }
+    String(unsigned long value, int base = DEC) { assign(formatInteger(value, base)); }
+    String(long long value) { assign(std::to_string(value)); }
+    String(unsigned long long value) { assign(std::to_string(value)); }
+    String(float value, int decimals = 2) { assign(formatFloat(value, decimals)); }
+    String(double value, int decimals = 2) { assign(formatFloat(value, decimals)); }
+
+    unsigned int length() const { return static_cast<unsigned int>(size()); }
+    bool isEmpty() const { return empty(); }
+    char charAt(unsigned int index) const { return index < size() ? (*this)[index] : 0; }
+
+    bool equals(const String &other) const { return *this == other; }
+    bool equalsIgnoreCase(const String &other) const
+    {
+        return size() == other.size() &&
+               std::equal(begin(), end(), other.begin(), [](char a, char b) { return tolower(a) == tolower(b); });
+    }
+    bool startsWith(const String &prefix) const { return compare(0, prefix.size(), prefix) == 0; }
+    bool endsWith(const String &suffix) const
+    {
+        return size() >= suffix.size() && compare(size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    int indexOf(char c, unsigned int from = 0) const { return toIndex(find(c, from)); }
+    int indexOf(const String &text, unsigned int from = 0) const { return toIndex(find(text, from)); }
+    int lastIndexOf(char c) const { return toIndex(rfind(c)); }
+
+    String substring(unsigned int from) const { return from < size() ? String(substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const
+    {
+        return from < size() && to > from ? String(substr(from, to - from)) : String();
+    }
+
+    void trim()
+    {
+        size_t first = find_first_not_of(" \t\r\n");
+        if (first == npos)
+        {
+            clear();
+            return;
+        }
+        assign(substr(first, find_last_not_of(" \t\r\n") - first + 1));
+    }
+    void replace(const String &from, const String &to)
+    {
+        if (from.empty())
+        {
+            return;
+        }
+        for (size_t pos = find(from); pos != npos; pos = find(from, pos + to.size()))
+        {
+            std::string::replace(pos, from.size(), to);
+        }
+    }
+    void toLowerCase() { std::transform(begin(), end(), begin(), ::tolower); }
+    void toUpperCase() { std::transform(begin(), end(), begin(), ::toupper); }
+
+    long toInt() const { return atol(c_str()); }
+    float toFloat() const { return static_cast<float>(atof(c_str())); }
+
+    String &operator+=(const String &other)
+    {
+        append(other);
+        return *this;
+    }
+    String &operator+=(const char *other)
+    {
+        append(other ? other : "");
+        return *this;
+    }
+    String &operator+=(char c)
+    {
+        push_back(c);
+        return *this;
+    }
+    String &operator+=(int value)
+    {
+        append(std::to_string(value));
+        return *this;
+    }
+
+private:
+    static int toIndex(size_t pos) { return pos == npos ? -1 : static_cast<int>(pos); }
+
+    template <typename T>
+    static std::string formatInteger(T value, int base)
+    {
+        if (base != HEX)
+        {
+            return std::to_string(value);
+        }
+        char buffer[20];
+        snprintf(buffer, sizeof(buffer), "%llx", static_cast<unsigned long long>(value));
+        return buffer;
+    }
+
+    static std::string formatFloat(double value, int decimals)
+    {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+        return buffer;
+    }
+};
+
+inline String operator+(const String &a, const String &b)
+{
+    String result(a);
+    result += b;
+    return result;
+}
+inline String operator+(const String &a, const char *b) { return a + String(b); }
+inline String operator+(const char *a, const String &b) { return String(a) + b; }
+inline String operator+(const String &a, char b) { return a + String(b); }
+inline String operator+(const String &a, int b) { return a + String(b); }
+inline String operator+(const String &a, unsigned long b) { return a + String(b); }
+
+// Simulated time: tests move it forward explicitly
+namespace native
+{
+    inline unsigned long clockMs = 0;
+
+    inline void advanceMs(unsigned long ms) { clockMs += ms; }
+}
+
+inline unsigned long millis() { return native::clockMs; }
+inline unsigned long micros() { return native::clockMs * 1000UL; }
+inline void delay(unsigned long ms) { native::advanceMs(ms); }
+inline void delayMicroseconds(unsigned int) {}
+inline void yield() {}
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return HIGH; }
+inline void analogWrite(uint8_t, int) {}
+inline uint32_t esp_random() { return static_cast<uint32_t>(rand()); }
+
+template <typename T, typename L, typename H>
+inline T constrain(T value, L low, H high)
+{
+    return value < low ? low : (value > high ? high : value);
+}
+
+inline size_t strlcpy(char *dest, const char *src, size_t size)
+{
+    size_t length = strlen(src);
+    if (size > 0)
+    {
+        size_t copied = std::min(length, size - 1);
+        memcpy(dest, src, copied);
+        dest[copied] = '\0';
+    }
+    return length;
+}
+
+// Output is dropped: tests assert on state, not on logs
+class HardwareSerial
+{
+public:
+    void begin(unsigned long) {}
+    explicit operator bool() const { return true; }
+    template <typename T>
+    size_t print(const T &) { return 0; }
+    template <typename T>
+    size_t println(const T &) { return 0; }
+    size_t println() { return 0; }
+    void flush() {}
+};
+
+inline HardwareSerial Serial;
+
+class EspClass
+{
+public:
+    uint32_t getFreeHeap() { return 0; }
+    uint32_t getMinFreeHeap() { return 0; }
+    uint32_t getMaxAllocHeap() { return 0; }
+    void restart() {}
+};
+
+inline EspClass ESP;
+
+#endif // NATIVE_ARDUINO_H
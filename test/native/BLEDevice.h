@@ -0,0 +1 @@
+// BLEController only includes it; the native BleCombo.h stands in for the stack
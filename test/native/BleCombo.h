@@ -0,0 +1,275 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Host replacement for ESP32-BLE-Combo. Instead of notifying a BLE host,
+ * every report the library would send is appended to native::hidReports
+ * as text, so tests can compare what reached the "host":
+ *
+ *   K mm k1 k2 k3 k4 k5 k6   keyboard: modifier bits, six key codes (hex)
+ *   C b0 b1                  consumer (media) key bitmap
+ *   M bb x y wheel hWheel    mouse: buttons, then signed deltas
+ *
+ * Key codes below 0x80 are kept as ASCII instead of being translated to
+ * HID usages; the tests only compare reports with each other.
+ */
+
+#ifndef NATIVE_BLE_COMBO_H
+#define NATIVE_BLE_COMBO_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include <string>
+#include <vector>
+
+typedef uint8_t MediaKeyReport[2];
+
+const uint8_t KEY_LEFT_CTRL = 0x80;
+const uint8_t KEY_LEFT_SHIFT = 0x81;
+const uint8_t KEY_LEFT_ALT = 0x82;
+const uint8_t KEY_LEFT_GUI = 0x83;
+const uint8_t KEY_RIGHT_CTRL = 0x84;
+const uint8_t KEY_RIGHT_SHIFT = 0x85;
+const uint8_t KEY_RIGHT_ALT = 0x86;
+const uint8_t KEY_RIGHT_GUI = 0x87;
+
+const uint8_t KEY_UP_ARROW = 0xDA;
+const uint8_t KEY_DOWN_ARROW = 0xD9;
+const uint8_t KEY_LEFT_ARROW = 0xD8;
+const uint8_t KEY_RIGHT_ARROW = 0xD7;
+const uint8_t KEY_BACKSPACE = 0xB2;
+const uint8_t KEY_TAB = 0xB3;
+const uint8_t KEY_RETURN = 0xB0;
+const uint8_t KEY_ESC = 0xB1;
+const uint8_t KEY_INSERT = 0xD1;
+const uint8_t KEY_DELETE = 0xD4;
+const uint8_t KEY_PAGE_UP = 0xD3;
+const uint8_t KEY_PAGE_DOWN = 0xD6;
+const uint8_t KEY_HOME = 0xD2;
+const uint8_t KEY_END = 0xD5;
+const uint8_t KEY_CAPS_LOCK = 0xC1;
+const uint8_t KEY_F1 = 0xC2;
+const uint8_t KEY_F2 = 0xC3;
+const uint8_t KEY_F3 = 0xC4;
+const uint8_t KEY_F4 = 0xC5;
+const uint8_t KEY_F5 = 0xC6;
+const uint8_t KEY_F6 = 0xC7;
+const uint8_t KEY_F7 = 0xC8;
+const uint8_t KEY_F8 = 0xC9;
+const uint8_t KEY_F9 = 0xCA;
+const uint8_t KEY_F10 = 0xCB;
+const uint8_t KEY_F11 = 0xCC;
+const uint8_t KEY_F12 = 0xCD;
+const uint8_t KEY_F13 = 0xF0;
+const uint8_t KEY_F14 = 0xF1;
+const uint8_t KEY_F15 = 0xF2;
+const uint8_t KEY_F16 = 0xF3;
+const uint8_t KEY_F17 = 0xF4;
+const uint8_t KEY_F18 = 0xF5;
+const uint8_t KEY_F19 = 0xF6;
+const uint8_t KEY_F20 = 0xF7;
+const uint8_t KEY_F21 = 0xF8;
+const uint8_t KEY_F22 = 0xF9;
+const uint8_t KEY_F23 = 0xFA;
+const uint8_t KEY_F24 = 0xFB;
+
+const MediaKeyReport KEY_MEDIA_NEXT_TRACK = {1, 0};
+const MediaKeyReport KEY_MEDIA_PREVIOUS_TRACK = {2, 0};
+const MediaKeyReport KEY_MEDIA_STOP = {4, 0};
+const MediaKeyReport KEY_MEDIA_PLAY_PAUSE = {8, 0};
+const MediaKeyReport KEY_MEDIA_MUTE = {16, 0};
+const MediaKeyReport KEY_MEDIA_VOLUME_UP = {32, 0};
+const MediaKeyReport KEY_MEDIA_VOLUME_DOWN = {64, 0};
+const MediaKeyReport KEY_MEDIA_WWW_HOME = {128, 0};
+const MediaKeyReport KEY_MEDIA_LOCAL_MACHINE_BROWSER = {0, 1};
+const MediaKeyReport KEY_MEDIA_CALCULATOR = {0, 2};
+const MediaKeyReport KEY_MEDIA_WWW_BOOKMARKS = {0, 4};
+const MediaKeyReport KEY_MEDIA_WWW_SEARCH = {0, 8};
+const MediaKeyReport KEY_MEDIA_WWW_STOP = {0, 16};
+const MediaKeyReport KEY_MEDIA_WWW_BACK = {0, 32};
+const MediaKeyReport KEY_MEDIA_CONSUMER_CONTROL_CONFIGURATION = {0, 64};
+const MediaKeyReport KEY_MEDIA_EMAIL_READER = {0, 128};
+
+#define MOUSE_LEFT 1
+#define MOUSE_RIGHT 2
+#define MOUSE_MIDDLE 4
+#define MOUSE_BACK 8
+#define MOUSE_FORWARD 16
+
+namespace native
+{
+    inline std::vector<std::string> hidReports;
+    inline size_t hidReportCount = 0;
+    inline bool keepHidReports = true; // false: only count them (no allocation per report)
+    inline bool bleConnected = true;
+
+    inline void sendReport(const char *format, ...) __attribute__((format(printf, 1, 2)));
+    inline void sendReport(const char *format, ...)
+    {
+        hidReportCount++;
+        if (!keepHidReports)
+        {
+            return;
+        }
+        char report[64];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(report, sizeof(report), format, args);
+        va_end(args);
+        hidReports.push_back(report);
+    }
+}
+
+class BleComboKeyboard
+{
+public:
+    std::string deviceName = "MacroPad";
+
+    void begin() {}
+    void end() {}
+    bool isConnected() { return native::bleConnected; }
+
+    size_t press(uint8_t k)
+    {
+        if (k >= 0x80 && k < 0x88)
+        {
+            _modifiers |= 1 << (k - 0x80);
+        }
+        else if (!hasKey(k))
+        {
+            for (uint8_t &slot : _keys)
+            {
+                if (slot == 0)
+                {
+                    slot = k;
+                    break;
+                }
+            }
+        }
+        sendKeys();
+        return 1;
+    }
+
+    size_t release(uint8_t k)
+    {
+        if (k >= 0x80 && k < 0x88)
+        {
+            _modifiers &= ~(1 << (k - 0x80));
+        }
+        else
+        {
+            for (uint8_t &slot : _keys)
+            {
+                if (slot == k)
+                {
+                    slot = 0;
+                }
+            }
+        }
+        sendKeys();
+        return 1;
+    }
+
+    size_t press(const MediaKeyReport k)
+    {
+        _media[0] |= k[0];
+        _media[1] |= k[1];
+        sendMedia();
+        return 1;
+    }
+
+    size_t release(const MediaKeyReport k)
+    {
+        _media[0] &= ~k[0];
+        _media[1] &= ~k[1];
+        sendMedia();
+        return 1;
+    }
+
+    void releaseAll()
+    {
+        _modifiers = 0;
+        memset(_keys, 0, sizeof(_keys));
+        _media[0] = _media[1] = 0;
+        sendKeys();
+    }
+
+    size_t write(uint8_t c)
+    {
+        press(c);
+        release(c);
+        return 1;
+    }
+
+    size_t write(const uint8_t *buffer, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            write(buffer[i]);
+        }
+        return size;
+    }
+
+    size_t print(const String &text) { return write(reinterpret_cast<const uint8_t *>(text.c_str()), text.length()); }
+
+private:
+    bool hasKey(uint8_t k) const
+    {
+        for (uint8_t slot : _keys)
+        {
+            if (slot == k)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void sendKeys()
+    {
+        native::sendReport("K %02x %02x %02x %02x %02x %02x %02x", _modifiers, _keys[0], _keys[1], _keys[2],
+                           _keys[3], _keys[4], _keys[5]);
+    }
+
+    void sendMedia() { native::sendReport("C %02x %02x", _media[0], _media[1]); }
+
+    uint8_t _modifiers = 0;
+    uint8_t _keys[6] = {0, 0, 0, 0, 0, 0};
+    uint8_t _media[2] = {0, 0};
+};
+
+class BleComboMouse
+{
+public:
+    void begin() {}
+    void end() {}
+
+    void move(signed char x, signed char y, signed char wheel = 0, signed char hWheel = 0)
+    {
+        native::sendReport("M %02x %d %d %d %d", _buttons, x, y, wheel, hWheel);
+    }
+    void press(uint8_t b = MOUSE_LEFT) { setButtons(_buttons | b); }
+    void release(uint8_t b = MOUSE_LEFT) { setButtons(_buttons & ~b); }
+    void click(uint8_t b = MOUSE_LEFT)
+    {
+        press(b);
+        release(b);
+    }
+    bool isPressed(uint8_t b = MOUSE_LEFT) const { return (_buttons & b) != 0; }
+
+private:
+    void setButtons(uint8_t buttons)
+    {
+        if (buttons != _buttons)
+        {
+            _buttons = buttons;
+            move(0, 0, 0, 0);
+        }
+    }
+
+    uint8_t _buttons = 0;
+};
+
+inline BleComboKeyboard Keyboard;
+inline BleComboMouse Mouse;
+
+#endif // NATIVE_BLE_COMBO_H
@@ -0,0 +1 @@
+#include "BleCombo.h"
@@ -0,0 +1,10 @@
+#ifndef NATIVE_DNS_SERVER_H
+#define NATIVE_DNS_SERVER_H
+
+#include <Arduino.h>
+
+class DNSServer
+{
+};
+
+#endif // NATIVE_DNS_SERVER_H
@@ -0,0 +1,12 @@
+#ifndef NATIVE_ESP_ASYNC_WEB_SERVER_H
+#define NATIVE_ESP_ASYNC_WEB_SERVER_H
+
+#include <Arduino.h>
+
+class AsyncWebServer
+{
+public:
+    explicit AsyncWebServer(uint16_t port) {}
+};
+
+#endif // NATIVE_ESP_ASYNC_WEB_SERVER_H
@@ -0,0 +1,164 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * In-memory replacement for the Arduino FS API. Files live in a map owned
+ * by the FS object, so a test can write a file through the code under
+ * test and read it back (or seed one) without touching the host disk.
+ */
+
+#ifndef NATIVE_FS_H
+#define NATIVE_FS_H
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs
+{
+    typedef std::vector<uint8_t> FileData;
+
+    class File
+    {
+    public:
+        File() {}
+        File(const std::string &path, std::shared_ptr<FileData> data, bool writable, size_t position)
+            : _path(path), _data(data), _writable(writable), _position(position) {}
+
+        explicit operator bool() const { return _data != nullptr; }
+
+        size_t size() const { return _data ? _data->size() : 0; }
+        size_t position() const { return _position; }
+        int available() const { return _data ? static_cast<int>(_data->size() - _position) : 0; }
+        bool seek(uint32_t position)
+        {
+            if (!_data || position > _data->size())
+            {
+                return false;
+            }
+            _position = position;
+            return true;
+        }
+
+        size_t read(uint8_t *buffer, size_t length)
+        {
+            size_t count = std::min<size_t>(length, available());
+            if (count > 0)
+            {
+                memcpy(buffer, _data->data() + _position, count);
+                _position += count;
+            }
+            return count;
+        }
+        int read()
+        {
+            uint8_t value;
+            return read(&value, 1) == 1 ? value : -1;
+        }
+        String readString()
+        {
+            String text;
+            while (available() > 0)
+            {
+                text += static_cast<char>(read());
+            }
+            return text;
+        }
+
+        size_t write(const uint8_t *buffer, size_t length)
+        {
+            if (!_data || !_writable)
+            {
+                return 0;
+            }
+            if (_position + length > _data->size())
+            {
+                _data->resize(_position + length);
+            }
+            memcpy(_data->data() + _position, buffer, length);
+            _position += length;
+            return length;
+        }
+        size_t write(uint8_t value) { return write(&value, 1); }
+        size_t print(const String &text) { return write(reinterpret_cast<const uint8_t *>(text.c_str()), text.length()); }
+        size_t println(const String &text) { return print(text) + write('\n'); }
+
+        void flush() {}
+        void close() { _data.reset(); }
+
+        const char *path() const { return _path.c_str(); }
+        const char *name() const
+        {
+            size_t slash = _path.rfind('/');
+            return slash == std::string::npos ? _path.c_str() : _path.c_str() + slash + 1;
+        }
+        bool isDirectory() const { return false; }
+        File openNextFile() { return File(); }
+
+    private:
+        std::string _path;
+        std::shared_ptr<FileData> _data;
+        bool _writable = false;
+        size_t _position = 0;
+    };
+
+    class FS
+    {
+    public:
+        File open(const char *path, const char *mode = FILE_READ, bool create = false)
+        {
+            auto it = _files.find(path);
+            if (mode[0] == 'r')
+            {
+                return it == _files.end() ? File() : File(path, it->second, false, 0);
+            }
+            if (mode[0] == 'w' || it == _files.end())
+            {
+                _files[path] = std::make_shared<FileData>();
+            }
+            std::shared_ptr<FileData> &data = _files[path];
+            return File(path, data, true, mode[0] == 'a' ? data->size() : 0);
+        }
+        File open(const String &path, const char *mode = FILE_READ, bool create = false)
+        {
+            return open(path.c_str(), mode, create);
+        }
+
+        bool exists(const char *path) const { return _files.count(path) != 0; }
+        bool exists(const String &path) const { return exists(path.c_str()); }
+        bool remove(const char *path) { return _files.erase(path) != 0; }
+        bool remove(const String &path) { return remove(path.c_str()); }
+        bool rename(const char *from, const char *to)
+        {
+            auto it = _files.find(from);
+            if (it == _files.end())
+            {
+                return false;
+            }
+            _files[to] = it->second;
+            _files.erase(from);
+            return true;
+        }
+        bool mkdir(const char *) { return true; }
+
+        // Test helpers
+        void format() { _files.clear(); }
+        const FileData *contents(const char *path) const
+        {
+            auto it = _files.find(path);
+            return it == _files.end() ? nullptr : it->second.get();
+        }
+
+    private:
+        std::map<std::string, std::shared_ptr<FileData>> _files;
+    };
+}
+
+using fs::File;
+using fs::FS;
+
+#endif // NATIVE_FS_H
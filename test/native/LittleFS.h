@@ -0,0 +1,16 @@
+#ifndef NATIVE_LITTLEFS_H
+#define NATIVE_LITTLEFS_H
+
+#include "FS.h"
+
+class LittleFSFS : public fs::FS
+{
+public:
+    bool begin(bool formatOnFail = false) { return true; }
+    size_t totalBytes() const { return 1024 * 1024; }
+    size_t usedBytes() const { return 0; }
+};
+
+inline LittleFSFS LittleFS;
+
+#endif // NATIVE_LITTLEFS_H
@@ -0,0 +1,7 @@
+#ifndef NATIVE_WIFI_H
+#define NATIVE_WIFI_H
+
+// Headers of the web/WiFi modules are parsed by the tests, never linked
+#include <Arduino.h>
+
+#endif // NATIVE_WIFI_H
@@ -0,0 +1,23 @@
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+#include <Arduino.h>
+
+// The IMU drivers are not exercised on the host: the bus reads nothing
+class TwoWire
+{
+public:
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) { return true; }
+    void setClock(uint32_t) {}
+    void beginTransmission(uint8_t) {}
+    uint8_t endTransmission(bool stop = true) { return 0; }
+    size_t write(uint8_t) { return 1; }
+    size_t write(const uint8_t *, size_t length) { return length; }
+    uint8_t requestFrom(uint8_t, uint8_t, uint8_t stop = 1) { return 0; }
+    int available() { return 0; }
+    int read() { return -1; }
+};
+
+inline TwoWire Wire;
+
+#endif // NATIVE_WIRE_H
@@ -0,0 +1,21 @@
+#ifndef NATIVE_ESP_SYSTEM_H
+#define NATIVE_ESP_SYSTEM_H
+
+#include <stdint.h>
+#include <string.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+
+inline esp_err_t esp_efuse_mac_get_default(uint8_t *mac)
+{
+    const uint8_t factory[6] = {0x24, 0x0A, 0xC4, 0x00, 0x00, 0x01};
+    memcpy(mac, factory, sizeof(factory));
+    return ESP_OK;
+}
+
+inline esp_err_t esp_base_mac_addr_set(const uint8_t *) { return ESP_OK; }
+
+#endif // NATIVE_ESP_SYSTEM_H
@@ -0,0 +1,8 @@
+#ifndef NATIVE_ESP_TIMER_H
+#define NATIVE_ESP_TIMER_H
+
+#include <Arduino.h>
+
+inline int64_t esp_timer_get_time() { return static_cast<int64_t>(micros()); }
+
+#endif // NATIVE_ESP_TIMER_H
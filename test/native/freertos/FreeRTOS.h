@@ -0,0 +1,82 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Host replacement for the FreeRTOS types and calls the libraries use.
+ * Tests run single threaded: notifications are recorded, never awaited.
+ */
+
+#ifndef NATIVE_FREERTOS_H
+#define NATIVE_FREERTOS_H
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void *TaskHandle_t;
+typedef void *SemaphoreHandle_t;
+typedef void *QueueHandle_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) (ms)
+#define tskIDLE_PRIORITY 0
+#define tskNO_AFFINITY -1
+
+typedef struct
+{
+    int owner;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+#define portYIELD_FROM_ISR(...)
+
+enum eNotifyAction
+{
+    eNoAction,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite
+};
+
+namespace native
+{
+    inline uint32_t notifiedBits = 0; // Bits sent to the input task since the last wait
+}
+
+inline BaseType_t xTaskNotify(TaskHandle_t, uint32_t value, eNotifyAction)
+{
+    native::notifiedBits |= value;
+    return pdPASS;
+}
+
+inline BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t *woken)
+{
+    if (woken)
+    {
+        *woken = pdFALSE;
+    }
+    return xTaskNotify(task, value, action);
+}
+
+inline BaseType_t xTaskNotifyWait(uint32_t, uint32_t, uint32_t *value, TickType_t)
+{
+    if (value)
+    {
+        *value = native::notifiedBits;
+    }
+    native::notifiedBits = 0;
+    return pdPASS;
+}
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle() { return nullptr; }
+inline void vTaskDelay(TickType_t) {}
+
+#endif // NATIVE_FREERTOS_H
@@ -0,0 +1,6 @@
+#ifndef NATIVE_FREERTOS_PORTMACRO_H
+#define NATIVE_FREERTOS_PORTMACRO_H
+
+#include "FreeRTOS.h"
+
+#endif // NATIVE_FREERTOS_PORTMACRO_H
@@ -0,0 +1,2 @@
+// Production sources exercised by this suite (the native env builds no lib/ folder)
+#include "../../lib/macroManager/ComboIndex.cpp"
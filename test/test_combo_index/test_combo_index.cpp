@@ -0,0 +1,202 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * ComboIndex lookups against the string lookup they replaced: the
+ * combination string built from the pressed keys and searched in the
+ * std::map, as MacroManager did before the index (getCurrentCombination,
+ * key index order). Both must resolve every query to the same entry;
+ * the time per lookup of each is printed (pio test -e native -v).
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "ComboIndex.h"
+
+namespace
+{
+    const size_t kQueries = 1024;
+    const size_t kRounds = 200;
+
+    struct Query
+    {
+        uint16_t mask;
+        uint8_t trigger;
+        const char *action; // lastAction of the string lookup ("" = none)
+    };
+
+    KeypadConfig keypadConfig;
+    std::map<std::string, std::vector<std::string>> combinations;
+    ComboIndex comboIndex;
+    std::vector<Query> queries;
+
+    // 4x4 pad: every key, every key with the encoder, horizontal pairs, tap-dance and gestures
+    void buildCombinations()
+    {
+        keypadConfig.rows = 4;
+        keypadConfig.cols = 4;
+        keypadConfig.keys = {{'1', '2', '3', 'A'}, {'4', '5', '6', 'B'}, {'7', '8', '9', 'C'}, {'*', '0', '#', 'D'}};
+
+        const std::vector<std::string> action = {"S_B:a"};
+        for (uint8_t row = 0; row < 4; row++)
+        {
+            for (uint8_t col = 0; col < 4; col++)
+            {
+                const std::string key(1, keypadConfig.keys[row][col]);
+                combinations[key] = action;
+                combinations[key + ",CW"] = action;
+                combinations[key + ",CCW"] = action;
+                if (col < 3)
+                {
+                    combinations[key + "+" + keypadConfig.keys[row][col + 1]] = action;
+                }
+            }
+        }
+        combinations["1+2,CW"] = action;
+        combinations["1:HOLD"] = action;
+        combinations["2:DTAP"] = action;
+        combinations["BUTTON"] = action;
+        combinations["1,BUTTON"] = action;
+        combinations["CW"] = action;
+        combinations["CCW"] = action;
+        combinations["G_SWIPE_RIGHT"] = action;
+        combinations["G_SHAKE"] = action;
+        comboIndex.build(combinations, keypadConfig);
+    }
+
+    // One or two keys held, or none with a trigger, as on the key/encoder event path
+    void buildQueries()
+    {
+        static const uint8_t triggers[] = {ComboIndex::TRIGGER_NONE, ComboIndex::TRIGGER_CW, ComboIndex::TRIGGER_CCW,
+                                           ComboIndex::TRIGGER_BUTTON};
+        static const char *const actions[] = {"", "CW", "CCW", "BUTTON"};
+        std::mt19937 random(1);
+        std::uniform_int_distribution<int> keyCount(0, 2);
+        std::uniform_int_distribution<int> key(0, 15);
+        std::uniform_int_distribution<int> trigger(0, 3);
+
+        while (queries.size() < kQueries)
+        {
+            uint16_t mask = 0;
+            for (int n = keyCount(random); n > 0; n--)
+            {
+                mask |= 1 << key(random);
+            }
+            const int t = mask == 0 ? 1 + trigger(random) % 3 : trigger(random);
+            queries.push_back({mask, triggers[t], actions[t]});
+        }
+    }
+
+    // Baseline MacroManager::getCurrentCombination (index order), then the map search
+    const std::vector<std::string> *stringLookup(const Query &query)
+    {
+        char buffer[64];
+        char *ptr = buffer;
+        bool first = true;
+
+        uint8_t totalKeys = keypadConfig.rows * keypadConfig.cols;
+        for (uint8_t key = 0; key < totalKeys; key++)
+        {
+            if (query.mask & (1 << key))
+            {
+                if (!first)
+                {
+                    *ptr++ = '+';
+                }
+                uint8_t row = key / keypadConfig.cols;
+                uint8_t col = key % keypadConfig.cols;
+                char keyLabel = keypadConfig.keys[row][col];
+                if (keyLabel != '\0')
+                {
+                    *ptr++ = keyLabel;
+                }
+                first = false;
+            }
+        }
+
+        if (query.action[0] != '\0')
+        {
+            if (!first)
+            {
+                *ptr++ = ',';
+            }
+            const char *actionPtr = query.action;
+            while (*actionPtr)
+            {
+                *ptr++ = *actionPtr++;
+            }
+        }
+        *ptr = '\0';
+
+        auto it = combinations.find(std::string(buffer));
+        return it != combinations.end() ? &it->second : nullptr;
+    }
+
+    // MacroManager::getCurrentCombination now, then the index
+    const std::vector<std::string> *indexLookup(const Query &query)
+    {
+        ComboIndex::Key key = {query.mask, query.trigger, ComboIndex::orderFromMask(query.mask)};
+        const ComboIndex::Entry *entry = comboIndex.find(key);
+        return entry ? entry->actions : nullptr;
+    }
+
+    template <typename Lookup>
+    double nanosecondsPerLookup(Lookup lookup, size_t &hits)
+    {
+        hits = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < kRounds; round++)
+        {
+            for (const Query &query : queries)
+            {
+                hits += lookup(query) != nullptr ? 1 : 0;
+            }
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / (kRounds * queries.size());
+    }
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_index_matches_string_lookup(void)
+{
+    size_t hits = 0;
+    for (const Query &query : queries)
+    {
+        const std::vector<std::string> *expected = stringLookup(query);
+        TEST_ASSERT_EQUAL_PTR(expected, indexLookup(query));
+        hits += expected ? 1 : 0;
+    }
+    TEST_ASSERT_TRUE(hits > kQueries / 4); // The mix exercises hits as well as misses
+}
+
+void test_lookup_time(void)
+{
+    size_t stringHits = 0;
+    size_t indexHits = 0;
+    const double stringNs = nanosecondsPerLookup(stringLookup, stringHits);
+    const double indexNs = nanosecondsPerLookup(indexLookup, indexHits);
+
+    printf("\n%u combos, %u queries x %u rounds\n", static_cast<unsigned>(combinations.size()),
+           static_cast<unsigned>(queries.size()), static_cast<unsigned>(kRounds));
+    printf("std::map + string  %8.1f ns/lookup\n", stringNs);
+    printf("ComboIndex         %8.1f ns/lookup (%.1fx)\n", indexNs, stringNs / indexNs);
+    TEST_ASSERT_EQUAL_size_t(stringHits, indexHits);
+}
+
+int main(int argc, char **argv)
+{
+    buildCombinations();
+    buildQueries();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_index_matches_string_lookup);
+    RUN_TEST(test_lookup_time);
+    return UNITY_END();
+}
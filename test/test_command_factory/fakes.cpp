@@ -0,0 +1,68 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Link seams for the command factory suite: the commands built on
+ * hardware services exist but do nothing, so the real dispatch tables
+ * link without the devices behind them.
+ */
+
+#include "CommandFactory.h"
+#include "ApModeCommand.h"
+#include "ExecuteGestureCommand.h"
+#include "FlashlightCommand.h"
+#include "GestureDatasetCommand.h"
+#include "GestureTemplateCommand.h"
+#include "GyroMouseCycleSensitivityCommand.h"
+#include "GyroMouseRecenterCommand.h"
+#include "GyroMouseStartCommand.h"
+#include "GyroMouseStopCommand.h"
+#include "GyroMouseToggleCommand.h"
+#include "LedBrightnessCommand.h"
+#include "LedCommand.h"
+#include "SaveInteractiveColorsCommand.h"
+#include "ScanIrDevCommand.h"
+#include "SendIrCommand.h"
+#include "SwitchComboCommand.h"
+#include "ToggleBleWifiCommand.h"
+#include "ToggleKeyOrderCommand.h"
+#include "ToggleReactiveLightingCommand.h"
+#include "macroManager.h"
+#include "specialAction.h"
+
+#define FAKE_COMMAND(Class, ...) \
+    Class::Class(__VA_ARGS__) {}  \
+    void Class::press() {}        \
+    void Class::release() {}
+
+FAKE_COMMAND(ApModeCommand, WIFIManager *, BLEController *, const WifiConfig *)
+FAKE_COMMAND(ExecuteGestureCommand, InputHub *, MacroManager *)
+FAKE_COMMAND(FlashlightCommand, SpecialAction *)
+FAKE_COMMAND(GestureDatasetCommand, InputHub *, MacroManager *, Mode, const String &)
+FAKE_COMMAND(GestureTemplateCommand, InputHub *, MacroManager *, Mode, int)
+FAKE_COMMAND(GyroMouseCycleSensitivityCommand, GyroMouse *)
+FAKE_COMMAND(GyroMouseRecenterCommand, GyroMouse *)
+FAKE_COMMAND(GyroMouseStartCommand, GyroMouse *, MacroManager *)
+FAKE_COMMAND(GyroMouseStopCommand, GyroMouse *, MacroManager *)
+FAKE_COMMAND(GyroMouseToggleCommand, GyroMouse *, MacroManager *)
+FAKE_COMMAND(LedBrightnessCommand, SpecialAction *, const std::string &)
+FAKE_COMMAND(LedCommand, SpecialAction *, const std::string &)
+FAKE_COMMAND(SaveInteractiveColorsCommand, InputHub *)
+FAKE_COMMAND(ScanIrDevCommand, SpecialAction *, MacroManager *, int)
+FAKE_COMMAND(SendIrCommand, SpecialAction *, MacroManager *, const std::string &)
+FAKE_COMMAND(SwitchComboCommand, MacroManager *, const std::string &)
+FAKE_COMMAND(ToggleBleWifiCommand, SpecialAction *)
+FAKE_COMMAND(ToggleKeyOrderCommand, MacroManager *)
+FAKE_COMMAND(ToggleReactiveLightingCommand, InputHub *)
+
+// Called by the header-only commands
+void SpecialAction::calibrateSensor() {}
+void SpecialAction::checkIRSignal() {}
+void SpecialAction::enterSleep() {}
+void SpecialAction::hopBleDevice() {}
+void SpecialAction::printMemoryInfo() {}
+void SpecialAction::resetDevice() {}
+
+const WifiConfig *MacroManager::getWifiConfig() const
+{
+    return nullptr;
+}
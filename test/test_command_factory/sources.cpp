@@ -0,0 +1,9 @@
+// Production sources exercised by this suite (the native env builds no lib/ folder)
+#include "../../lib/BLEController/BLEController.cpp"
+#include "../../lib/Logger/Logger.cpp"
+#include "../../lib/common/BleCommand.cpp"
+#include "../../lib/common/CommandFactory.cpp"
+#include "../../lib/inputDevice/InputText.cpp"
+#include "../../lib/inputTrace/InputTrace.cpp"
+#include "../../lib/latencyTracer/LatencyTracer.cpp"
+#include "../../lib/loopWake/LoopWake.cpp"
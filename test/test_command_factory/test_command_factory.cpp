@@ -0,0 +1,151 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Command dispatch through the real CommandFactory tables. The global
+ * operator new is replaced by a counting one, so the suite can check
+ * that a pooled action, once built, is dispatched again without a
+ * single heap allocation.
+ */
+
+#include <unity.h>
+#include <new>
+#include <stdlib.h>
+#include <string>
+#include "BLEController.h"
+#include "CommandFactory.h"
+#include "Command.h"
+
+namespace
+{
+    size_t allocations = 0;
+
+    void *countedAlloc(size_t size)
+    {
+        allocations++;
+        return malloc(size ? size : 1);
+    }
+
+    // Out of line so the compiler does not pair the inlined malloc with operator delete
+    __attribute__((noinline)) void release(void *block)
+    {
+        free(block);
+    }
+}
+
+void *operator new(size_t size)
+{
+    void *block = countedAlloc(size);
+    if (!block)
+    {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAlloc(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAlloc(size);
+}
+
+void operator delete(void *block) noexcept { release(block); }
+void operator delete[](void *block) noexcept { release(block); }
+void operator delete(void *block, size_t) noexcept { release(block); }
+void operator delete[](void *block, size_t) noexcept { release(block); }
+
+namespace
+{
+    BLEController bleController("MacroPad");
+    CommandFactory *commandFactory = nullptr;
+
+    // What MacroManager does for each action of a combo on press and release
+    void dispatch(const std::string &action)
+    {
+        Command *command = commandFactory->acquire(action);
+        TEST_ASSERT_NOT_NULL(command);
+        command->press();
+        command->release();
+    }
+}
+
+void setUp(void)
+{
+    delete commandFactory;
+    commandFactory = new CommandFactory(nullptr, &bleController, nullptr, nullptr, nullptr, nullptr);
+    native::keepHidReports = false;
+    native::hidReportCount = 0;
+}
+
+void tearDown(void)
+{
+    native::keepHidReports = true;
+}
+
+void test_pooled_ble_action_does_not_allocate(void)
+{
+    const std::string actions[] = {"S_B:a", "S_B:CTRL+SHIFT+ESC", "S_B:VOL_UP", "S_B:MOUSE_LEFT", "S_B:hello"};
+    for (const std::string &action : actions)
+    {
+        dispatch(action); // First use builds and compiles the command
+    }
+
+    const size_t reportsBefore = native::hidReportCount;
+    allocations = 0;
+    for (const std::string &action : actions)
+    {
+        dispatch(action);
+    }
+    TEST_ASSERT_EQUAL_size_t(0, allocations);
+    TEST_ASSERT_TRUE(native::hidReportCount > reportsBefore);
+}
+
+void test_exact_and_prefix_actions_resolve(void)
+{
+    // Every exact key: one out of order in the sorted table would make the
+    // binary search miss it or a neighbour
+    const char *const exactKeys[] = {
+        "AP_MODE", "CALIBRATE_SENSOR", "ENTER_SLEEP", "EXECUTE_GESTURE", "FLASHLIGHT",
+        "GESTURE_DATASET_CLEAR", "GESTURE_TEMPLATES_CLEAR", "GYROMOUSE_CYCLE_SENSITIVITY",
+        "GYROMOUSE_RECENTER", "GYROMOUSE_START", "GYROMOUSE_STOP", "GYROMOUSE_TOGGLE",
+        "HOP_BLE_DEVICE", "IR_CHECK", "LATENCY_INFO", "LED_INFO", "LED_OFF", "LED_RESTORE",
+        "LED_SAVE", "MEM_INFO", "REACTIVE_LIGHTING", "RESET_ALL", "SAVE_INTERACTIVE_COLORS",
+        "TOGGLE_BLE_WIFI", "TOGGLE_KEY_ORDER", "TRACE_RECORD", "TRACE_REPLAY", "WAKE_INFO",
+    };
+    for (const char *key : exactKeys)
+    {
+        TEST_ASSERT_NOT_NULL_MESSAGE(commandFactory->acquire(key), key);
+    }
+    TEST_ASSERT_NOT_NULL(commandFactory->acquire("SWITCH_COMBO_1"));
+    TEST_ASSERT_NULL(commandFactory->acquire("NOT_AN_ACTION"));
+    TEST_ASSERT_NULL(commandFactory->acquire("A"));
+    TEST_ASSERT_NULL(commandFactory->acquire("ZZZ"));
+}
+
+void test_unknown_action_is_pooled_as_null(void)
+{
+    const std::string action = "NOT_AN_ACTION";
+    TEST_ASSERT_NULL(commandFactory->acquire(action));
+    allocations = 0;
+    TEST_ASSERT_NULL(commandFactory->acquire(action));
+    TEST_ASSERT_EQUAL_size_t(0, allocations);
+}
+
+int main(int argc, char **argv)
+{
+    bleController.startBluetooth();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_pooled_ble_action_does_not_allocate);
+    RUN_TEST(test_exact_and_prefix_actions_resolve);
+    RUN_TEST(test_unknown_action_is_pooled_as_null);
+    return UNITY_END();
+}
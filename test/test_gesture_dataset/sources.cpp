@@ -0,0 +1,8 @@
+// Production sources exercised by this suite (the native env builds no lib/ folder)
+#include "../../lib/Logger/Logger.cpp"
+#include "../../lib/gesture/GestureClassifier.cpp"
+#include "../../lib/gesture/GestureDataset.cpp"
+#include "../../lib/gesture/GestureFeatures.cpp"
+#include "../../lib/gesture/SampleBuffer.cpp"
+#include "../../lib/gesture/SimpleGestureDetector.cpp"
+#include "../../lib/gesture/TemplateGestureRecognizer.cpp"
@@ -0,0 +1,416 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Offline evaluation of the gesture recognizers on a recorded dataset:
+ * every capture goes through detectSimpleGesture, the template matcher
+ * and the classifier, and the suite prints accuracy per confidence
+ * threshold and a confusion matrix at the GestureAnalyze threshold.
+ *
+ *   GESTURE_DATASET=gesture_dataset.bin     captures from GESTURE_RECORD_<label>
+ *   GESTURE_TEMPLATES=gesture_templates.bin templates to match (default: one per label, trained here)
+ *   GESTURE_MODEL=gesture_model.bin         classifier model (skipped without one)
+ *   GESTURE_SENSOR=adxl345                  accel-only rules (default mpu6050)
+ *   pio test -e native -f test_gesture_dataset -v
+ *
+ * Without GESTURE_DATASET a synthetic MPU6050 dataset (swipes and shakes)
+ * is written through GestureDataset, and the rules and templates must
+ * classify it.
+ */
+
+#include <unity.h>
+#include <LittleFS.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+#include "GestureClassifier.h"
+#include "GestureDataset.h"
+#include "SimpleGestureDetector.h"
+#include "TemplateGestureRecognizer.h"
+
+namespace
+{
+    const float kThresholds[] = {0.0f, 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f};
+    const float kMatrixThreshold = 0.5f; // GestureAnalyze default
+    const float kSyntheticMinAccuracy = 0.9f;
+    const char *const kSyntheticLabels[] = {"G_SWIPE_RIGHT", "G_SWIPE_LEFT", "G_SHAKE"};
+    const int kSyntheticPerLabel = 12;
+
+    struct Capture
+    {
+        String label;
+        uint16_t sampleHZ;
+        uint16_t sampleCount;
+        float accelScale;
+        float gyroScale;
+        std::vector<int16_t> channels; // x, y, z, gyroX, gyroY, gyroZ, status; sampleCount each
+    };
+
+    struct Prediction
+    {
+        String name; // Empty: nothing recognized
+        float confidence;
+    };
+
+    std::vector<Capture> captures;
+    bool synthetic = false;
+    bool trainedTemplates = false;
+    std::map<String, String> templateLabels; // "G_ID:n" of a template trained here -> its label
+    TemplateGestureRecognizer templates;
+    GestureClassifier classifier;
+
+    std::vector<uint8_t> readHostFile(const char *path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // Copy a host file to the device path the production code loads from
+    bool installHostFile(const char *hostPath, const char *devicePath)
+    {
+        const std::vector<uint8_t> data = readHostFile(hostPath);
+        if (data.empty())
+        {
+            return false;
+        }
+        File file = LittleFS.open(devicePath, "w");
+        file.write(data.data(), data.size());
+        file.close();
+        return true;
+    }
+
+    // GestureDataset file format, see GestureDataset.h
+    bool parseDataset(const std::vector<uint8_t> &data, std::vector<Capture> &out)
+    {
+        if (data.size() < 8 || memcmp(data.data(), "MPGD", 4) != 0 || data[4] != 1)
+        {
+            return false;
+        }
+
+        size_t offset = 8;
+        auto readBytes = [&](void *target, size_t length) {
+            if (offset + length > data.size())
+            {
+                return false;
+            }
+            memcpy(target, data.data() + offset, length);
+            offset += length;
+            return true;
+        };
+        auto readString = [&](String &text) {
+            uint8_t length = 0;
+            if (!readBytes(&length, 1) || offset + length > data.size())
+            {
+                return false;
+            }
+            text = String(std::string(reinterpret_cast<const char *>(data.data() + offset), length));
+            offset += length;
+            return true;
+        };
+
+        while (offset < data.size())
+        {
+            Capture capture;
+            String recognized;
+            float confidence;
+            uint32_t recognitionUs;
+            if (!readString(capture.label) || !readString(recognized) || !readBytes(&confidence, sizeof(float)) ||
+                !readBytes(&recognitionUs, sizeof(uint32_t)) || !readBytes(&capture.sampleHZ, sizeof(uint16_t)) ||
+                !readBytes(&capture.sampleCount, sizeof(uint16_t)) || !readBytes(&capture.accelScale, sizeof(float)) ||
+                !readBytes(&capture.gyroScale, sizeof(float)))
+            {
+                return false;
+            }
+            capture.channels.resize(static_cast<size_t>(capture.sampleCount) * 7);
+            if (!readBytes(capture.channels.data(), capture.channels.size() * sizeof(int16_t)))
+            {
+                return false;
+            }
+            out.push_back(capture);
+        }
+        return true;
+    }
+
+    void toBuffer(const Capture &capture, SampleBuffer &buffer)
+    {
+        buffer.allocate(capture.sampleCount);
+        memcpy(buffer.x, capture.channels.data(), capture.channels.size() * sizeof(int16_t));
+        buffer.accelScale = capture.accelScale;
+        buffer.gyroScale = capture.gyroScale;
+        buffer.sampleHZ = capture.sampleHZ;
+        buffer.sampleCount = capture.sampleCount;
+    }
+
+    // Still device, then a gyro Z pulse (swipe) or a Z oscillation (shake), at 100 Hz
+    void synthesize(const char *label, std::mt19937 &random, SampleBuffer &buffer)
+    {
+        const uint16_t count = 60;
+        std::uniform_real_distribution<float> amplitude(180.0f, 320.0f);
+        std::uniform_int_distribution<int> start(4, 14);
+        std::uniform_int_distribution<int> length(25, 40);
+        std::normal_distribution<float> accelNoise(0.0f, 0.01f);
+        std::normal_distribution<float> gyroNoise(0.0f, 3.0f);
+
+        const bool shake = strcmp(label, "G_SHAKE") == 0;
+        const float sign = strcmp(label, "G_SWIPE_LEFT") == 0 ? -1.0f : 1.0f;
+        const float peak = amplitude(random);
+        const int first = start(random);
+        const int span = length(random);
+
+        buffer.allocate(count);
+        buffer.setAccelRange(4.0f);
+        buffer.sampleHZ = 100;
+        for (uint16_t i = 0; i < count; i++)
+        {
+            float motion = 0.0f;
+            const int step = static_cast<int>(i) - first;
+            if (step >= 0 && step < span)
+            {
+                const float phase = static_cast<float>(step) / span;
+                motion = shake ? peak * sinf(phase * 3.0f * 2.0f * PI) : sign * peak * sinf(phase * PI);
+            }
+
+            Sample sample;
+            sample.x = accelNoise(random);
+            sample.y = accelNoise(random);
+            sample.z = 1.0f + accelNoise(random);
+            sample.gyroX = gyroNoise(random) * DEG_TO_RAD;
+            sample.gyroY = gyroNoise(random) * DEG_TO_RAD;
+            sample.gyroZ = (motion + gyroNoise(random)) * DEG_TO_RAD;
+            sample.gyroValid = true;
+            sample.temperatureValid = true;
+            sample.temperature = 25.0f;
+            buffer.set(i, sample);
+        }
+        buffer.sampleCount = count;
+    }
+
+    // Record the synthetic captures the way GESTURE_RECORD_<label> does
+    std::vector<uint8_t> synthesizeDataset()
+    {
+        std::mt19937 random(7);
+        SampleBuffer buffer;
+        for (int n = 0; n < kSyntheticPerLabel; n++)
+        {
+            for (const char *label : kSyntheticLabels)
+            {
+                synthesize(label, random, buffer);
+                GestureDataset::getInstance().capture(label, buffer, GestureRecognitionResult(), 0);
+                GestureDataset::getInstance().service();
+            }
+        }
+        const fs::FileData *dataset = LittleFS.contents(GESTURE_DATASET_PATH);
+        return dataset ? *dataset : std::vector<uint8_t>();
+    }
+
+    // One template per label from its first capture; templates occupy the low IDs
+    void trainTemplates()
+    {
+        SampleBuffer buffer;
+        for (const Capture &capture : captures)
+        {
+            const String name = "G_ID:" + String(static_cast<int>(templateLabels.size()));
+            bool known = false;
+            for (const auto &entry : templateLabels)
+            {
+                known = known || entry.second == capture.label;
+            }
+            if (known || templateLabels.size() >= GESTURE_TEMPLATE_MAX)
+            {
+                continue;
+            }
+            toBuffer(capture, buffer);
+            if (templates.train(static_cast<uint8_t>(templateLabels.size()), buffer))
+            {
+                templateLabels[name] = capture.label;
+            }
+        }
+        trainedTemplates = true;
+    }
+
+    SimpleGestureConfig sensorConfig()
+    {
+        const char *sensor = getenv("GESTURE_SENSOR");
+        SimpleGestureConfig config;
+        if (sensor && strcmp(sensor, "adxl345") == 0)
+        {
+            config.sensorTag = "ADXL345";
+            config.sensorMode = SENSOR_MODE_ADXL345;
+            config.useGyro = false;
+        }
+        else
+        {
+            config.sensorTag = "MPU6050";
+            config.sensorMode = SENSOR_MODE_MPU6050;
+            config.useGyro = true;
+        }
+        return config;
+    }
+
+    template <typename Recognize>
+    std::vector<Prediction> evaluate(Recognize recognize)
+    {
+        std::vector<Prediction> predictions;
+        SampleBuffer buffer;
+        for (const Capture &capture : captures)
+        {
+            toBuffer(capture, buffer);
+            const GestureRecognitionResult result = recognize(buffer);
+            predictions.push_back({result.gestureID >= 0 ? result.gestureName : String(), result.confidence});
+        }
+        return predictions;
+    }
+
+    String predicted(const Prediction &prediction, float threshold)
+    {
+        return prediction.name.length() > 0 && prediction.confidence >= threshold ? prediction.name : String("none");
+    }
+
+    float accuracy(const std::vector<Prediction> &predictions, float threshold)
+    {
+        size_t correct = 0;
+        for (size_t i = 0; i < captures.size(); i++)
+        {
+            correct += predicted(predictions[i], threshold) == captures[i].label ? 1 : 0;
+        }
+        return captures.empty() ? 0.0f : static_cast<float>(correct) / captures.size();
+    }
+
+    void report(const char *recognizer, const std::vector<Prediction> &predictions)
+    {
+        printf("\n== %s: %u captures\n", recognizer, static_cast<unsigned>(captures.size()));
+        printf("threshold  accuracy\n");
+        for (float threshold : kThresholds)
+        {
+            printf("   %.1f      %5.1f%%\n", threshold, 100.0f * accuracy(predictions, threshold));
+        }
+
+        std::vector<String> labels;
+        std::vector<String> names;
+        std::map<std::pair<String, String>, int> matrix;
+        size_t width = 7;
+        for (size_t i = 0; i < captures.size(); i++)
+        {
+            const String name = predicted(predictions[i], kMatrixThreshold);
+            if (std::find(labels.begin(), labels.end(), captures[i].label) == labels.end())
+            {
+                labels.push_back(captures[i].label);
+            }
+            if (std::find(names.begin(), names.end(), name) == names.end())
+            {
+                names.push_back(name);
+            }
+            matrix[{captures[i].label, name}]++;
+            width = std::max<size_t>(width, std::max(captures[i].label.length(), name.length()) + 2);
+        }
+
+        printf("confusion at %.1f (rows: label, columns: recognized)\n", kMatrixThreshold);
+        printf("%-*s", static_cast<int>(width), "label");
+        for (const String &name : names)
+        {
+            printf("%*s", static_cast<int>(width), name.c_str());
+        }
+        printf("\n");
+        for (const String &label : labels)
+        {
+            printf("%-*s", static_cast<int>(width), label.c_str());
+            for (const String &name : names)
+            {
+                printf("%*d", static_cast<int>(width), matrix[{label, name}]);
+            }
+            printf("\n");
+        }
+    }
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_rules(void)
+{
+    const SimpleGestureConfig config = sensorConfig();
+    const std::vector<Prediction> predictions =
+        evaluate([&](SampleBuffer &buffer) { return detectSimpleGesture(&buffer, config); });
+    report("Rules (detectSimpleGesture)", predictions);
+
+    if (synthetic)
+    {
+        TEST_ASSERT_TRUE(accuracy(predictions, kMatrixThreshold) >= kSyntheticMinAccuracy);
+    }
+}
+
+void test_templates(void)
+{
+    if (!templates.isReady())
+    {
+        TEST_IGNORE_MESSAGE("no templates");
+    }
+
+    std::vector<Prediction> predictions =
+        evaluate([&](SampleBuffer &buffer) { return templates.recognize(buffer); });
+    for (Prediction &prediction : predictions)
+    {
+        auto label = templateLabels.find(prediction.name);
+        if (label != templateLabels.end())
+        {
+            prediction.name = label->second;
+        }
+    }
+    report(trainedTemplates ? "Templates (one per label, trained here)" : "Templates", predictions);
+
+    if (synthetic)
+    {
+        TEST_ASSERT_TRUE(accuracy(predictions, kMatrixThreshold) >= kSyntheticMinAccuracy);
+    }
+}
+
+void test_classifier(void)
+{
+    if (!classifier.isReady())
+    {
+        TEST_IGNORE_MESSAGE("no model, set GESTURE_MODEL");
+    }
+
+    const std::vector<Prediction> predictions =
+        evaluate([&](SampleBuffer &buffer) { return classifier.recognize(buffer); });
+    report("Classifier", predictions);
+}
+
+int main(int argc, char **argv)
+{
+    LittleFS.format();
+
+    const char *datasetPath = getenv("GESTURE_DATASET");
+    const std::vector<uint8_t> dataset = datasetPath ? readHostFile(datasetPath) : synthesizeDataset();
+    synthetic = datasetPath == nullptr;
+
+    const char *templatesPath = getenv("GESTURE_TEMPLATES");
+    const char *modelPath = getenv("GESTURE_MODEL");
+
+    UNITY_BEGIN();
+    if (!parseDataset(dataset, captures) || captures.empty())
+    {
+        TEST_MESSAGE("GESTURE_DATASET: no captures (missing or not a version 1 dataset)");
+        return UNITY_END() + 1;
+    }
+    if (templatesPath && installHostFile(templatesPath, GESTURE_TEMPLATE_PATH))
+    {
+        templates.load();
+    }
+    else
+    {
+        trainTemplates();
+    }
+    if (modelPath && installHostFile(modelPath, GESTURE_MODEL_PATH))
+    {
+        classifier.load();
+    }
+
+    RUN_TEST(test_rules);
+    RUN_TEST(test_templates);
+    RUN_TEST(test_classifier);
+    return UNITY_END();
+}
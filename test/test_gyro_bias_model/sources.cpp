@@ -0,0 +1,3 @@
+// Production sources exercised by this suite (the native env builds no lib/ folder)
+#include "../../lib/Logger/Logger.cpp"
+#include "../../lib/gesture/GyroBiasModel.cpp"
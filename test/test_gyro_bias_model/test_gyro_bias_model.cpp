@@ -0,0 +1,97 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Gating of GyroBiasModel::observe: a moving window is not an observation,
+ * a still window is, and once the model is ready a still window whose mean
+ * is more than GYRO_BIAS_MAX_STEP from the prediction (a slow steady turn)
+ * is dropped. The tests share the singleton and run in order.
+ */
+
+#include <unity.h>
+#include <LittleFS.h>
+#include <cmath>
+#include "GyroBiasModel.h"
+
+namespace
+{
+    const unsigned long kFrameMs = 10; // 100 Hz capture rate
+    const float kTemperature = 30.0f;
+    const float kBias[3] = {0.02f, -0.03f, 0.01f}; // rad/s
+
+    // One window and a bit, gyro = bias + amplitude * alternating sign, device flat at 1 g
+    void feedWindow(const float bias[3], float amplitude)
+    {
+        const int frames = static_cast<int>((GYRO_BIAS_WINDOW_MS + 2 * kFrameMs) / kFrameMs);
+        for (int i = 0; i < frames; i++)
+        {
+            const float wobble = (i % 2 ? 1.0f : -1.0f) * amplitude;
+            MotionSensor::Frame raw = {0.0f, 0.0f, 1.0f, bias[0] + wobble, bias[1] - wobble, bias[2] + wobble};
+            GyroBiasModel::getInstance().observe(raw, kTemperature);
+            native::advanceMs(kFrameMs);
+        }
+        native::advanceMs(500); // Gap: the next window starts fresh
+    }
+
+    MotionSensor::Frame corrected(const float gyro[3])
+    {
+        MotionSensor::Frame frame = {0.0f, 0.0f, 1.0f, gyro[0], gyro[1], gyro[2]};
+        GyroBiasModel::getInstance().apply(frame, kTemperature);
+        return frame;
+    }
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_moving_window_is_rejected()
+{
+    feedWindow(kBias, 0.5f); // Hand tremor: far above GYRO_BIAS_STILL_STD
+
+    TEST_ASSERT_FALSE(GyroBiasModel::getInstance().isReady());
+}
+
+void test_still_window_is_accepted()
+{
+    feedWindow(kBias, 0.002f);
+
+    TEST_ASSERT_TRUE(GyroBiasModel::getInstance().isReady());
+    const MotionSensor::Frame frame = corrected(kBias);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, frame.gyroX);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, frame.gyroY);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, frame.gyroZ);
+}
+
+void test_jump_above_max_step_is_rejected()
+{
+    const float turning[3] = {kBias[0] + 2.0f * GYRO_BIAS_MAX_STEP, kBias[1], kBias[2]};
+    feedWindow(turning, 0.002f); // Quiet, but a slow steady turn on X
+
+    const MotionSensor::Frame frame = corrected(kBias);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, frame.gyroX);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, frame.gyroY);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, frame.gyroZ);
+}
+
+void test_small_drift_is_followed()
+{
+    const float drifted[3] = {kBias[0] + 0.5f * GYRO_BIAS_MAX_STEP, kBias[1], kBias[2]};
+    feedWindow(drifted, 0.002f);
+
+    // One new observation among two: the estimate moves towards the drift
+    const MotionSensor::Frame frame = corrected(kBias);
+    TEST_ASSERT_TRUE(frame.gyroX < -0.1f * GYRO_BIAS_MAX_STEP);
+    TEST_ASSERT_TRUE(frame.gyroX > -0.5f * GYRO_BIAS_MAX_STEP);
+}
+
+int main(int argc, char **argv)
+{
+    LittleFS.format();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_moving_window_is_rejected);
+    RUN_TEST(test_still_window_is_accepted);
+    RUN_TEST(test_jump_above_max_step_is_rejected);
+    RUN_TEST(test_small_drift_is_followed);
+    return UNITY_END();
+}
@@ -0,0 +1,17 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Baseline S_B: executor, parsed on every press (see legacy_executor.cpp).
+ */
+
+#ifndef LEGACY_EXECUTOR_H
+#define LEGACY_EXECUTOR_H
+
+#include <Arduino.h>
+
+namespace legacy
+{
+  void BLExecutor(String action, bool pressed);
+}
+
+#endif // LEGACY_EXECUTOR_H
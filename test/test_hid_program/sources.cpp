@@ -0,0 +1,4 @@
+// Production sources exercised by this suite (the native env builds no lib/ folder)
+#include "../../lib/BLEController/BLEController.cpp"
+#include "../../lib/Logger/Logger.cpp"
+#include "../../lib/latencyTracer/LatencyTracer.cpp"
@@ -0,0 +1,129 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * HidProgram executor against the per-press parser it replaced: both
+ * must send the same HID reports for every action, and the time per
+ * press + release of each is printed (pio test -e native -v).
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BLEController.h"
+#include "legacy_executor.h"
+
+namespace
+{
+    const size_t kRounds = 2000;
+
+    // What combos typically bind: characters, chords, media, mouse and text
+    const char *const kActions[] = {
+        "S_B:a",
+        "S_B:CTRL+c",
+        "S_B:CTRL+SHIFT+ESC",
+        "S_B:RIGHT_ALT+F13",
+        "S_B:VOL_UP",
+        "S_B:PLAY_PAUSE",
+        "S_B:MOUSE_LEFT",
+        "S_B:MOUSE_MOVE_10_-5_0_0",
+        "S_B:CTRL+ALT+DELETE",
+        "S_B:hello",
+        "S_B:++",
+        "S_B:SUPER,r",
+    };
+
+    BLEController bleController("MacroPad");
+
+    std::vector<std::string> legacyReports(const char *action)
+    {
+        native::hidReports.clear();
+        legacy::BLExecutor(action, true);
+        legacy::BLExecutor(action, false);
+        return native::hidReports;
+    }
+
+    std::vector<std::string> programReports(const HidProgram &program)
+    {
+        native::hidReports.clear();
+        bleController.execute(program, true);
+        bleController.execute(program, false);
+        return native::hidReports;
+    }
+
+    template <typename Press>
+    double nanosecondsPerPress(Press press)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < kRounds; round++)
+        {
+            for (size_t i = 0; i < sizeof(kActions) / sizeof(kActions[0]); i++)
+            {
+                press(i);
+            }
+            native::hidReports.clear();
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / (kRounds * (sizeof(kActions) / sizeof(kActions[0])));
+    }
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_program_sends_the_same_reports(void)
+{
+    for (const char *action : kActions)
+    {
+        const std::shared_ptr<const HidProgram> program = bleController.getProgram(action);
+        TEST_ASSERT_NOT_NULL(program.get());
+
+        std::string expected;
+        for (const std::string &report : legacyReports(action))
+        {
+            expected += report + "\n";
+        }
+        std::string actual;
+        for (const std::string &report : programReports(*program))
+        {
+            actual += report + "\n";
+        }
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(expected.c_str(), actual.c_str(), action);
+    }
+}
+
+void test_press_time(void)
+{
+    std::vector<std::shared_ptr<const HidProgram>> programs;
+    for (const char *action : kActions)
+    {
+        programs.push_back(bleController.getProgram(action));
+    }
+    const std::vector<String> actions(std::begin(kActions), std::end(kActions));
+
+    const double legacyNs = nanosecondsPerPress([&](size_t i) {
+        legacy::BLExecutor(actions[i], true);
+        legacy::BLExecutor(actions[i], false);
+    });
+    const double programNs = nanosecondsPerPress([&](size_t i) {
+        bleController.execute(*programs[i], true);
+        bleController.execute(*programs[i], false);
+    });
+
+    printf("\n%u actions x %u rounds, press + release\n", static_cast<unsigned>(actions.size()),
+           static_cast<unsigned>(kRounds));
+    printf("String parser  %9.1f ns\n", legacyNs);
+    printf("HidProgram     %9.1f ns (%.1fx)\n", programNs, legacyNs / programNs);
+}
+
+int main(int argc, char **argv)
+{
+    bleController.startBluetooth();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_program_sends_the_same_reports);
+    RUN_TEST(test_press_time);
+    return UNITY_END();
+}
@@ -0,0 +1,69 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Link seams for the input trace suite: a CommandFactory that only knows
+ * the commands the suite uses, and the InputHub members MacroManager calls.
+ */
+
+#include "CommandFactory.h"
+#include "BleCommand.h"
+#include "InputHub.h"
+#include "InputTraceCommand.h"
+
+// InputHub owns the real devices through unique_ptr; none is created here
+class Keypad {};
+class RotaryEncoder {};
+class IRSensor {};
+class IRSender {};
+class IRStorage {};
+class GestureDevice {};
+
+InputHub::InputHub() : gestureCaptureEnabled(false) {}
+InputHub::~InputHub() = default;
+void InputHub::handleReactiveLighting(uint8_t, bool, int, uint16_t) {}
+void InputHub::updateReactiveLighting() {}
+
+CommandFactory::CommandFactory(SpecialAction *specialAction, BLEController *bleController, GyroMouse *gyroMouse,
+                               InputHub *inputHub, WIFIManager *wifiManager, CombinationManager *comboManager)
+    : _specialAction(specialAction),
+      _bleController(bleController),
+      _gyroMouse(gyroMouse),
+      _inputHub(inputHub),
+      _wifiManager(wifiManager),
+      _comboManager(comboManager),
+      _macroManager(nullptr) {}
+
+void CommandFactory::setMacroManager(MacroManager *macroManager)
+{
+    _macroManager = macroManager;
+}
+
+Command *CommandFactory::acquire(const std::string &actionString)
+{
+    auto it = _pool.find(actionString);
+    if (it != _pool.end())
+    {
+        return it->second.get();
+    }
+
+    Command *command = nullptr;
+    if (actionString.rfind("S_B:", 0) == 0)
+    {
+        command = new BleCommand(_bleController, actionString);
+    }
+    else if (actionString == "TRACE_RECORD")
+    {
+        command = new InputTraceCommand(InputTraceCommand::Mode::RECORD);
+    }
+    else if (actionString == "TRACE_REPLAY")
+    {
+        command = new InputTraceCommand(InputTraceCommand::Mode::REPLAY);
+    }
+    _pool[actionString].reset(command);
+    return command;
+}
+
+void CommandFactory::clearPool()
+{
+    _pool.clear();
+}
@@ -0,0 +1,11 @@
+// Production sources exercised by this suite (the native env builds no lib/ folder)
+#include "../../lib/BLEController/BLEController.cpp"
+#include "../../lib/Logger/Logger.cpp"
+#include "../../lib/common/BleCommand.cpp"
+#include "../../lib/inputDevice/InputText.cpp"
+#include "../../lib/inputTrace/InputTrace.cpp"
+#include "../../lib/latencyTracer/LatencyTracer.cpp"
+#include "../../lib/loopWake/LoopWake.cpp"
+#include "../../lib/macroManager/ComboIndex.cpp"
+#include "../../lib/macroManager/TapDanceEngine.cpp"
+#include "../../lib/macroManager/macroManager.cpp"
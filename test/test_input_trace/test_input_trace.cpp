@@ -0,0 +1,182 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Record a key sequence with TRACE_RECORD, replay it with TRACE_REPLAY and
+ * check that the replay sends the same HID reports, through the real
+ * InputTrace, MacroManager and BLEController on an in-memory LittleFS.
+ */
+
+#include <unity.h>
+#include <LittleFS.h>
+#include "BLEController.h"
+#include "CommandFactory.h"
+#include "InputHub.h"
+#include "InputTrace.h"
+#include "macroManager.h"
+
+namespace
+{
+    KeypadConfig keypadConfig;
+    BLEController bleController("MacroPad");
+    InputHub inputHub;
+    CommandFactory commandFactory(nullptr, &bleController, nullptr, &inputHub, nullptr, nullptr);
+    MacroManager *macroManager = nullptr;
+
+    // What InputHub::enqueue followed by the input task's poll loop does
+    void deliver(const InputEvent &event)
+    {
+        InputTrace::getInstance().record(InputHub::TimedEvent{event, millis()});
+        macroManager->handleInputEvent(event);
+    }
+
+    void key(char label, bool pressed)
+    {
+        InputEvent event;
+        event.type = InputEvent::EventType::KEY_PRESS;
+        event.value1 = label - '1';
+        event.state = pressed;
+        deliver(event);
+    }
+
+    // Input task ticks, one per millisecond; replayed events are injected like InputHub::scanReplay
+    void run(unsigned long ms)
+    {
+        for (unsigned long i = 0; i < ms; i++)
+        {
+            native::advanceMs(1);
+            InputEvent event;
+            while (InputTrace::getInstance().nextReplayEvent(millis(), event))
+            {
+                deliver(event);
+            }
+            macroManager->update();
+        }
+    }
+
+    void tap(char label)
+    {
+        key(label, true);
+        run(80);
+        key(label, false);
+        run(80);
+    }
+
+    size_t traceSize()
+    {
+        const fs::FileData *trace = LittleFS.contents(INPUT_TRACE_PATH);
+        return trace ? trace->size() : 0;
+    }
+
+    std::string joined(const std::vector<std::string> &reports)
+    {
+        std::string text;
+        for (const std::string &report : reports)
+        {
+            text += report + "\n";
+        }
+        return text;
+    }
+}
+
+void setUp(void)
+{
+    LittleFS.format();
+    native::hidReports.clear();
+
+    keypadConfig.rows = 1;
+    keypadConfig.cols = 4;
+    keypadConfig.keys = {{'1', '2', '3', '4'}};
+
+    delete macroManager;
+    macroManager = new MacroManager();
+    macroManager->begin(nullptr, &bleController, &inputHub, nullptr, nullptr, nullptr, &commandFactory,
+                        &keypadConfig, nullptr);
+    macroManager->combinations = {
+        {"1", {"S_B:a"}},
+        {"2", {"S_B:CTRL+c"}},
+        {"3", {"TRACE_RECORD"}},
+        {"4", {"TRACE_REPLAY"}},
+        {"1+2", {"TRACE_RECORD"}},
+    };
+    macroManager->compileCombinations();
+    bleController.startBluetooth();
+}
+
+void tearDown(void)
+{
+    run(1000); // Let a replay finish before the next test
+}
+
+void test_replay_sends_the_recorded_reports(void)
+{
+    tap('3'); // Start recording
+    tap('1');
+    tap('2');
+    std::vector<std::string> recorded = native::hidReports;
+    tap('3'); // Stop recording
+    InputTrace::getInstance().service();
+
+    TEST_ASSERT_FALSE(InputTrace::getInstance().isRecording());
+    TEST_ASSERT_EQUAL_size_t(8 + 4 * 8, traceSize()); // Header and the four key events, no trace keys
+
+    native::hidReports.clear();
+    tap('4'); // Replay
+    InputTrace::getInstance().service();
+    TEST_ASSERT_TRUE(InputTrace::getInstance().isReplaying());
+    run(1000);
+
+    TEST_ASSERT_FALSE(InputTrace::getInstance().isReplaying());
+    TEST_ASSERT_FALSE(InputTrace::getInstance().isRecording());
+    TEST_ASSERT_EQUAL_STRING(joined(recorded).c_str(), joined(native::hidReports).c_str());
+}
+
+void test_trace_chord_is_not_recorded(void)
+{
+    key('1', true); // "1+2" starts recording
+    key('2', true);
+    run(80);
+    key('1', false);
+    key('2', false);
+    run(80);
+
+    tap('2');
+    key('1', true); // "1+2" stops recording
+    key('2', true);
+    run(80);
+    key('2', false);
+    key('1', false);
+    run(80);
+    InputTrace::getInstance().service();
+
+    TEST_ASSERT_FALSE(InputTrace::getInstance().isRecording());
+    TEST_ASSERT_EQUAL_size_t(8 + 2 * 8, traceSize());
+}
+
+void test_replay_does_not_restart_recording(void)
+{
+    tap('3');
+    tap('1');
+    tap('3');
+    InputTrace::getInstance().service();
+    const size_t recordedSize = traceSize();
+
+    tap('4');
+    InputTrace::getInstance().service();
+    TEST_ASSERT_TRUE(InputTrace::getInstance().isReplaying());
+
+    InputTrace::getInstance().startRecording(); // What a recorded TRACE_RECORD press would do
+    TEST_ASSERT_FALSE(InputTrace::getInstance().isRecording());
+    run(1000);
+    InputTrace::getInstance().service();
+
+    TEST_ASSERT_EQUAL_size_t(recordedSize, traceSize());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_replay_sends_the_recorded_reports);
+    RUN_TEST(test_trace_chord_is_not_recorded);
+    RUN_TEST(test_replay_does_not_restart_recording);
+    return UNITY_END();
+}
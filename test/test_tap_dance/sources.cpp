@@ -0,0 +1,3 @@
+// Production sources exercised by this suite (the native env builds no lib/ folder)
+#include "../../lib/macroManager/ComboIndex.cpp"
+#include "../../lib/macroManager/TapDanceEngine.cpp"
@@ -0,0 +1,234 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * TapDanceEngine decisions on a 2x2 pad, driven by handleKey()/update()
+ * with the fake clock: single tap, double tap, hold past the tapping term,
+ * and a hold interrupted by another key (permissive hold), including the
+ * order in which the buffered key comes out.
+ */
+
+#include <unity.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "TapDanceEngine.h"
+
+namespace
+{
+    const unsigned long kTappingTerm = 200;
+
+    // Key indexes on the 2x2 pad: row * cols + col
+    const uint8_t kTapHold = 0; // "1": TAP and HOLD
+    const uint8_t kDoubleTap = 1; // "2": TAP and DTAP
+    const uint8_t kTapHoldChain = 2; // "3": TAP, DTAP and TAPHOLD
+    const uint8_t kPlain = 3; // "4": no tap-dance entry
+
+    ComboIndex comboIndex;
+    TapDanceEngine engine;
+    std::vector<TapDanceEngine::Output> outputs;
+
+    void configure()
+    {
+        KeypadConfig keypadConfig;
+        keypadConfig.rows = 2;
+        keypadConfig.cols = 2;
+        keypadConfig.keys = {{'1', '2'}, {'3', '4'}};
+
+        const std::vector<std::string> action = {"S_B:a"};
+        std::map<std::string, std::vector<std::string>> combinations;
+        combinations["1:TAP"] = action;
+        combinations["1:HOLD"] = action;
+        combinations["2:TAP"] = action;
+        combinations["2:DTAP"] = action;
+        combinations["3:TAP"] = action;
+        combinations["3:DTAP"] = action;
+        combinations["3:TAPHOLD"] = action;
+        combinations["4"] = action;
+        comboIndex.build(combinations, keypadConfig);
+        engine.configure(comboIndex, kTappingTerm);
+    }
+
+    void drain()
+    {
+        TapDanceEngine::Output out;
+        while (engine.poll(out))
+        {
+            outputs.push_back(out);
+        }
+    }
+
+    void key(uint8_t index, bool pressed, unsigned long advance = 0)
+    {
+        native::advanceMs(advance);
+        engine.handleKey(index, pressed, millis());
+        drain();
+    }
+
+    void wait(unsigned long ms)
+    {
+        native::advanceMs(ms);
+        engine.update(millis());
+        drain();
+    }
+
+    void assertOutput(size_t at, uint8_t index, uint8_t trigger, uint8_t kind)
+    {
+        TEST_ASSERT_TRUE_MESSAGE(at < outputs.size(), "missing output");
+        TEST_ASSERT_EQUAL_UINT8(index, outputs[at].key);
+        TEST_ASSERT_EQUAL_UINT8(trigger, outputs[at].trigger);
+        TEST_ASSERT_EQUAL_UINT8(kind, outputs[at].kind);
+    }
+}
+
+void setUp(void)
+{
+    engine.reset();
+    outputs.clear();
+}
+
+void tearDown(void) {}
+
+void test_configure_marks_tap_dance_keys()
+{
+    TEST_ASSERT_TRUE(engine.isActive());
+    TEST_ASSERT_TRUE(engine.isTapDanceKey(kTapHold));
+    TEST_ASSERT_TRUE(engine.isTapDanceKey(kDoubleTap));
+    TEST_ASSERT_TRUE(engine.isTapDanceKey(kTapHoldChain));
+    TEST_ASSERT_FALSE(engine.isTapDanceKey(kPlain));
+}
+
+void test_single_tap_without_dtap_resolves_on_release()
+{
+    key(kTapHold, true);
+    TEST_ASSERT_EQUAL(0, outputs.size());
+
+    key(kTapHold, false, 50);
+    TEST_ASSERT_EQUAL(1, outputs.size());
+    assertOutput(0, kTapHold, ComboIndex::TRIGGER_TAP, TapDanceEngine::OUT_TAP);
+}
+
+void test_single_tap_waits_for_a_second_tap()
+{
+    key(kDoubleTap, true);
+    key(kDoubleTap, false, 50);
+    TEST_ASSERT_EQUAL(0, outputs.size());
+    TEST_ASSERT_EQUAL_UINT32(kTappingTerm, engine.msUntilDeadline(millis()));
+
+    wait(kTappingTerm - 1);
+    TEST_ASSERT_EQUAL(0, outputs.size());
+
+    wait(1);
+    TEST_ASSERT_EQUAL(1, outputs.size());
+    assertOutput(0, kDoubleTap, ComboIndex::TRIGGER_TAP, TapDanceEngine::OUT_TAP);
+}
+
+void test_double_tap_resolves_on_second_press()
+{
+    key(kDoubleTap, true);
+    key(kDoubleTap, false, 50);
+    key(kDoubleTap, true, 50);
+    TEST_ASSERT_EQUAL(1, outputs.size());
+    assertOutput(0, kDoubleTap, ComboIndex::TRIGGER_DTAP, TapDanceEngine::OUT_PRESS);
+
+    wait(kTappingTerm * 2); // Decided: the term no longer applies
+    key(kDoubleTap, false);
+    TEST_ASSERT_EQUAL(2, outputs.size());
+    assertOutput(1, kDoubleTap, ComboIndex::TRIGGER_DTAP, TapDanceEngine::OUT_RELEASE);
+}
+
+void test_double_tap_with_taphold_resolves_on_second_release()
+{
+    key(kTapHoldChain, true);
+    key(kTapHoldChain, false, 50);
+    key(kTapHoldChain, true, 50);
+    TEST_ASSERT_EQUAL(0, outputs.size());
+
+    key(kTapHoldChain, false, 50);
+    TEST_ASSERT_EQUAL(1, outputs.size());
+    assertOutput(0, kTapHoldChain, ComboIndex::TRIGGER_DTAP, TapDanceEngine::OUT_TAP);
+}
+
+void test_tap_then_hold_past_the_term()
+{
+    key(kTapHoldChain, true);
+    key(kTapHoldChain, false, 50);
+    key(kTapHoldChain, true, 50);
+    wait(kTappingTerm);
+    TEST_ASSERT_EQUAL(1, outputs.size());
+    assertOutput(0, kTapHoldChain, ComboIndex::TRIGGER_TAPHOLD, TapDanceEngine::OUT_PRESS);
+
+    key(kTapHoldChain, false, 300);
+    TEST_ASSERT_EQUAL(2, outputs.size());
+    assertOutput(1, kTapHoldChain, ComboIndex::TRIGGER_TAPHOLD, TapDanceEngine::OUT_RELEASE);
+}
+
+void test_hold_resolves_at_the_tapping_term()
+{
+    key(kTapHold, true);
+    wait(kTappingTerm - 1);
+    TEST_ASSERT_EQUAL(0, outputs.size());
+    TEST_ASSERT_EQUAL_UINT32(1, engine.msUntilDeadline(millis()));
+
+    wait(1);
+    TEST_ASSERT_EQUAL(1, outputs.size());
+    assertOutput(0, kTapHold, ComboIndex::TRIGGER_HOLD, TapDanceEngine::OUT_PRESS);
+
+    key(kTapHold, false, 500);
+    TEST_ASSERT_EQUAL(2, outputs.size());
+    assertOutput(1, kTapHold, ComboIndex::TRIGGER_HOLD, TapDanceEngine::OUT_RELEASE);
+}
+
+void test_interrupted_hold_resolves_before_the_buffered_key()
+{
+    key(kTapHold, true);
+    key(kPlain, true, 20);
+    TEST_ASSERT_EQUAL(0, outputs.size()); // Buffered behind the undecided key
+
+    key(kPlain, false, 20); // Pressed and released inside the hold: permissive hold
+    TEST_ASSERT_EQUAL(3, outputs.size());
+    assertOutput(0, kTapHold, ComboIndex::TRIGGER_HOLD, TapDanceEngine::OUT_PRESS);
+    assertOutput(1, kPlain, ComboIndex::TRIGGER_NONE, TapDanceEngine::OUT_PRESS);
+    assertOutput(2, kPlain, ComboIndex::TRIGGER_NONE, TapDanceEngine::OUT_RELEASE);
+
+    key(kTapHold, false, 20);
+    TEST_ASSERT_EQUAL(4, outputs.size());
+    assertOutput(3, kTapHold, ComboIndex::TRIGGER_HOLD, TapDanceEngine::OUT_RELEASE);
+}
+
+void test_rolled_key_after_a_tap_keeps_the_tap()
+{
+    key(kTapHold, true);
+    key(kPlain, true, 20);
+    key(kTapHold, false, 20); // Released first: a roll, not a hold
+    TEST_ASSERT_EQUAL(2, outputs.size());
+    assertOutput(0, kTapHold, ComboIndex::TRIGGER_TAP, TapDanceEngine::OUT_TAP);
+    assertOutput(1, kPlain, ComboIndex::TRIGGER_NONE, TapDanceEngine::OUT_PRESS);
+}
+
+void test_other_key_ends_the_double_tap_wait()
+{
+    key(kDoubleTap, true);
+    key(kDoubleTap, false, 50);
+    key(kPlain, true, 20);
+    TEST_ASSERT_EQUAL(2, outputs.size());
+    assertOutput(0, kDoubleTap, ComboIndex::TRIGGER_TAP, TapDanceEngine::OUT_TAP);
+    assertOutput(1, kPlain, ComboIndex::TRIGGER_NONE, TapDanceEngine::OUT_PRESS);
+}
+
+int main(int argc, char **argv)
+{
+    configure();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_configure_marks_tap_dance_keys);
+    RUN_TEST(test_single_tap_without_dtap_resolves_on_release);
+    RUN_TEST(test_single_tap_waits_for_a_second_tap);
+    RUN_TEST(test_double_tap_resolves_on_second_press);
+    RUN_TEST(test_double_tap_with_taphold_resolves_on_second_release);
+    RUN_TEST(test_tap_then_hold_past_the_term);
+    RUN_TEST(test_hold_resolves_at_the_tapping_term);
+    RUN_TEST(test_interrupted_hold_resolves_before_the_buffered_key);
+    RUN_TEST(test_rolled_key_after_a_tap_keeps_the_tap);
+    RUN_TEST(test_other_key_ends_the_double_tap_wait);
+    return UNITY_END();
+}
@@ -0,0 +1,5 @@
+// Production sources exercised by this suite (the native env builds no lib/ folder)
+#include "../../lib/Logger/Logger.cpp"
+#include "../../lib/gesture/GestureFeatures.cpp"
+#include "../../lib/gesture/SampleBuffer.cpp"
+#include "../../lib/gesture/TemplateGestureRecognizer.cpp"
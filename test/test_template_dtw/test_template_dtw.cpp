@@ -0,0 +1,111 @@
+/*
+ * ESP32 MacroPad Project
+ *
+ * Template matching time against the number of stored templates, with
+ * and without early abandon. Both must pick the same template with the
+ * same confidence; the time per recognition of each is printed
+ * (pio test -e native -v).
+ */
+
+#include <unity.h>
+#include <LittleFS.h>
+#include <chrono>
+#include <random>
+#include "TemplateGestureRecognizer.h"
+
+namespace
+{
+    const size_t kRepeats = 200;
+    const uint16_t kSamples = 60;
+
+    TemplateGestureRecognizer templates;
+
+    // Gyro trajectory at 100 Hz: shape 0 pulse, 1 double pulse, 2 oscillation, on one axis
+    void capture(SampleBuffer &buffer, uint8_t axis, float sign, uint8_t shape, float peak, std::mt19937 &random)
+    {
+        std::normal_distribution<float> noise(0.0f, 4.0f);
+        const float cycles[] = {0.5f, 1.0f, 1.5f};
+
+        buffer.allocate(kSamples);
+        buffer.sampleHZ = 100;
+        for (uint16_t i = 0; i < kSamples; i++)
+        {
+            const float phase = static_cast<float>(i) / kSamples;
+            const float motion = sign * peak * sinf(phase * cycles[shape % 3] * 2.0f * PI);
+
+            Sample sample = {};
+            sample.z = 1.0f;
+            float gyro[3] = {noise(random), noise(random), noise(random)};
+            gyro[axis] += motion;
+            sample.gyroX = gyro[0] * DEG_TO_RAD;
+            sample.gyroY = gyro[1] * DEG_TO_RAD;
+            sample.gyroZ = gyro[2] * DEG_TO_RAD;
+            sample.gyroValid = true;
+            buffer.set(i, sample);
+        }
+        buffer.sampleCount = kSamples;
+    }
+
+    // Templates 0..count-1 on distinct axis/sign/shape/amplitude; the probe is close to the first
+    void train(uint8_t count, SampleBuffer &probe)
+    {
+        std::mt19937 random(3);
+        SampleBuffer buffer;
+        templates.clear();
+        for (uint8_t t = 0; t < count; t++)
+        {
+            capture(buffer, t % 3, (t / 3) % 2 ? -1.0f : 1.0f, (t / 6) % 3, 150.0f + 40.0f * (t / 18), random);
+            templates.train(t, buffer);
+        }
+        capture(probe, 0, 1.0f, 0, 160.0f, random);
+    }
+
+    double microsecondsPerRecognition(bool earlyAbandon, const SampleBuffer &probe, GestureRecognitionResult &result)
+    {
+        templates.setEarlyAbandon(earlyAbandon);
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kRepeats; i++)
+        {
+            result = templates.recognize(probe);
+        }
+        const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / kRepeats;
+    }
+}
+
+void setUp(void) {}
+
+void tearDown(void)
+{
+    templates.setEarlyAbandon(true);
+}
+
+void test_recognition_time_by_template_count(void)
+{
+    SampleBuffer probe;
+    printf("\ntemplates   full DTW (us)   early abandon (us)\n");
+    for (uint8_t count = 0; count <= GESTURE_TEMPLATE_MAX; count += 4)
+    {
+        train(count, probe);
+        TEST_ASSERT_EQUAL_UINT8(count, templates.count());
+
+        GestureRecognitionResult full;
+        GestureRecognitionResult pruned;
+        const double fullUs = microsecondsPerRecognition(false, probe, full);
+        const double prunedUs = microsecondsPerRecognition(true, probe, pruned);
+        printf("%9u   %13.1f   %18.1f\n", count, fullUs, prunedUs);
+
+        TEST_ASSERT_EQUAL_INT(full.gestureID, pruned.gestureID);
+        TEST_ASSERT_EQUAL_FLOAT(full.confidence, pruned.confidence);
+        TEST_ASSERT_EQUAL_INT(count > 0 ? 0 : -1, pruned.gestureID);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    LittleFS.format();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_recognition_time_by_template_count);
+    return UNITY_END();
+}
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""
+Export a trained gesture MLP to the int8 blob read by GestureClassifier.
+
+Input: a .npz file with float arrays
+    W0, b0, W1, b1, ...   dense layers, W shaped (outputs, inputs)
+    X                     representative inputs (N, points * channels) in
+                          g and rad/s, point-major: ax ay az [gx gy gz]
+Hidden layers use ReLU, the last layer outputs one logit per class.
+
+Weights are quantized per layer (symmetric int8), activation scales are
+taken from the maximum absolute value seen on X. Copy the output to
+data/gesture_model.bin and upload the filesystem image.
+
+Example:
+    tools/export_gesture_model.py model.npz --points 32 --channels 6 \\
+        --classes G_NONE G_CIRCLE G_FLICK_UP -o data/gesture_model.bin
+"""
+
+import argparse
+import struct
+
+import numpy as np
+
+MAGIC = b"MPGC"
+VERSION = 1
+
+
+def scale_for(values):
+    peak = float(np.max(np.abs(values))) if values.size else 0.0
+    return peak / 127.0 if peak > 0.0 else 1.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("model", help=".npz with W0, b0, ... and X")
+    parser.add_argument("--points", type=int, required=True)
+    parser.add_argument("--channels", type=int, choices=(3, 6), required=True)
+    parser.add_argument("--classes", nargs="+", required=True, help="class names, G_NONE = reject class")
+    parser.add_argument("--accel-range", type=float, default=4.0, help="g mapped to +/-127")
+    parser.add_argument("--gyro-range", type=float, default=17.45, help="rad/s mapped to +/-127")
+    parser.add_argument("-o", "--output", default="gesture_model.bin")
+    args = parser.parse_args()
+
+    data = np.load(args.model)
+    layers = []
+    while "W%d" % len(layers) in data:
+        n = len(layers)
+        layers.append((data["W%d" % n].astype(np.float64), data["b%d" % n].astype(np.float64)))
+    if not layers:
+        raise SystemExit("no W0/b0 in " + args.model)
+
+    width = args.points * args.channels
+    if layers[0][0].shape[1] != width:
+        raise SystemExit("first layer expects %d inputs, model has %d" % (width, layers[0][0].shape[1]))
+    if layers[-1][0].shape[0] != len(args.classes):
+        raise SystemExit("last layer has %d outputs for %d classes" % (layers[-1][0].shape[0], len(args.classes)))
+
+    accel_scale = args.accel_range / 127.0
+    gyro_scale = args.gyro_range / 127.0
+    channel_scale = np.array([accel_scale] * 3 + [gyro_scale] * (args.channels - 3))
+    input_scale = np.tile(channel_scale, args.points)
+
+    # Same rounding as the firmware, then back to real units for calibration
+    activations = np.clip(np.round(data["X"] / input_scale), -128, 127) * input_scale
+    in_scale = input_scale
+
+    blob = bytearray()
+    blob += MAGIC + struct.pack("<BBBBB3x", VERSION, args.points, args.channels, len(layers), len(args.classes))
+    blob += struct.pack("<ff", accel_scale, gyro_scale)
+    for name in args.classes:
+        encoded = name.encode()
+        blob += struct.pack("<B", len(encoded)) + encoded
+
+    for index, (weights, bias) in enumerate(layers):
+        last = index == len(layers) - 1
+        # Fold the input scale (per channel on the first layer) into the weights
+        folded = weights * in_scale
+        weight_scale = scale_for(folded)
+        q_weights = np.clip(np.round(folded / weight_scale), -127, 127).astype(np.int8)
+        q_bias = np.round(bias / weight_scale).astype(np.int32)
+
+        outputs = activations @ weights.T + bias
+        if not last:
+            outputs = np.maximum(outputs, 0.0)
+        out_scale = scale_for(outputs)
+        multiplier = weight_scale / out_scale
+
+        blob += struct.pack("<HHffB3x", weights.shape[1], weights.shape[0], multiplier, out_scale, 0 if last else 1)
+        blob += q_bias.astype("<i4").tobytes()
+        blob += q_weights.tobytes()
+
+        activations = np.clip(np.round(outputs / out_scale), -128, 127) * out_scale
+        in_scale = out_scale
+
+    with open(args.output, "wb") as handle:
+        handle.write(blob)
+
+    arena = sum(4 * w.shape[0] + w.size for w, _ in layers) + 2 * max([width] + [w.shape[0] for w, _ in layers])
+    print("%s: %d bytes, %d layers, %d classes, arena >= %d bytes" %
+          (args.output, len(blob), len(layers), len(args.classes), arena))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""
+Summarize a gesture dataset recorded with GESTURE_RECORD_<label>.
+
+Download it from http://<device>/gesture_dataset.bin, then:
+    tools/gesture_dataset_report.py gesture_dataset.bin [--csv captures.csv]
+
+Prints the confusion matrix (label vs. what the device recognized), the
+recognition time per label and the capture buffer size. --csv also
+writes every capture as rows of samples in g and rad/s, for tuning the
+SimpleGestureConfig thresholds or training a model.
+"""
+
+import argparse
+import struct
+from collections import defaultdict
+
+HEADER = b"MPGD"
+CHANNELS = ("x", "y", "z", "gyroX", "gyroY", "gyroZ", "status")
+
+
+def read_string(data, offset):
+    length = data[offset]
+    return data[offset + 1:offset + 1 + length].decode(errors="replace"), offset + 1 + length
+
+
+def parse(path):
+    with open(path, "rb") as handle:
+        data = handle.read()
+    if data[:4] != HEADER or data[4] != 1:
+        raise SystemExit("%s: not a gesture dataset (version 1)" % path)
+
+    captures = []
+    offset = 8
+    while offset < len(data):
+        label, offset = read_string(data, offset)
+        recognized, offset = read_string(data, offset)
+        confidence, micros, hz, count, accel_scale, gyro_scale = struct.unpack_from("<fIHHff", data, offset)
+        offset += 20
+        channels = {}
+        for name in CHANNELS:
+            channels[name] = struct.unpack_from("<%dh" % count, data, offset)
+            offset += 2 * count
+        captures.append({
+            "label": label, "recognized": recognized or "none", "confidence": confidence,
+            "micros": micros, "hz": hz, "count": count,
+            "accel_scale": accel_scale, "gyro_scale": gyro_scale, "channels": channels,
+        })
+    return captures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("dataset")
+    parser.add_argument("--csv", help="write all samples to this CSV file")
+    args = parser.parse_args()
+
+    captures = parse(args.dataset)
+    if not captures:
+        raise SystemExit("no captures")
+
+    labels = sorted({c["label"] for c in captures})
+    predicted = sorted({c["recognized"] for c in captures})
+    matrix = defaultdict(int)
+    timing = defaultdict(list)
+    for capture in captures:
+        matrix[(capture["label"], capture["recognized"])] += 1
+        timing[capture["label"]].append(capture["micros"])
+
+    width = max(len(name) for name in labels + predicted + ["label"]) + 2
+    print("Confusion matrix (rows: label, columns: recognized)")
+    print("label".ljust(width) + "".join(name.rjust(width) for name in predicted))
+    correct = 0
+    for label in labels:
+        row = [matrix[(label, name)] for name in predicted]
+        correct += matrix[(label, label)]
+        print(label.ljust(width) + "".join(str(value).rjust(width) for value in row))
+    print("accuracy: %d/%d (%.1f%%)" % (correct, len(captures), 100.0 * correct / len(captures)))
+
+    print("\nRecognition time per label (us)")
+    for label in labels:
+        values = sorted(timing[label])
+        print("%s n=%d mean=%.0f p50=%d max=%d" % (label.ljust(width), len(values), sum(values) / len(values),
+                                                 values[len(values) // 2], values[-1]))
+
+    counts = [c["count"] for c in captures]
+    print("\nSamples per capture: min=%d max=%d, buffer %d bytes at 14 bytes/sample" %
+          (min(counts), max(counts), max(counts) * 14))
+
+    if args.csv:
+        with open(args.csv, "w") as out:
+            out.write("capture,label,recognized,hz,index,x,y,z,gyroX,gyroY,gyroZ,gyroValid\n")
+            for number, capture in enumerate(captures):
+                ch = capture["channels"]
+                for i in range(capture["count"]):
+                    out.write("%d,%s,%s,%d,%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%d\n" % (
+                        number, capture["label"], capture["recognized"], capture["hz"], i,
+                        ch["x"][i] * capture["accel_scale"], ch["y"][i] * capture["accel_scale"],
+                        ch["z"][i] * capture["accel_scale"], ch["gyroX"][i] * capture["gyro_scale"],
+                        ch["gyroY"][i] * capture["gyro_scale"], ch["gyroZ"][i] * capture["gyro_scale"],
+                        ch["status"][i] & 1))
+
+
+if __name__ == "__main__":
+    main()